@@ -0,0 +1,95 @@
+#include "animation.h"
+#include <SDL.h>
+
+AnimationClip MakeClip(int sprite, int frameCount, int frameWidth, int frameHeight,
+                       Uint32 frameDelay, bool loop, int eventFrame) {
+    AnimationClip clip;
+    clip.sprite = sprite;
+    clip.frameCount = frameCount > 0 ? frameCount : 1;
+    clip.frameWidth = frameWidth;
+    clip.frameHeight = frameHeight;
+    clip.frameDelay = frameDelay;
+    clip.loop = loop;
+    clip.stretchToBody = false;
+    clip.eventFrame = eventFrame;
+    for (int i = 0; i < clip.frameCount; ++i) {
+        SDL_Rect srcRect = {i * frameWidth, 0, frameWidth, frameHeight};
+        clip.frames.push_back(srcRect);
+    }
+    return clip;
+}
+
+AnimationClip MakeStretchedClip(int sprite) {
+    AnimationClip clip = MakeClip(sprite, 1, 0, 0, 0, true);
+    clip.stretchToBody = true;
+    return clip;
+}
+
+void AddFrameBox(AnimationClip& clip, int kind, int firstFrame, int lastFrame, const SDL_Rect& rect, int damage) {
+    FrameBox box;
+    box.kind = kind;
+    box.firstFrame = firstFrame;
+    box.lastFrame = lastFrame >= 0 ? lastFrame : clip.frameCount - 1;
+    box.rect = rect;
+    box.damage = damage;
+    clip.boxes.push_back(box);
+}
+
+SDL_Rect PlaceFrameBox(const SDL_Rect& box, const SDL_Rect& body, bool facingRight) {
+    int x = facingRight ? box.x : body.w - box.x - box.w;
+    SDL_Rect placed = {body.x + x, body.y + box.y, box.w, box.h};
+    return placed;
+}
+
+Animator::Animator() : clip(nullptr), frame(0), elapsed(0), finished(false) {}
+
+void Animator::Play(const AnimationClip* newClip, bool restart) {
+    if (newClip == clip && !restart) return;
+    clip = newClip;
+    frame = 0;
+    elapsed = 0;
+    finished = false;
+}
+
+int Animator::Update(Uint32 dt) {
+    if (!clip || finished || clip->frameDelay == 0) return ANIM_EVENT_NONE;
+
+    int events = ANIM_EVENT_NONE;
+    elapsed += dt;
+    while (elapsed > clip->frameDelay && !finished) {
+        elapsed -= clip->frameDelay;
+        if (frame + 1 < clip->frameCount) {
+            frame++;
+        } else if (clip->loop) {
+            frame = 0;
+        } else {
+            finished = true;
+            events |= ANIM_EVENT_FINISHED;
+        }
+        if (frame == clip->eventFrame && !finished) {
+            events |= ANIM_EVENT_ATTACK_FRAME;
+        }
+    }
+    return events;
+}
+
+void Animator::HashState(StateHash& hash) const {
+    hash.Add(clip ? clip->sprite : -1);
+    hash.Add(clip ? clip->frameCount : 0);
+    hash.Add(frame);
+    hash.Add(elapsed);
+    hash.Add(finished);
+}
+
+void Animator::Draw(RenderList& list, const SDL_Rect& body, SDL_RendererFlip flip, int layer) const {
+    if (!clip) return;
+
+    if (clip->stretchToBody) {
+        list.AddSprite(clip->sprite, nullptr, body, layer, flip);
+        return;
+    }
+
+    SDL_Rect destRect = {body.x + (body.w - clip->frameWidth) / 2, body.y + (body.h - clip->frameHeight),
+                         clip->frameWidth, clip->frameHeight};
+    list.AddSprite(clip->sprite, &clip->frames[frame], destRect, layer, flip);
+}
@@ -0,0 +1,79 @@
+#ifndef ANIMATION_H
+#define ANIMATION_H
+
+#include <SDL.h>
+#include <vector>
+#include "render_list.h"
+#include "state_hash.h"
+
+// Sự kiện phát ra khi hoạt ảnh được cập nhật (bitmask)
+enum AnimationEvent {
+    ANIM_EVENT_NONE = 0,
+    ANIM_EVENT_ATTACK_FRAME = 1 << 0, // Đạt tới khung gây sát thương của clip
+    ANIM_EVENT_FINISHED = 1 << 1      // Clip không lặp đã chạy hết
+};
+
+// Loại hộp va chạm khai báo trên khung hoạt ảnh
+enum FrameBoxKind {
+    BOX_HIT = 0, // Vùng gây sát thương của đòn đánh
+    BOX_HURT     // Vùng có thể bị đánh trúng
+};
+
+// Hộp va chạm áp dụng cho các khung [firstFrame, lastFrame] của clip.
+// Tọa độ tính từ góc trên trái của body khi quay mặt sang phải, tự lật khi quay trái.
+struct FrameBox {
+    int kind;
+    int firstFrame;
+    int lastFrame;
+    SDL_Rect rect;
+    int damage; // Chỉ dùng cho BOX_HIT
+};
+
+// Định nghĩa một clip hoạt ảnh trên spritesheet xếp ngang
+struct AnimationClip {
+    int sprite;                   // SpriteId của spritesheet
+    int frameCount;
+    int frameWidth;
+    int frameHeight;
+    Uint32 frameDelay;
+    bool loop;
+    bool stretchToBody;           // Vẽ toàn bộ texture phủ lên rect của đối tượng (ảnh idle)
+    int eventFrame;               // Khung phát ANIM_EVENT_ATTACK_FRAME, -1 nếu không có
+    std::vector<SDL_Rect> frames; // Bảng srcRect tính sẵn cho từng khung
+    std::vector<FrameBox> boxes;  // Hộp đánh/hộp nhận đòn; clip không có BOX_HURT dùng cả body làm hộp nhận đòn
+};
+
+AnimationClip MakeClip(int sprite, int frameCount, int frameWidth, int frameHeight,
+                       Uint32 frameDelay, bool loop, int eventFrame = -1);
+AnimationClip MakeStretchedClip(int sprite);
+// Khai báo hộp va chạm cho các khung firstFrame..lastFrame (lastFrame = -1: tới khung cuối)
+void AddFrameBox(AnimationClip& clip, int kind, int firstFrame, int lastFrame, const SDL_Rect& rect, int damage = 0);
+// Đặt hộp khai báo lên body trong thế giới, lật theo hướng mặt
+SDL_Rect PlaceFrameBox(const SDL_Rect& box, const SDL_Rect& body, bool facingRight);
+
+// Trạng thái phát của một clip; chỉ thay đổi trong pha cập nhật
+class Animator {
+private:
+    const AnimationClip* clip;
+    int frame;
+    Uint32 elapsed;
+    bool finished;
+
+public:
+    Animator();
+    // Chuyển sang clip khác; restart = true để phát lại từ đầu cả khi đang ở clip đó
+    void Play(const AnimationClip* newClip, bool restart = false);
+    // Tiến thời gian dt (ms), trả về bitmask AnimationEvent phát sinh trong bước này
+    int Update(Uint32 dt);
+
+    const AnimationClip* GetClip() const { return clip; }
+    int GetFrame() const { return frame; }
+    bool IsFinished() const { return finished; }
+    // Clip được nhận diện qua sprite và số khung thay vì địa chỉ
+    void HashState(StateHash& hash) const;
+
+    // Thêm khung hiện tại vào danh sách vẽ, căn giữa theo chiều ngang và đặt đáy trùng với đáy của body
+    void Draw(RenderList& list, const SDL_Rect& body, SDL_RendererFlip flip, int layer) const;
+};
+
+#endif
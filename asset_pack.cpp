@@ -0,0 +1,159 @@
+#include "asset_pack.h"
+#include "lz4.h"
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static char NormalizePathChar(char c) {
+    if (c == '\\') return '/';
+    if (c >= 'A' && c <= 'Z') return static_cast<char>(c - 'A' + 'a');
+    return c;
+}
+
+static bool SameAssetPath(const char* a, const char* b) {
+    while (*a && *b) {
+        if (NormalizePathChar(*a++) != NormalizePathChar(*b++)) return false;
+    }
+    return *a == *b;
+}
+
+Uint32 HashAssetPath(const char* path) {
+    Uint32 hash = 2166136261u;
+    for (const char* c = path; *c; ++c) {
+        hash ^= static_cast<Uint8>(NormalizePathChar(*c));
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+AssetPack::AssetPack() : data(nullptr), size(0), entries(nullptr), entryCount(0) {}
+
+AssetPack::~AssetPack() {
+    Close();
+}
+
+// Ánh xạ cả file chỉ đọc; handle của file được đóng ngay, vùng ánh xạ vẫn còn hiệu lực
+static const Uint8* MapFile(const char* path, std::size_t& size) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return nullptr;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        return nullptr;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) return nullptr;
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!view) return nullptr;
+    size = static_cast<std::size_t>(fileSize.QuadPart);
+    return static_cast<const Uint8*>(view);
+#else
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return nullptr;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return nullptr;
+    }
+    void* view = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED) return nullptr;
+    size = static_cast<std::size_t>(info.st_size);
+    // Dữ liệu được đọc tuần tự một lần: xin đọc trước cả file để khởi động chỉ tốn một lượt I/O
+    madvise(view, size, MADV_SEQUENTIAL);
+    madvise(view, size, MADV_WILLNEED);
+    return static_cast<const Uint8*>(view);
+#endif
+}
+
+static void UnmapFile(const Uint8* data, std::size_t size) {
+#ifdef _WIN32
+    (void)size;
+    UnmapViewOfFile(data);
+#else
+    munmap(const_cast<Uint8*>(data), size);
+#endif
+}
+
+bool AssetPack::Open(const char* path) {
+    Close();
+
+    std::size_t mappedSize = 0;
+    const Uint8* mapped = MapFile(path, mappedSize);
+    if (!mapped) {
+        std::cout << "Asset pack " << path << " not available, using loose files\n";
+        return false;
+    }
+
+    const AssetPackHeader* header = reinterpret_cast<const AssetPackHeader*>(mapped);
+    bool valid = mappedSize >= sizeof(AssetPackHeader) &&
+                 std::memcmp(header->magic, "MGPK", 4) == 0 &&
+                 header->version == ASSET_PACK_VERSION &&
+                 header->entryCount <= (mappedSize - sizeof(AssetPackHeader)) / sizeof(AssetPackEntry);
+    if (!valid) {
+        std::cout << "Asset pack error: " << path << " is not a version " << ASSET_PACK_VERSION << " pack\n";
+        UnmapFile(mapped, mappedSize);
+        return false;
+    }
+
+    data = mapped;
+    size = mappedSize;
+    entries = reinterpret_cast<const AssetPackEntry*>(mapped + sizeof(AssetPackHeader));
+    entryCount = static_cast<int>(header->entryCount);
+    std::cout << "Opened asset pack " << path << ": " << entryCount << " images, " << size << " bytes\n";
+    return true;
+}
+
+void AssetPack::Close() {
+    if (data) UnmapFile(data, size);
+    data = nullptr;
+    size = 0;
+    entries = nullptr;
+    entryCount = 0;
+}
+
+const AssetPackEntry* AssetPack::Find(const char* path) const {
+    if (!data) return nullptr;
+
+    // Tìm nhị phân theo hash rồi so đường dẫn để loại va chạm hash
+    Uint32 hash = HashAssetPath(path);
+    int low = 0;
+    int high = entryCount;
+    while (low < high) {
+        int middle = (low + high) / 2;
+        if (entries[middle].pathHash < hash) low = middle + 1;
+        else high = middle;
+    }
+    for (int i = low; i < entryCount && entries[i].pathHash == hash; ++i) {
+        if (SameAssetPath(entries[i].path, path)) return &entries[i];
+    }
+    return nullptr;
+}
+
+bool AssetPack::ReadPixels(const AssetPackEntry& entry, std::vector<Uint8>& pixels) const {
+    if (!data || entry.offset > size || entry.compressedSize > size - entry.offset ||
+        entry.rawSize != entry.width * entry.height * 4) {
+        std::cout << "Asset pack error: bad entry " << entry.path << "\n";
+        return false;
+    }
+    pixels.resize(entry.rawSize);
+    int written = Lz4Decompress(data + entry.offset, static_cast<int>(entry.compressedSize),
+                                pixels.data(), static_cast<int>(entry.rawSize));
+    if (written != static_cast<int>(entry.rawSize)) {
+        std::cout << "Asset pack error: corrupt data for " << entry.path << "\n";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,64 @@
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include <SDL.h>
+#include <cstddef>
+#include <vector>
+
+// Gói asset do công cụ pack_assets tạo từ các ảnh của bảng sprite
+const char* const ASSET_PACK_PATH = "assets/assets.pak";
+const Uint32 ASSET_PACK_VERSION = 1;
+const int ASSET_PACK_MAX_PATH = 64;
+
+// Bố cục file (little-endian): AssetPackHeader, mảng AssetPackEntry sắp theo pathHash,
+// rồi dữ liệu điểm ảnh nén LZ4 của từng ảnh nối tiếp nhau theo thứ tự sprite.
+// Điểm ảnh đã giải mã sẵn ở định dạng format, các hàng liền nhau (pitch = width * 4),
+// nên chỉ cần giải nén rồi đưa thẳng lên texture.
+struct AssetPackHeader {
+    char magic[4];      // "MGPK"
+    Uint32 version;
+    Uint32 entryCount;
+    Uint32 reserved;
+};
+
+struct AssetPackEntry {
+    char path[ASSET_PACK_MAX_PATH]; // Đường dẫn gốc trong bảng sprite
+    Uint32 pathHash;                // HashAssetPath(path)
+    Uint32 format;                  // SDL_PixelFormatEnum
+    Uint32 width;
+    Uint32 height;
+    Uint32 compressedSize;
+    Uint32 rawSize;
+    Uint64 offset;                  // Vị trí dữ liệu nén tính từ đầu file
+};
+
+// FNV-1a trên đường dẫn đã đổi dấu gạch ngược thành '/' và hạ về chữ thường,
+// nên tra cứu không phụ thuộc hoa thường hay dấu phân cách của hệ điều hành
+Uint32 HashAssetPath(const char* path);
+
+// Gói asset được ánh xạ vào bộ nhớ; chỉ đọc nên dùng được từ bất kỳ luồng nào sau Open()
+class AssetPack {
+private:
+    const Uint8* data;
+    std::size_t size;
+    const AssetPackEntry* entries;
+    int entryCount;
+
+public:
+    AssetPack();
+    ~AssetPack();
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    // Ánh xạ file và kiểm tra header; báo cho hệ điều hành đọc trước toàn bộ file một lượt
+    bool Open(const char* path);
+    void Close();
+    bool IsOpen() const { return data != nullptr; }
+
+    // Tìm ảnh theo đường dẫn (không phân biệt hoa thường), nullptr nếu không có
+    const AssetPackEntry* Find(const char* path) const;
+    // Giải nén điểm ảnh của entry vào pixels (đặt lại kích thước thành rawSize)
+    bool ReadPixels(const AssetPackEntry& entry, std::vector<Uint8>& pixels) const;
+};
+
+#endif
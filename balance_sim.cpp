@@ -0,0 +1,438 @@
+// Bộ mô phỏng cân bằng boss: chạy hàng loạt trận Player vs Boss không đồ họa trên mọi lõi,
+// quét lưới thông số BossTuning và ghi thống kê (tỉ lệ thắng, thời gian hạ boss, phân bố sát thương).
+// Trả về 2 nếu lưới có nhiều điểm mà mọi điểm cho ra các trận giống hệt nhau (thông số quét không có tác dụng).
+//
+// Ví dụ:
+//   balance_sim --level 1 --fights 2000 --param attack_cooldown=1000,1500,2000 --param dash_chance=20,30,40
+#include <SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "boss.h"
+#include "boss_tuning.h"
+#include "combat.h"
+#include "encounter.h"
+#include "job_system.h"
+#include "level.h"
+#include "physics.h"
+#include "player.h"
+#include "sprites.h"
+
+// Khoảng cách tâm tới tâm mà người chơi giả lập đứng lại để đánh
+const int POLICY_ATTACK_REACH = 90;
+// Nhịp đánh của người chơi giả lập: chờ ít nhất chừng này ms giữa hai cú chém, cộng thêm độ lệch ngẫu nhiên
+const Uint32 POLICY_ATTACK_INTERVAL_MS = 1000;
+const Uint32 POLICY_ATTACK_JITTER_MS = 600;
+// Thời gian phản xạ trước khi nhảy né một đòn lướt hoặc bổ nhào đã thấy, cộng thêm độ lệch ngẫu nhiên
+const Uint32 POLICY_REACTION_MS = 180;
+const Uint32 POLICY_REACTION_JITTER_MS = 200;
+// Sau khi trúng đòn, người chơi giả lập lùi xa boss chừng này ms (cộng độ lệch) rồi mới áp sát lại
+const Uint32 POLICY_RECOVER_MS = 1000;
+const Uint32 POLICY_RECOVER_JITTER_MS = 1000;
+// Số ô của phân bố sát thương player nhận (0..MAX_DAMAGE_BUCKETS-1, ô cuối gộp phần còn lại)
+const int MAX_DAMAGE_BUCKETS = 8;
+
+enum FightOutcome {
+    FIGHT_WIN,     // Mọi boss và wave bị hạ
+    FIGHT_LOSS,    // Player chết
+    FIGHT_TIMEOUT  // Hết số tick cho phép
+};
+
+struct FightResult {
+    int outcome;
+    int ticks;
+    int damageTaken;
+};
+
+struct SimOptions {
+    int level;
+    int fights;
+    int maxTicks;
+    int threads;
+    int dodgeChance; // % khả năng người chơi giả lập nhảy né khi boss lướt hoặc bổ nhào tới gần
+    Uint32 seed;
+    std::string outputPath;
+    std::string tuningPath; // File thông số gốc, rỗng thì dùng thông số mặc định
+};
+
+// Một trục của lưới tham số
+struct GridAxis {
+    const BossTuningField* field;
+    std::vector<int> values;
+};
+
+// Trạng thái của người chơi giả lập giữa các tick; mọi độ lệch lấy từ rng gieo theo seed của trận
+struct PolicyState {
+    Uint32 rng;
+    Uint32 nextAttackTime; // Thời điểm sớm nhất được chém tiếp
+    bool threatSeen;       // Đã thấy đòn lướt/bổ nhào hiện tại
+    bool willDodge;        // Quyết định né đòn đó, gieo một lần khi thấy
+    Uint32 dodgeTime;      // Thời điểm nhảy né sau thời gian phản xạ
+    int lastHealth;        // Máu ở tick trước, để nhận ra vừa trúng đòn
+    Uint32 recoverUntil;   // Đang lùi lại tới thời điểm này
+};
+
+static Uint32 NextPolicyRandom(Uint32& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// Trộn chỉ số trận vào seed để mỗi trận có chuỗi số riêng và kết quả lặp lại được
+static Uint32 MixSeed(Uint32 seed, Uint32 a, Uint32 b) {
+    Uint32 h = seed ^ (a * 0x9E3779B1u) ^ (b * 0x85EBCA77u);
+    h ^= h >> 16;
+    h *= 0x7FEB352Du;
+    h ^= h >> 15;
+    return h ? h : 1;
+}
+
+// Kẻ địch còn sống gần player nhất theo chiều ngang, nullptr nếu không còn ai
+static const Boss* FindNearestEnemy(const Player& player, const EnemyList& enemies) {
+    const SDL_Rect& playerRect = player.GetRect();
+    const Boss* nearest = nullptr;
+    int nearestDistance = 0;
+    for (const Boss* enemy : enemies) {
+        if (enemy->IsDead()) continue;
+        const SDL_Rect& rect = enemy->GetRect();
+        int distance = std::abs((rect.x + rect.w / 2) - (playerRect.x + playerRect.w / 2));
+        if (!nearest || distance < nearestDistance) {
+            nearest = enemy;
+            nearestDistance = distance;
+        }
+    }
+    return nearest;
+}
+
+// Người chơi giả lập: đi tới boss, đứng trong tầm thì đánh theo nhịp có độ lệch, nhảy né đòn lướt
+// hoặc bổ nhào tới gần sau một thời gian phản xạ, trúng đòn thì lùi ra một lúc. Nhịp đánh chừa khoảng
+// cho boss hồi khỏi trạng thái bị đánh và ra đòn, còn lúc lùi ra đưa player vào tầm trung của boss,
+// nên thông số của boss thực sự đổi được kết quả trận.
+static void DrivePlayer(Player& player, const Boss& boss, int dodgeChance, Uint32 now, PolicyState& policy) {
+    const SDL_Rect& playerRect = player.GetRect();
+    const SDL_Rect& bossRect = boss.GetRect();
+    int dx = (bossRect.x + bossRect.w / 2) - (playerRect.x + playerRect.w / 2);
+    int distance = std::abs(dx);
+
+    if (player.GetHealth() < policy.lastHealth) {
+        policy.recoverUntil = now + POLICY_RECOVER_MS + NextPolicyRandom(policy.rng) % POLICY_RECOVER_JITTER_MS;
+    }
+    policy.lastHealth = player.GetHealth();
+
+    player.Face(dx > 0);
+    if (now < policy.recoverUntil) {
+        player.SetMoveInput(dx > 0, dx < 0);
+    } else if (distance > POLICY_ATTACK_REACH) {
+        player.SetMoveInput(dx < 0, dx > 0);
+    } else {
+        player.SetMoveInput(false, false);
+        if (now >= policy.nextAttackTime && player.Attack()) {
+            policy.nextAttackTime = now + POLICY_ATTACK_INTERVAL_MS + NextPolicyRandom(policy.rng) % POLICY_ATTACK_JITTER_MS;
+        }
+    }
+
+    bool threat = (boss.IsDashing() || boss.IsDiving()) && distance < 300;
+    if (!threat) {
+        policy.threatSeen = false;
+        return;
+    }
+    if (!policy.threatSeen) {
+        policy.threatSeen = true;
+        policy.willDodge = static_cast<int>(NextPolicyRandom(policy.rng) % 100) < dodgeChance;
+        policy.dodgeTime = now + POLICY_REACTION_MS + NextPolicyRandom(policy.rng) % POLICY_REACTION_JITTER_MS;
+    }
+    if (policy.willDodge && now >= policy.dodgeTime && player.IsOnGround()) {
+        player.Jump();
+        policy.willDodge = false;
+    }
+}
+
+static FightResult RunFight(const SimOptions& options, const Level& level, const BossTuning& tuning, Uint32 seed) {
+    PhysicsWorld world;
+    world.SetLevel(&level);
+    Player player(world, level.playerSpawn.x, level.playerSpawn.y, SPRITE_PLAYER_IDLE, SPRITE_PLAYER_RUN, SPRITE_PLAYER_ATTACK,
+                  SPRITE_PLAYER_JUMP, SPRITE_PLAYER_DAMAGE, SPRITE_PLAYER_DEATH);
+    Encounter encounter(world);
+    encounter.Start(level, tuning, nullptr, seed);
+    const EnemyList& enemies = encounter.GetEnemies();
+    PolicyState policy = {MixSeed(seed, 0x5eed, 0), 0, false, false, 0, player.GetHealth(), 0};
+
+    int startHealth = player.GetHealth();
+    HitWorld hits;
+    FightResult result = {FIGHT_TIMEOUT, options.maxTicks, 0};
+
+    // Cùng nhịp và thứ tự pha với LevelScene::Simulate
+    for (int tick = 0; tick < options.maxTicks; ++tick) {
+        world.AdvanceTime(FIXED_TICK_MS);
+        world.BeginStep();
+        if (const Boss* target = FindNearestEnemy(player, enemies)) {
+            DrivePlayer(player, *target, options.dodgeChance, world.GetTime(), policy);
+        } else {
+            player.SetMoveInput(false, false); // Chờ wave kế tiếp
+        }
+        player.Update();
+
+        for (Boss* enemy : enemies) {
+            enemy->Update(player.GetRect(), options.level, player);
+        }
+        world.Step();
+        player.ResolveContacts();
+        for (Boss* enemy : enemies) {
+            enemy->ResolveContacts();
+        }
+        ResolveCombat(player, encounter, hits);
+        encounter.Update(FIXED_TICK_MS, options.level);
+
+        for (Boss* enemy : enemies) {
+            enemy->Animate(FIXED_TICK_MS);
+        }
+        player.Animate(FIXED_TICK_MS);
+
+        if (encounter.IsCleared() || player.IsDead()) {
+            result.outcome = encounter.IsCleared() ? FIGHT_WIN : FIGHT_LOSS;
+            result.ticks = tick + 1;
+            break;
+        }
+    }
+
+    result.damageTaken = startHealth - player.GetHealth();
+    return result;
+}
+
+static bool ParseIntList(const char* text, std::vector<int>& values) {
+    std::string list(text);
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t comma = list.find(',', start);
+        std::string item = list.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+        char* end = nullptr;
+        long value = std::strtol(item.c_str(), &end, 10);
+        if (item.empty() || *end != '\0') return false;
+        values.push_back(static_cast<int>(value));
+        if (comma == std::string::npos) break;
+        start = comma + 1;
+    }
+    return !values.empty();
+}
+
+static void PrintUsage() {
+    std::cout << "Usage: balance_sim [--level 1|2] [--fights N] [--max-ticks N] [--threads N]\n"
+                 "                   [--dodge-chance 0..100] [--seed N] [--out results.csv]\n"
+                 "                   [--tuning file] [--param name=v1,v2,...]...\n"
+                 "Tunable parameters:";
+    int count;
+    const BossTuningField* fields = GetBossTuningFields(count);
+    for (int i = 0; i < count; ++i) {
+        std::cout << (i % 4 == 0 ? "\n  " : " ") << fields[i].name;
+    }
+    std::cout << "\n";
+}
+
+static bool ParseArgs(int argc, char* argv[], SimOptions& options, std::vector<GridAxis>& grid) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") return false;
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        const char* value = argv[++i];
+        if (arg == "--level") options.level = std::atoi(value);
+        else if (arg == "--fights") options.fights = std::atoi(value);
+        else if (arg == "--max-ticks") options.maxTicks = std::atoi(value);
+        else if (arg == "--threads") options.threads = std::atoi(value);
+        else if (arg == "--dodge-chance") options.dodgeChance = std::atoi(value);
+        else if (arg == "--seed") options.seed = static_cast<Uint32>(std::strtoul(value, nullptr, 10));
+        else if (arg == "--out") options.outputPath = value;
+        else if (arg == "--tuning") options.tuningPath = value;
+        else if (arg == "--param") {
+            const char* equals = std::strchr(value, '=');
+            if (!equals) {
+                std::cerr << "Expected name=v1,v2,... for --param, got " << value << "\n";
+                return false;
+            }
+            std::string name(value, equals - value);
+            GridAxis axis;
+            axis.field = FindBossTuningField(name.c_str());
+            if (!axis.field) {
+                std::cerr << "Unknown tuning parameter: " << name << "\n";
+                return false;
+            }
+            if (!ParseIntList(equals + 1, axis.values)) {
+                std::cerr << "Invalid value list for " << name << ": " << (equals + 1) << "\n";
+                return false;
+            }
+            grid.push_back(axis);
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return false;
+        }
+    }
+    if (options.level != 1 && options.level != 2) {
+        std::cerr << "--level must be 1 or 2\n";
+        return false;
+    }
+    if (options.fights < 1 || options.maxTicks < 1) {
+        std::cerr << "--fights and --max-ticks must be positive\n";
+        return false;
+    }
+    return true;
+}
+
+// Giá trị tại phân vị p (0..1) của mảng đã sắp xếp
+static double Percentile(const std::vector<int>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+    return sorted[index];
+}
+
+int main(int argc, char* argv[]) {
+    SimOptions options;
+    options.level = 1;
+    options.fights = 1000;
+    options.maxTicks = 60 * 60 * 5; // 5 phút thời gian game
+    options.threads = static_cast<int>(std::thread::hardware_concurrency());
+    options.dodgeChance = 50;
+    options.seed = 12345;
+    options.outputPath = "balance_results.csv";
+
+    std::vector<GridAxis> grid;
+    if (!ParseArgs(argc, argv, options, grid)) {
+        PrintUsage();
+        return 1;
+    }
+
+    BossTuning baseTuning = MakeDefaultBossTuning();
+    if (!options.tuningPath.empty() && !LoadBossTuning(options.tuningPath, baseTuning)) {
+        return 1;
+    }
+
+    // Màn chơi chỉ đọc, dùng chung cho mọi trận
+    Level level;
+    if (!LoadLevel(GetLevelPath(options.level), level)) {
+        return 1;
+    }
+
+    std::ofstream out(options.outputPath.c_str());
+    if (!out) {
+        std::cerr << "Cannot open output file: " << options.outputPath << "\n";
+        return 1;
+    }
+    for (const GridAxis& axis : grid) {
+        out << axis.field->name << ",";
+    }
+    out << "fights,win_rate,loss_rate,timeout_rate,mean_ttk_s,p50_ttk_s,p90_ttk_s,mean_damage";
+    for (int i = 0; i < MAX_DAMAGE_BUCKETS; ++i) {
+        out << ",damage_" << i << (i == MAX_DAMAGE_BUCKETS - 1 ? "_plus" : "");
+    }
+    out << "\n";
+
+    int pointCount = 1;
+    for (const GridAxis& axis : grid) {
+        pointCount *= static_cast<int>(axis.values.size());
+    }
+
+    // Luồng main cũng chạy job khi Wait nên số worker là threads - 1
+    JobSystem jobs(std::max(options.threads - 1, 0));
+    int grain = std::max(1, options.fights / (jobs.GetThreadCount() * 4));
+    std::vector<FightResult> results(options.fights);
+    std::vector<FightResult> firstResults; // Kết quả điểm lưới đầu, để kiểm tra việc quét có tác dụng
+    bool sweepChanged = false;
+    long long totalTicks = 0;
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    for (int point = 0; point < pointCount; ++point) {
+        // Giải mã chỉ số điểm lưới thành giá trị của từng trục
+        BossTuning tuning = baseTuning;
+        std::vector<int> pointValues;
+        int rest = point;
+        for (const GridAxis& axis : grid) {
+            int value = axis.values[rest % axis.values.size()];
+            rest /= static_cast<int>(axis.values.size());
+            tuning.*(axis.field->value) = value;
+            pointValues.push_back(value);
+        }
+
+        // Trận thứ i dùng cùng seed ở mọi điểm lưới, nên khác biệt giữa các hàng chỉ đến từ thông số
+        JobHandle batch = jobs.ParallelFor(options.fights, grain, [&](int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                results[i] = RunFight(options, level, tuning, MixSeed(options.seed, static_cast<Uint32>(i), 0));
+            }
+        });
+        jobs.Wait(batch);
+        jobs.Reset();
+
+        if (point == 0) {
+            firstResults = results;
+        } else {
+            for (int i = 0; i < options.fights && !sweepChanged; ++i) {
+                sweepChanged = results[i].outcome != firstResults[i].outcome || results[i].ticks != firstResults[i].ticks ||
+                               results[i].damageTaken != firstResults[i].damageTaken;
+            }
+        }
+
+        // Tổng hợp thống kê
+        int wins = 0, losses = 0, timeouts = 0;
+        long long damageSum = 0;
+        int damageBuckets[MAX_DAMAGE_BUCKETS] = {0};
+        std::vector<int> killTicks;
+        for (const FightResult& result : results) {
+            totalTicks += result.ticks;
+            if (result.outcome == FIGHT_WIN) {
+                wins++;
+                killTicks.push_back(result.ticks);
+            } else if (result.outcome == FIGHT_LOSS) {
+                losses++;
+            } else {
+                timeouts++;
+            }
+            damageSum += result.damageTaken;
+            damageBuckets[std::min(std::max(result.damageTaken, 0), MAX_DAMAGE_BUCKETS - 1)]++;
+        }
+        std::sort(killTicks.begin(), killTicks.end());
+        double meanKill = 0.0;
+        for (int ticks : killTicks) meanKill += ticks;
+        if (!killTicks.empty()) meanKill /= killTicks.size();
+
+        double fights = options.fights;
+        double tickSeconds = FIXED_TICK_MS / 1000.0;
+        for (int value : pointValues) {
+            out << value << ",";
+        }
+        out << options.fights << "," << wins / fights << "," << losses / fights << "," << timeouts / fights << ","
+            << meanKill * tickSeconds << "," << Percentile(killTicks, 0.5) * tickSeconds << ","
+            << Percentile(killTicks, 0.9) * tickSeconds << "," << damageSum / fights;
+        for (int i = 0; i < MAX_DAMAGE_BUCKETS; ++i) {
+            out << "," << damageBuckets[i] / fights;
+        }
+        out << "\n";
+
+        std::cout << "[" << (point + 1) << "/" << pointCount << "]";
+        for (size_t i = 0; i < grid.size(); ++i) {
+            std::cout << " " << grid[i].field->name << "=" << pointValues[i];
+        }
+        std::cout << " win=" << wins / fights << " loss=" << losses / fights
+                  << " ttk=" << meanKill * tickSeconds << "s damage=" << damageSum / fights << "\n";
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "Simulated " << totalTicks << " ticks in " << seconds << "s ("
+              << (seconds > 0 ? totalTicks / seconds : 0) << " ticks/s on " << jobs.GetThreadCount() << " threads)\n";
+    std::cout << "Results written to " << options.outputPath << "\n";
+
+    // Mọi trận giống hệt nhau ở mọi điểm lưới nghĩa là thông số được quét không chạm tới trận đấu
+    // và bảng kết quả không đo được gì
+    if (pointCount > 1 && !sweepChanged) {
+        std::cerr << "Sweep check failed: every grid point produced identical fights\n";
+        return 2;
+    }
+    return 0;
+}
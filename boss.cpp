@@ -1,871 +1,701 @@
 #include "boss.h"
 #include "player.h"
+#include "physics.h"
+#include "sprites.h"
 #include <SDL.h>
 #include <iostream>
 #include <cmath>
-
-// Constants
-const int SCREEN_WIDTH = 1200;
-const int BOSS_SPEED = 3;
-const int DASH_SPEED = 8;
-const int DIVE_SPEED_VERTICAL = 8;
-const int DIVE_SPEED_HORIZONTAL = 14;
-const int GRAVITY = 1;
-const int JUMP_STRENGTH = -20;
-const Uint32 FRAME_DELAY = 500;
-const Uint32 DASH_DURATION = 1000;
-const Uint32 DIVE_DURATION = 2500;
-const int MIN_DISTANCE = 400; // Khoảng cách tối thiểu
-const int MAX_DISTANCE = 1000; // Khoảng cách tối đa
-const Uint32 ATTACK_COOLDOWN = 1000;
-const Uint32 SHOOT_COOLDOWN = 1500;
-const int RETREAT_DISTANCE = 200;
-const int IDLE_DISTANCE = 600;
-
-// Global MiniBoss textures (khai báo extern để truy cập từ main.cpp)
-extern SDL_Texture* miniBossIdle;
-extern SDL_Texture* miniBossRunSheet;
-extern SDL_Texture* miniBossAttackSheet;
-extern SDL_Texture* miniBossJumpSheet;
-extern SDL_Texture* miniBossDamageSheet;
-extern SDL_Texture* miniBossDeathSheet;
-extern SDL_Texture* miniBossDiveSheet;
-extern SDL_Texture* miniBossShootSheet;
-extern SDL_Texture* miniBossArrowTexture;
-
-Boss::Boss(int x, int y,
-           SDL_Texture* run, int runCount, int runWidth, int runHeight,
-           SDL_Texture* attack, int attackCount, int attackWidth, int attackHeight,
-           SDL_Texture* jump, int jumpCount, int jumpWidth, int jumpHeight,
-           SDL_Texture* damage, int damageCount, int damageWidth, int damageHeight,
-           SDL_Texture* death, int deathCount, int deathWidth, int deathHeight,
-           SDL_Texture* dive, int diveCount, int diveWidth, int diveHeight)
-    : rect{x, y, 120, 120}, health(1000), maxHealth(1000), verticalVelocity(0), horizontalDiveVelocity(0),
-      isJumping(false), isOnGround(false), facingRight(false),
+#include <cstdlib>
+
+// Log chi tiết của AI, bật bằng -DBOSS_DEBUG_LOG. Update chạy song song trên nhiều luồng
+// nên ghi std::cout mỗi tick vừa tranh khóa vừa làm log xen kẽ khó đọc.
+#ifdef BOSS_DEBUG_LOG
+#define BOSS_LOG(message) (std::cout << message)
+#else
+#define BOSS_LOG(message) ((void)0)
+#endif
+
+// Constants (thông số cân bằng nằm trong BossTuning)
+const Uint32 BOSS_FRAME_DELAY = 500;
+const int BOSS_HIT_DAMAGE = 1; // Máu player mất mỗi đòn trúng
+const Uint32 DEFAULT_RANDOM_SEED = 2463534242u;
+
+Boss::Boss(PhysicsWorld& world, int x, int y, int idle,
+           int run, int runCount, int runWidth, int runHeight,
+           int attack, int attackCount, int attackWidth, int attackHeight,
+           int jump, int jumpCount, int jumpWidth, int jumpHeight,
+           int damage, int damageCount, int damageWidth, int damageHeight,
+           int death, int deathCount, int deathWidth, int deathHeight,
+           int dive, int diveCount, int diveWidth, int diveHeight)
+    : world(world), bodyId(world.CreateBody({x, y, 120, 120})), rect(world.GetBody(bodyId).rect),
+      verticalVelocity(world.GetBody(bodyId).verticalVelocity), isOnGround(world.GetBody(bodyId).isOnGround),
+      health(1000), maxHealth(1000), horizontalDiveVelocity(0),
+      isJumping(false), facingRight(false),
       isAttacking(false), isDashing(false), isDiving(false), isTakingDamage(false), isDead(false),
-      isIdle(false), isRetreating(false), hasDealtDamage(false), currentRunFrame(0), currentAttackFrame(0),
-      currentJumpFrame(0), currentDamageFrame(0), currentDeathFrame(0), retreatStartX(0),
-      lastFrameTime(0), dashStartTime(0), diveStartTime(0), lastAttackTime(0),
-      runSheet(run), runFrameCount(runCount), runFrameWidth(runWidth), runFrameHeight(runHeight),
-      attackSheet(attack), attackFrameCount(attackCount), attackFrameWidth(attackWidth), attackFrameHeight(attackHeight),
-      jumpSheet(jump), jumpFrameCount(jumpCount), jumpFrameWidth(jumpWidth), jumpFrameHeight(jumpHeight),
-      damageSheet(damage), damageFrameCount(damageCount), damageFrameWidth(damageWidth), damageFrameHeight(damageHeight),
-      deathSheet(death), deathFrameCount(deathCount), deathFrameWidth(deathWidth), deathFrameHeight(deathHeight),
-      diveSheet(dive), diveFrameCount(diveCount), diveFrameWidth(diveWidth), diveFrameHeight(diveHeight),
-      hasSummonedMiniBoss(false) {}
+      isIdle(false), isRetreating(false), retreatStartX(0),
+      dashStartTime(0), diveStartTime(0), lastAttackTime(0), playerDistance(0), nextDecisionTime(0),
+      idleClip(MakeClip(idle, 1, runWidth, runHeight, BOSS_FRAME_DELAY, true)),
+      runClip(MakeClip(run, runCount, runWidth, runHeight, BOSS_FRAME_DELAY, true)),
+      attackClip(MakeClip(attack, attackCount, attackWidth, attackHeight, BOSS_FRAME_DELAY, false, attackCount / 2)),
+      jumpClip(MakeClip(jump, jumpCount, jumpWidth, jumpHeight, BOSS_FRAME_DELAY, true)),
+      damageClip(MakeClip(damage, damageCount, damageWidth, damageHeight, BOSS_FRAME_DELAY, false)),
+      deathClip(MakeClip(death, deathCount, deathWidth, deathHeight, BOSS_FRAME_DELAY, false)),
+      diveClip(MakeClip(dive, diveCount, diveWidth, diveHeight, BOSS_FRAME_DELAY, false)),
+      canSummon(false), hasSummonedMiniBoss(false), isSummoned(false), tuning(MakeDefaultBossTuning()), rngState(DEFAULT_RANDOM_SEED), attackSerial(0), events(nullptr) {
+    // Cú lướt dùng clip tấn công, hộp đánh nhô ra trước mặt; cú bổ nhào đánh vùng thấp phía trước
+    AddFrameBox(attackClip, BOX_HIT, 0, -1, {60, 0, 80, 100}, BOSS_HIT_DAMAGE);
+    AddFrameBox(diveClip, BOX_HIT, 0, -1, {70, 20, 60, 60}, BOSS_HIT_DAMAGE);
+    animator.Play(&runClip);
+    ScheduleDecisions();
+}
 
 Boss::~Boss() {
-    for (Boss* miniBoss : miniBosses) {
-        delete miniBoss;
-    }
+    world.DestroyBody(bodyId);
+}
+
+Boss* CreateEnemy(PhysicsWorld& world, int kind, int x, int y) {
+    // Hàm tạo gắn tham chiếu vào thân vật lý ngay, nên phải chắc còn chỗ trước khi tạo
+    if (!world.HasFreeBody()) {
+        std::cout << "CreateEnemy error: no free physics body for enemy kind " << kind << "\n";
+        return nullptr;
+    }
+    if (kind == ENEMY_MINIBOSS) {
+        return new MiniBoss(world, x, y, SPRITE_MINIBOSS_IDLE,
+                            SPRITE_MINIBOSS_RUN, 8, 128, 128,
+                            SPRITE_MINIBOSS_ATTACK, 6, 128, 128,
+                            SPRITE_MINIBOSS_JUMP, 9, 128, 128,
+                            SPRITE_MINIBOSS_DAMAGE, 3, 128, 128,
+                            SPRITE_MINIBOSS_DEATH, 5, 128, 128,
+                            SPRITE_MINIBOSS_DIVE, 5, 128, 128,
+                            SPRITE_MINIBOSS_SHOOT, 4, 128, 128,
+                            SPRITE_MINIBOSS_ARROW, 64, 64);
+    }
+    if (kind == ENEMY_BOSS1) {
+        return new Boss(world, x, y, SPRITE_BOSS1_IDLE,
+                        SPRITE_BOSS1_RUN, 8, 128, 128,
+                        SPRITE_BOSS1_ATTACK, 5, 128, 128,
+                        SPRITE_BOSS1_JUMP, 9, 128, 128,
+                        SPRITE_BOSS1_DAMAGE, 3, 128, 128,
+                        SPRITE_BOSS1_DEATH, 5, 128, 128,
+                        SPRITE_BOSS1_DIVE, 5, 128, 128);
+    }
+    Boss* boss = new Boss(world, x, y, SPRITE_BOSS2_IDLE,
+                          SPRITE_BOSS2_RUN, 8, 128, 128,
+                          SPRITE_BOSS2_ATTACK, 4, 128, 128,
+                          SPRITE_BOSS2_JUMP, 7, 128, 128,
+                          SPRITE_BOSS2_DAMAGE, 2, 128, 128,
+                          SPRITE_BOSS2_DEATH, 6, 128, 128,
+                          SPRITE_NONE, 0, 0, 0);
+    boss->SetCanSummon(true);
+    return boss;
 }
 
-void Boss::RenderHealthBar(SDL_Renderer* renderer) {
+void Boss::RenderHealthBar(RenderList& list) const {
     if (isDead) return;
 
     // Vẽ khung ngoài (màu xám)
     SDL_Rect outerRect = {rect.x + (rect.w - 100) / 2, rect.y - 20, 100, 10};
-    SDL_SetRenderDrawColor(renderer, 150, 150, 150, 255);
-    SDL_RenderFillRect(renderer, &outerRect);
+    list.AddFillRect(outerRect, {150, 150, 150, 255}, LAYER_UI);
 
-    // Vẽ thanh máu (màu đỏ, tỷ lệ với health/maxHealth)
-    float healthRatio = static_cast<float>(health) / maxHealth;
-    int healthWidth = static_cast<int>(100 * healthRatio);
+    // Vẽ thanh máu (màu đỏ, tỷ lệ với health/maxHealth), tính bằng số nguyên
+    int healthWidth = 100 * health / maxHealth;
     SDL_Rect healthRect = {rect.x + (rect.w - 100) / 2, rect.y - 20, healthWidth, 10};
-    SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-    SDL_RenderFillRect(renderer, &healthRect);
+    list.AddFillRect(healthRect, {255, 0, 0, 255}, LAYER_UI);
 }
 
-void Boss::Update(const SDL_Rect& playerRect, SDL_Rect* platforms, int platformCount, int currentLevel, Player& player) {
+void Boss::Update(const SDL_Rect& playerRect, int currentLevel, const Player& player) {
     if (isDead) return;
 
-    int distance = std::abs(rect.x + rect.w / 2 - (playerRect.x + playerRect.w / 2));
-    std::cout << "Distance to player: " << distance << "\n";
-
-    // Kiểm tra va chạm với hitbox tấn công của nhân vật
-    if (player.IsAttacking() && !isDead && !isTakingDamage) {
-        SDL_Rect attackHitbox = player.GetAttackHitbox();
-        if (SDL_HasIntersection(&rect, &attackHitbox)) {
-            std::cout << "Boss hit by player attack!\n";
-            ReduceHealth(10); // Giảm 10 máu mỗi lần bị tấn công
-        }
+    bool decide = DecisionDue();
+    if (decide) {
+        playerDistance = std::abs(rect.x + rect.w / 2 - (playerRect.x + playerRect.w / 2));
+        BOSS_LOG("Distance to player: " << playerDistance << "\n");
     }
 
-    if (currentLevel == 2 && health <= 0.4 * maxHealth && !hasSummonedMiniBoss) {
-        MiniBoss* miniBoss = new MiniBoss(
-            rect.x, rect.y,
-            miniBossRunSheet, 8, 128, 128,
-            miniBossAttackSheet, 6, 128, 128,
-            miniBossJumpSheet, 9, 128, 128,
-            miniBossDamageSheet, 3, 128, 128,
-            miniBossDeathSheet, 5, 128, 128,
-            miniBossDiveSheet, 5, 128, 128,
-            miniBossShootSheet, 4, 128, 128,
-            miniBossArrowTexture, 64, 64
-        );
-        miniBosses.push_back(miniBoss);
-        hasSummonedMiniBoss = true;
-        std::cout << "Boss 2 summons MiniBoss at x=" << rect.x + 100 << "\n";
-    }
-
-    for (Boss* miniBoss : miniBosses) {
-        miniBoss->Update(playerRect, platforms, platformCount, currentLevel, player);
-    }
-
-    if (currentLevel == 1 || currentLevel == 2) {
-        bool canAttack = (SDL_GetTicks() - lastAttackTime >= ATTACK_COOLDOWN);
+    if ((currentLevel == 1 || currentLevel == 2) && decide) {
+        bool canAttack = Elapsed(lastAttackTime, tuning.attackCooldown);
         if (isIdle && canAttack) {
             isIdle = false;
-            std::cout << "Boss " << currentLevel << " exits idle state after cooldown\n";
+            BOSS_LOG("Boss " << currentLevel << " exits idle state after cooldown\n");
         }
-        std::cout << "Boss " << currentLevel << " isIdle: " << isIdle << ", isRetreating: " << isRetreating << ", canAttack: " << canAttack << "\n";
+        BOSS_LOG("Boss " << currentLevel << " isIdle: " << isIdle << ", isRetreating: " << isRetreating << ", canAttack: " << canAttack << "\n");
+    }
 
+    if (currentLevel == 1 || currentLevel == 2) {
         if (isRetreating && !isIdle) {
             bool moved = false;
-            if (playerRect.x < rect.x && rect.x < SCREEN_WIDTH - rect.w) {
-                rect.x += BOSS_SPEED;
+            if (playerRect.x < rect.x && rect.x < world.GetLevelWidth() - rect.w) {
+                rect.x += tuning.bossSpeed;
                 facingRight = true;
                 moved = true;
             } else if (playerRect.x > rect.x && rect.x > 0) {
-                rect.x -= BOSS_SPEED;
+                rect.x -= tuning.bossSpeed;
                 facingRight = false;
                 moved = true;
             }
             int movedDistance = std::abs(rect.x - retreatStartX);
-            std::cout << "Boss " << currentLevel << " retreating: x=" << rect.x << ", moved=" << movedDistance << "\n";
+            BOSS_LOG("Boss " << currentLevel << " retreating: x=" << rect.x << ", moved=" << movedDistance << "\n");
 
-            if (rect.x <= 0 || rect.x + rect.w >= SCREEN_WIDTH) {
+            if (rect.x <= 0 || rect.x + rect.w >= world.GetLevelWidth()) {
                 isRetreating = false;
                 isIdle = true;
-                std::cout << "Boss " << currentLevel << " stops retreating at screen edge (x=" << rect.x << ") and enters idle state\n";
+                BOSS_LOG("Boss " << currentLevel << " stops retreating at screen edge (x=" << rect.x << ") and enters idle state\n");
             }
-            else if (movedDistance >= RETREAT_DISTANCE) {
+            else if (movedDistance >= tuning.retreatDistance) {
                 isRetreating = false;
                 isIdle = true;
-                std::cout << "Boss " << currentLevel << " stops retreating after moving " << movedDistance << " pixels and enters idle state\n";
+                BOSS_LOG("Boss " << currentLevel << " stops retreating after moving " << movedDistance << " pixels and enters idle state\n");
             }
         } else if (!isIdle && !isDashing && !isAttacking && !isJumping && !isDiving && !isRetreating) {
-            std::cout << "Boss " << currentLevel << " stays still while player approaches\n";
+            BOSS_LOG("Boss " << currentLevel << " stays still while player approaches\n");
         }
     }
 
     if (currentLevel == 2 && !isAttacking && !isJumping && !isDashing && !isRetreating && !isIdle) {
         if (playerRect.x < rect.x && rect.x > 0) {
-            rect.x -= BOSS_SPEED;
+            rect.x -= tuning.bossSpeed;
             facingRight = false;
-        } else if (playerRect.x > rect.x && rect.x + rect.w < SCREEN_WIDTH) {
-            rect.x += BOSS_SPEED;
+        } else if (playerRect.x > rect.x && rect.x + rect.w < world.GetLevelWidth()) {
+            rect.x += tuning.bossSpeed;
             facingRight = true;
         }
-        std::cout << "Boss " << currentLevel << " chases player\n";
+        BOSS_LOG("Boss " << currentLevel << " chases player\n");
     }
 
-    bool canAttack = (SDL_GetTicks() - lastAttackTime >= ATTACK_COOLDOWN);
-    if (!canAttack) {
-        std::cout << "Boss " << currentLevel << " in attack cooldown: " << (ATTACK_COOLDOWN - (SDL_GetTicks() - lastAttackTime)) << "ms remaining\n";
+    bool canAttack = decide && Elapsed(lastAttackTime, tuning.attackCooldown);
+    if (decide && !canAttack) {
+        BOSS_LOG("Boss " << currentLevel << " in attack cooldown: " << (tuning.attackCooldown - static_cast<int>(world.GetTime() - lastAttackTime)) << "ms remaining\n");
     }
 
     if (!isIdle && !isRetreating && !isAttacking && !isTakingDamage && !isJumping && !isDashing && !isDiving && canAttack) {
-        int action = rand() % 100;
-        if ((currentLevel == 1 || currentLevel == 2) && distance >= MIN_DISTANCE && distance <= MAX_DISTANCE) {
-            if (action < 30 && isOnGround) {
+        int action = NextRandom(100);
+        if ((currentLevel == 1 || currentLevel == 2) && playerDistance >= tuning.minDistance && playerDistance <= tuning.maxDistance) {
+            if (action < tuning.dashChance && isOnGround) {
                 isDashing = true;
-                dashStartTime = SDL_GetTicks();
-                currentAttackFrame = 0;
-                lastFrameTime = SDL_GetTicks();
-                hasDealtDamage = false;
-                std::cout << "Boss " << currentLevel << " starts dashing\n";
-            } else if (action < 60 && isOnGround) {
+                dashStartTime = world.GetTime();
+                attackSerial++;
+                Emit(EVENT_ATTACK_STARTED, ATTACK_DASH);
+                BOSS_LOG("Boss " << currentLevel << " starts dashing\n");
+            } else if (action < tuning.jumpDiveChance && isOnGround) {
                 isJumping = true;
                 verticalVelocity = JUMP_STRENGTH;
                 isOnGround = false;
-                currentJumpFrame = 0;
-                lastFrameTime = SDL_GetTicks();
-                std::cout << "Boss " << currentLevel << " starts jump-dive attack\n";
+                BOSS_LOG("Boss " << currentLevel << " starts jump-dive attack\n");
             }
-        } else if (action < 40 && isOnGround) {
+        } else if (action < tuning.farDashChance && isOnGround) {
             if (currentLevel == 1 || currentLevel == 2) {
                 isDashing = true;
-                dashStartTime = SDL_GetTicks();
-                currentAttackFrame = 0;
-                lastFrameTime = SDL_GetTicks();
-                hasDealtDamage = false;
-                std::cout << "Boss " << currentLevel << " starts dashing (outside ideal range)\n";
+                dashStartTime = world.GetTime();
+                attackSerial++;
+                Emit(EVENT_ATTACK_STARTED, ATTACK_DASH);
+                BOSS_LOG("Boss " << currentLevel << " starts dashing (outside ideal range)\n");
             }
-        } else if (action < 70 && isOnGround) {
+        } else if (action < tuning.farJumpChance && isOnGround) {
             isJumping = true;
             verticalVelocity = JUMP_STRENGTH;
             isOnGround = false;
-            currentJumpFrame = 0;
-            lastFrameTime = SDL_GetTicks();
-            std::cout << "Boss " << currentLevel << " starts jumping\n";
+            BOSS_LOG("Boss " << currentLevel << " starts jumping\n");
         }
     }
 
     if ((currentLevel == 1 || currentLevel == 2) && isJumping && !isDiving && verticalVelocity >= 0) {
         isJumping = false;
         isDiving = true;
-        diveStartTime = SDL_GetTicks();
-        currentAttackFrame = 0;
-        lastFrameTime = SDL_GetTicks();
-        std::cout << "Boss " << currentLevel << " starts diving\n";
+        diveStartTime = world.GetTime();
+        attackSerial++;
+        Emit(EVENT_ATTACK_STARTED, ATTACK_DIVE);
+        BOSS_LOG("Boss " << currentLevel << " starts diving\n");
     }
 
     if (isDiving && (currentLevel == 1 || currentLevel == 2)) {
         if (playerRect.x < rect.x) {
-            horizontalDiveVelocity = -DIVE_SPEED_HORIZONTAL;
+            horizontalDiveVelocity = -tuning.diveSpeedHorizontal;
             facingRight = false;
         } else {
-            horizontalDiveVelocity = DIVE_SPEED_HORIZONTAL;
+            horizontalDiveVelocity = tuning.diveSpeedHorizontal;
             facingRight = true;
         }
 
         rect.x += horizontalDiveVelocity;
-        verticalVelocity = DIVE_SPEED_VERTICAL;
-        std::cout << "Boss " << currentLevel << " diving: horizontal=" << horizontalDiveVelocity << ", vertical=" << verticalVelocity << "\n";
+        verticalVelocity = tuning.diveSpeedVertical;
+        BOSS_LOG("Boss " << currentLevel << " diving: horizontal=" << horizontalDiveVelocity << ", vertical=" << verticalVelocity << "\n");
 
         if (rect.x < 0) rect.x = 0;
-        if (rect.x + rect.w > SCREEN_WIDTH) rect.x = SCREEN_WIDTH - rect.w;
-
-        SDL_Rect attackHitbox = {
-            rect.x + (facingRight ? 30 : -30),
-            rect.y + 20,
-            60,
-            60
-        };
-        std::cout << "Dive hitbox: x=" << attackHitbox.x << ", y=" << attackHitbox.y << ", w=" << attackHitbox.w << ", h=" << attackHitbox.h << "\n";
-
-        if (SDL_HasIntersection(&attackHitbox, &playerRect)) {
-            std::cout << "Boss " << currentLevel << " dive collides with player\n";
-            if (!player.IsDead() && !player.IsInvulnerable() && !hasDealtDamage) {
-                std::cout << "Boss " << currentLevel << " dives and hits player!\n";
-                player.TakeDamage(1);
-                hasDealtDamage = true;
-            }
-            isDiving = false;
-            currentAttackFrame = 0;
-            lastAttackTime = SDL_GetTicks();
-            isRetreating = true;
-            retreatStartX = rect.x;
-            std::cout << "Boss " << currentLevel << " dive ends, starting cooldown and retreating from x=" << retreatStartX << "\n";
-        } else if (SDL_GetTicks() - diveStartTime >= DIVE_DURATION) {
-            std::cout << "Boss " << currentLevel << " dive timeout\n";
-            isDiving = false;
-            currentAttackFrame = 0;
-            lastAttackTime = SDL_GetTicks();
-            isRetreating = true;
-            retreatStartX = rect.x;
-            std::cout << "Boss " << currentLevel << " dive ends, starting cooldown and retreating from x=" << retreatStartX << "\n";
+        if (rect.x + rect.w > world.GetLevelWidth()) rect.x = world.GetLevelWidth() - rect.w;
+
+        // Trúng player được xử lý trong lượt kiểm tra hộp va chạm (OnAttackLanded)
+        if (Elapsed(diveStartTime, tuning.diveDuration)) {
+            BOSS_LOG("Boss " << currentLevel << " dive timeout\n");
+            EndAttack();
         }
     }
 
     if (isDashing && (currentLevel == 1 || currentLevel == 2)) {
         if (playerRect.x < rect.x && rect.x > 0) {
-            rect.x -= DASH_SPEED;
+            rect.x -= tuning.dashSpeed;
             facingRight = false;
-        } else if (playerRect.x > rect.x && rect.x + rect.w < SCREEN_WIDTH) {
-            rect.x += DASH_SPEED;
+        } else if (playerRect.x > rect.x && rect.x + rect.w < world.GetLevelWidth()) {
+            rect.x += tuning.dashSpeed;
             facingRight = true;
         }
 
-        SDL_Rect attackHitbox = {
-            rect.x + (facingRight ? 20 : -20),
-            rect.y,
-            80,
-            100
-        };
-        std::cout << "Dash hitbox: x=" << attackHitbox.x << ", y=" << attackHitbox.y << ", w=" << attackHitbox.w << ", h=" << attackHitbox.h << "\n";
-
-        if (SDL_HasIntersection(&attackHitbox, &playerRect)) {
-            std::cout << "Boss " << currentLevel << " dash collides with player\n";
-            if (!player.IsDead() && !player.IsInvulnerable() && !hasDealtDamage) {
-                std::cout << "Boss " << currentLevel << " dashes and hits player!\n";
-                player.TakeDamage(1);
-                hasDealtDamage = true;
-            }
-            isDashing = false;
-            currentAttackFrame = 0;
-            lastAttackTime = SDL_GetTicks();
-            isRetreating = true;
-            retreatStartX = rect.x;
-            std::cout << "Boss " << currentLevel << " dash ends, starting cooldown and retreating from x=" << retreatStartX << "\n";
-        } else if (SDL_GetTicks() - dashStartTime >= DASH_DURATION) {
-            std::cout << "Boss " << currentLevel << " dash timeout\n";
-            isDashing = false;
-            currentAttackFrame = 0;
-            lastAttackTime = SDL_GetTicks();
-            isRetreating = true;
-            retreatStartX = rect.x;
-            std::cout << "Boss " << currentLevel << " dash ends, starting cooldown and retreating from x=" << retreatStartX << "\n";
+        if (Elapsed(dashStartTime, tuning.dashDuration)) {
+            BOSS_LOG("Boss " << currentLevel << " dash timeout\n");
+            EndAttack();
         }
     }
 
-    verticalVelocity += GRAVITY;
-    rect.y += verticalVelocity;
-
-    bool onPlatform = false;
-    for (int i = 0; i < platformCount; ++i) {
-        if (rect.y + rect.h <= platforms[i].y + 20 &&
-            rect.y + rect.h + verticalVelocity >= platforms[i].y &&
-            rect.x + rect.w > platforms[i].x && rect.x < platforms[i].x + platforms[i].w &&
-            verticalVelocity > 0) {
-            rect.y = platforms[i].y - rect.h;
-            verticalVelocity = 0;
-            isOnGround = true;
-            isJumping = false;
-            if (isDiving && (currentLevel == 1 || currentLevel == 2)) {
-                isDiving = false;
-                currentAttackFrame = 0;
-                lastAttackTime = SDL_GetTicks();
-                isRetreating = true;
-                retreatStartX = rect.x;
-                std::cout << "Boss " << currentLevel << " dive ends on platform, starting cooldown and retreating from x=" << retreatStartX << "\n";
-            }
-            onPlatform = true;
-            break;
+    if (isAttacking && animator.GetClip() == &attackClip && animator.IsFinished()) {
+        isAttacking = false;
+        lastAttackTime = world.GetTime();
+        BOSS_LOG("Boss " << currentLevel << " stops attacking, starting cooldown\n");
+        if ((currentLevel == 1 || currentLevel == 2) && playerDistance > tuning.idleDistance) {
+            isIdle = true;
+            BOSS_LOG("Boss " << currentLevel << " enters idle state after attack\n");
         }
     }
+}
+
+Boss* Boss::UpdateSummons(int currentLevel) {
+    if (isDead || !canSummon) return nullptr;
+
+    // Máu <= 40%, so sánh số nguyên để mọi bản build cho cùng kết quả
+    if (currentLevel == 2 && health * 10 <= maxHealth * 4 && !hasSummonedMiniBoss && world.HasFreeBody()) {
+        Boss* miniBoss = CreateEnemy(world, ENEMY_MINIBOSS, rect.x, rect.y);
+        if (!miniBoss) return nullptr;
+        miniBoss->SetTuning(tuning);
+        miniBoss->SetEventBus(events);
+        miniBoss->SeedRandom(static_cast<Uint32>(NextRandom(1 << 30)));
+        miniBoss->isSummoned = true;
+        hasSummonedMiniBoss = true;
+        std::cout << "Boss 2 summons MiniBoss at x=" << rect.x + 100 << "\n";
+        return miniBoss;
+    }
+    return nullptr;
+}
+
+void Boss::CollectBoxes(HitWorld& hits) {
+    if (isDead) return;
+    // Trạng thái có thể vừa đổi trong pha va chạm; chọn clip trước để hộp khớp với đòn đang đánh
+    animator.Play(SelectClip());
+    hits.AddClipBoxes(animator, rect, facingRight, bodyId, TEAM_ENEMY, attackSerial);
+}
+
+void Boss::OnAttackLanded(Uint32 attack) {
+    if (attack != attackSerial || (!isDashing && !isDiving)) return;
+    BOSS_LOG("Boss attack " << attack << " hits player\n");
+    EndAttack();
+}
+
+void Boss::EndAttack() {
+    isDashing = false;
+    isDiving = false;
+    lastAttackTime = world.GetTime();
+    isRetreating = true;
+    retreatStartX = rect.x;
+    BOSS_LOG("Boss attack ends, starting cooldown and retreating from x=" << retreatStartX << "\n");
+}
+
+void Boss::SetTuning(const BossTuning& value) {
+    tuning = value;
+    ScheduleDecisions();
+}
+
+void Boss::SetEventBus(EventBus* bus) {
+    events = bus;
+}
+
+void Boss::Emit(int type, int amount) {
+    Emit(type, amount, rect);
+}
+
+void Boss::Emit(int type, int amount, const SDL_Rect& where) {
+    if (events) events->Publish(type, bodyId, TEAM_ENEMY, amount, where);
+}
+
+void Boss::SeedRandom(Uint32 seed) {
+    rngState = seed ? seed : DEFAULT_RANDOM_SEED; // xorshift không được có trạng thái 0
+}
+
+void Boss::ScheduleDecisions() {
+    if (tuning.decisionInterval <= 0) {
+        nextDecisionTime = world.GetTime();
+        return;
+    }
+    // Bước lệch pha gần với nghịch đảo tỉ lệ vàng của chu kỳ: các bodyId liên tiếp rơi vào các pha cách xa nhau
+    Uint32 interval = static_cast<Uint32>(tuning.decisionInterval);
+    Uint32 phase = (static_cast<Uint32>(bodyId) * (interval * 618 / 1000 + 1)) % interval;
+    nextDecisionTime = world.GetTime() + phase;
+}
+
+bool Boss::DecisionDue() {
+    Uint32 now = world.GetTime();
+    if (tuning.decisionInterval <= 0) return true;
+    if (now < nextDecisionTime) return false;
+    // Giữ nguyên pha của boss; tick dài (dt lớn) chỉ tính là một lần ra quyết định
+    Uint32 interval = static_cast<Uint32>(tuning.decisionInterval);
+    nextDecisionTime += ((now - nextDecisionTime) / interval + 1) * interval;
+    return true;
+}
 
-    if (rect.y + rect.h >= 500 && !onPlatform) {
-        rect.y = 500 - rect.h;
-        verticalVelocity = 0;
+bool Boss::Elapsed(Uint32 since, int duration) const {
+    return world.GetTime() - since >= static_cast<Uint32>(duration);
+}
+
+int Boss::NextRandom(int range) {
+    // xorshift32: mỗi boss có chuỗi số riêng, không dùng trạng thái chung của rand()
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return static_cast<int>(rngState % static_cast<Uint32>(range));
+}
+
+void Boss::ResolveContacts() {
+    if (isDead) return;
+
+    const BodyContact& contact = world.GetBody(bodyId).contact;
+    if (contact.landed) {
         isJumping = false;
-        if (isDiving && (currentLevel == 1 || currentLevel == 2)) {
+        if (isDiving) {
+            SDL_Rect feet = {rect.x, rect.y + rect.h, rect.w, 0};
+            Emit(EVENT_LANDED, 0, feet);
             isDiving = false;
-            currentAttackFrame = 0;
-            lastAttackTime = SDL_GetTicks();
+            lastAttackTime = world.GetTime();
             isRetreating = true;
             retreatStartX = rect.x;
-            std::cout << "Boss " << currentLevel << " dive ends on ground, starting cooldown and retreating from x=" << retreatStartX << "\n";
+            BOSS_LOG("Boss dive ends on " << (contact.onPlatform ? "platform" : "ground") << ", starting cooldown and retreating from x=" << retreatStartX << "\n");
         }
-        isOnGround = true;
     }
+}
 
-    if (isAttacking && currentAttackFrame >= attackFrameCount - 1) {
-        isAttacking = false;
-        currentAttackFrame = 0;
-        lastAttackTime = SDL_GetTicks();
-        std::cout << "Boss " << currentLevel << " stops attacking, starting cooldown\n";
-        if ((currentLevel == 1 || currentLevel == 2) && distance > IDLE_DISTANCE) {
-            isIdle = true;
-            std::cout << "Boss " << currentLevel << " enters idle state after attack\n";
-        }
+const AnimationClip* Boss::SelectClip() const {
+    if (isDead) return &deathClip;
+    if (isTakingDamage) return &damageClip;
+    if (isDiving) return &diveClip;
+    if (isAttacking || isDashing) return &attackClip;
+    if (isJumping) return &jumpClip;
+    if (isIdle) return &idleClip;
+    return &runClip; // Chạy đuổi hoặc lùi lại đều dùng hoạt ảnh chạy
+}
+
+void Boss::Animate(Uint32 dt) {
+    animator.Play(SelectClip());
+    int events = animator.Update(dt);
+    if ((events & ANIM_EVENT_FINISHED) && animator.GetClip() == &damageClip) {
+        isTakingDamage = false;
     }
 }
 
-void Boss::Render(SDL_Renderer* renderer, SDL_Texture* idleTexture, Uint32 currentTime) {
+void Boss::Render(RenderList& list) const {
     // Vẽ thanh máu
-    RenderHealthBar(renderer);
+    RenderHealthBar(list);
 
-    SDL_Rect srcRect, destRect;
     SDL_RendererFlip flip = facingRight ? SDL_FLIP_NONE : SDL_FLIP_HORIZONTAL;
+    animator.Draw(list, rect, flip, LAYER_ACTOR);
+}
 
-    if (isDead) {
-        if (currentTime > lastFrameTime + FRAME_DELAY) {
-            lastFrameTime = currentTime;
-            currentDeathFrame++;
-        }
-        srcRect = {currentDeathFrame * deathFrameWidth, 0, deathFrameWidth, deathFrameHeight};
-        destRect = {rect.x + (rect.w - deathFrameWidth) / 2, rect.y + (rect.h - deathFrameHeight), deathFrameWidth, deathFrameHeight};
-        SDL_RenderCopyEx(renderer, deathSheet, &srcRect, &destRect, 0, nullptr, flip);
-    } else if (isTakingDamage) {
-        if (currentTime > lastFrameTime + FRAME_DELAY) {
-            lastFrameTime = currentTime;
-            currentDamageFrame++;
-            if (currentDamageFrame >= damageFrameCount) {
-                isTakingDamage = false;
-                currentDamageFrame = 0;
-            }
-        }
-        srcRect = {currentDamageFrame * damageFrameWidth, 0, damageFrameWidth, deathFrameHeight};
-        destRect = {rect.x + (rect.w - damageFrameWidth) / 2, rect.y + (rect.h - deathFrameHeight), damageFrameWidth, deathFrameHeight};
-        SDL_RenderCopyEx(renderer, damageSheet, &srcRect, &destRect, 0, nullptr, flip);
-    } else if (isDiving) {
-        if (currentTime > lastFrameTime + FRAME_DELAY) {
-            lastFrameTime = currentTime;
-            currentAttackFrame++;
-        }
-        srcRect = {currentAttackFrame * diveFrameWidth, 0, diveFrameWidth, diveFrameHeight};
-        destRect = {rect.x + (rect.w - diveFrameWidth) / 2, rect.y + (rect.h - diveFrameHeight), diveFrameWidth, diveFrameHeight};
-        SDL_RenderCopyEx(renderer, diveSheet, &srcRect, &destRect, 0, nullptr, flip);
-        std::cout << "Rendering dive animation: frame " << currentAttackFrame << "\n";
-    } else if (isAttacking || isDashing) {
-        if (currentTime > lastFrameTime + FRAME_DELAY) {
-            lastFrameTime = currentTime;
-            currentAttackFrame++;
-        }
-        srcRect = {currentAttackFrame * attackFrameWidth, 0, attackFrameWidth, attackFrameHeight};
-        destRect = {rect.x + (rect.w - attackFrameWidth) / 2, rect.y + (rect.h - attackFrameHeight), attackFrameWidth, attackFrameHeight};
-        SDL_RenderCopyEx(renderer, attackSheet, &srcRect, &destRect, 0, nullptr, flip);
-        std::cout << "Rendering attack/dash animation: frame " << currentAttackFrame << "\n";
-    } else if (isJumping) {
-        if (currentTime > lastFrameTime + FRAME_DELAY) {
-            lastFrameTime = currentTime;
-            currentJumpFrame = (currentJumpFrame + 1) % jumpFrameCount;
-        }
-        srcRect = {currentJumpFrame * jumpFrameWidth, 0, jumpFrameWidth, jumpFrameHeight};
-        destRect = {rect.x + (rect.w - jumpFrameWidth) / 2, rect.y + (rect.h - jumpFrameHeight), jumpFrameWidth, jumpFrameHeight};
-        SDL_RenderCopyEx(renderer, jumpSheet, &srcRect, &destRect, 0, nullptr, flip);
-    } else if (isIdle) {
-        srcRect = {0, 0, runFrameWidth, runFrameHeight};
-        destRect = {rect.x + (rect.w - runFrameWidth) / 2, rect.y + (rect.h - runFrameHeight), runFrameWidth, runFrameHeight};
-        SDL_RenderCopyEx(renderer, idleTexture, &srcRect, &destRect, 0, nullptr, flip);
-        std::cout << "Rendering idle animation\n";
-    } else if (isRetreating) {
-        if (currentTime > lastFrameTime + FRAME_DELAY) {
-            lastFrameTime = currentTime;
-            currentRunFrame = (currentRunFrame + 1) % runFrameCount;
-        }
-        srcRect = {currentRunFrame * runFrameWidth, 0, runFrameWidth, runFrameHeight};
-        destRect = {rect.x + (rect.w - runFrameWidth) / 2, rect.y + (rect.h - runFrameHeight), runFrameWidth, runFrameHeight};
-        SDL_RenderCopyEx(renderer, runSheet, &srcRect, &destRect, 0, nullptr, flip);
-        std::cout << "Rendering retreat animation (using run): frame " << currentRunFrame << "\n";
-    } else {
-        if (currentTime > lastFrameTime + FRAME_DELAY) {
-            lastFrameTime = currentTime;
-            currentRunFrame = (currentRunFrame + 1) % runFrameCount;
-        }
-        srcRect = {currentRunFrame * runFrameWidth, 0, runFrameWidth, runFrameHeight};
-        destRect = {rect.x + (rect.w - runFrameWidth) / 2, rect.y + (rect.h - runFrameHeight), runFrameWidth, runFrameHeight};
-        SDL_RenderCopyEx(renderer, runSheet, &srcRect, &destRect, 0, nullptr, flip);
-    }
-
-    // Vẽ MiniBoss và thanh máu của chúng
-    for (Boss* miniBoss : miniBosses) {
-        miniBoss->Render(renderer, idleTexture, currentTime);
-    }
+void Boss::HashState(StateHash& hash) const {
+    hash.Add(bodyId);
+    hash.Add(rect);
+    hash.Add(verticalVelocity);
+    hash.Add(isOnGround);
+    hash.Add(health);
+    hash.Add(maxHealth);
+    hash.Add(horizontalDiveVelocity);
+    hash.Add(isJumping);
+    hash.Add(facingRight);
+    hash.Add(isAttacking);
+    hash.Add(isDashing);
+    hash.Add(isDiving);
+    hash.Add(isTakingDamage);
+    hash.Add(isDead);
+    hash.Add(isIdle);
+    hash.Add(isRetreating);
+    hash.Add(retreatStartX);
+    hash.Add(dashStartTime);
+    hash.Add(diveStartTime);
+    hash.Add(lastAttackTime);
+    hash.Add(playerDistance);
+    hash.Add(nextDecisionTime);
+    hash.Add(hasSummonedMiniBoss);
+    hash.Add(isSummoned);
+    hash.Add(rngState);
+    hash.Add(attackSerial);
+    animator.HashState(hash);
 }
 
 void Boss::ReduceHealth(int amount) {
     if (isDead) return;
     health -= amount;
-    std::cout << "Boss health: " << health << "\n";
+    BOSS_LOG("Boss health: " << health << "\n");
     if (health <= 0) {
         health = 0;
         isDead = true;
-        currentDeathFrame = 0;
-        lastFrameTime = SDL_GetTicks();
+        animator.Play(&deathClip, true);
+        Emit(EVENT_DIED);
     } else {
         isTakingDamage = true;
-        currentDamageFrame = 0;
-        lastFrameTime = SDL_GetTicks();
+        animator.Play(&damageClip, true);
+        Emit(EVENT_DAMAGED, health);
     }
 }
 
-MiniBoss::MiniBoss(int x, int y,
-                   SDL_Texture* run, int runCount, int runWidth, int runHeight,
-                   SDL_Texture* attack, int attackCount, int attackWidth, int attackHeight,
-                   SDL_Texture* jump, int jumpCount, int jumpWidth, int jumpHeight,
-                   SDL_Texture* damage, int damageCount, int damageWidth, int damageHeight,
-                   SDL_Texture* death, int deathCount, int deathWidth, int deathHeight,
-                   SDL_Texture* dive, int diveCount, int diveWidth, int diveHeight,
-                   SDL_Texture* shoot, int shootCount, int shootWidth, int shootHeight,
-                   SDL_Texture* arrow, int arrowWidth, int arrowHeight)
-    : Boss(x, y, run, runCount, runWidth, runHeight, attack, attackCount, attackWidth, attackHeight,
+MiniBoss::MiniBoss(PhysicsWorld& world, int x, int y, int idle,
+                   int run, int runCount, int runWidth, int runHeight,
+                   int attack, int attackCount, int attackWidth, int attackHeight,
+                   int jump, int jumpCount, int jumpWidth, int jumpHeight,
+                   int damage, int damageCount, int damageWidth, int damageHeight,
+                   int death, int deathCount, int deathWidth, int deathHeight,
+                   int dive, int diveCount, int diveWidth, int diveHeight,
+                   int shoot, int shootCount, int shootWidth, int shootHeight,
+                   int arrow, int arrowWidth, int arrowHeight)
+    : Boss(world, x, y, idle, run, runCount, runWidth, runHeight, attack, attackCount, attackWidth, attackHeight,
            jump, jumpCount, jumpWidth, jumpHeight, damage, damageCount, damageWidth, damageHeight,
            death, deathCount, deathWidth, deathHeight, dive, diveCount, diveWidth, diveHeight),
-      isShooting(false), shootStartTime(0), arrowTexture(arrow),
-      shootSheet(shoot), shootFrameCount(shootCount), shootFrameWidth(shootWidth), shootFrameHeight(shootHeight) {
+      isShooting(false), shootStartTime(0), arrowSprite(arrow),
+      shootClip(MakeClip(shoot, shootCount, shootWidth, shootHeight, BOSS_FRAME_DELAY, true)) {
     health = 1000;
     maxHealth = 1000;
+    arrows.reserve(ARROW_CAPACITY);
 }
 
-void MiniBoss::Update(const SDL_Rect& playerRect, SDL_Rect* platforms, int platformCount, int currentLevel, Player& player) {
+void MiniBoss::Update(const SDL_Rect& playerRect, int currentLevel, const Player& player) {
     if (isDead) return;
 
-    int distance = std::abs(rect.x + rect.w / 2 - (playerRect.x + playerRect.w / 2));
-    std::cout << "MiniBoss distance to player: " << distance << "\n";
-
-    // Kiểm tra va chạm với hitbox tấn công của nhân vật
-    if (player.IsAttacking() && !isDead && !isTakingDamage) {
-        SDL_Rect attackHitbox = player.GetAttackHitbox();
-        if (SDL_HasIntersection(&rect, &attackHitbox)) {
-            std::cout << "MiniBoss hit by player attack!\n";
-            ReduceHealth(10); // Giảm 10 máu mỗi lần bị tấn công
-        }
+    bool decide = DecisionDue();
+    if (decide) {
+        playerDistance = std::abs(rect.x + rect.w / 2 - (playerRect.x + playerRect.w / 2));
+        BOSS_LOG("MiniBoss distance to player: " << playerDistance << "\n");
     }
 
     if (currentLevel == 2) {
-        bool canAttack = (SDL_GetTicks() - lastAttackTime >= ATTACK_COOLDOWN);
-        if (isIdle && canAttack) {
+        if (decide && isIdle && Elapsed(lastAttackTime, tuning.attackCooldown)) {
             isIdle = false;
-            std::cout << "MiniBoss exits idle state after cooldown\n";
+            BOSS_LOG("MiniBoss exits idle state after cooldown\n");
         }
 
         if (isRetreating && !isIdle) {
             bool moved = false;
-            if (playerRect.x < rect.x && rect.x < SCREEN_WIDTH - rect.w) {
-                rect.x += BOSS_SPEED;
+            if (playerRect.x < rect.x && rect.x < world.GetLevelWidth() - rect.w) {
+                rect.x += tuning.bossSpeed;
                 facingRight = true;
                 moved = true;
             } else if (playerRect.x > rect.x && rect.x > 0) {
-                rect.x -= BOSS_SPEED;
+                rect.x -= tuning.bossSpeed;
                 facingRight = false;
                 moved = true;
             }
             int movedDistance = std::abs(rect.x - retreatStartX);
-            std::cout << "MiniBoss retreating: x=" << rect.x << ", moved=" << movedDistance << "\n";
+            BOSS_LOG("MiniBoss retreating: x=" << rect.x << ", moved=" << movedDistance << "\n");
 
-            if (rect.x <= 0 || rect.x + rect.w >= SCREEN_WIDTH) {
+            if (rect.x <= 0 || rect.x + rect.w >= world.GetLevelWidth()) {
                 isRetreating = false;
                 isIdle = true;
-                std::cout << "MiniBoss stops retreating at screen edge (x=" << rect.x << ") and enters idle state\n";
+                BOSS_LOG("MiniBoss stops retreating at screen edge (x=" << rect.x << ") and enters idle state\n");
             }
-            else if (movedDistance >= RETREAT_DISTANCE) {
+            else if (movedDistance >= tuning.retreatDistance) {
                 isRetreating = false;
                 isIdle = true;
-                std::cout << "MiniBoss stops retreating after moving " << movedDistance << " pixels and enters idle state\n";
+                BOSS_LOG("MiniBoss stops retreating after moving " << movedDistance << " pixels and enters idle state\n");
             }
         } else if (!isIdle && !isDashing && !isAttacking && !isJumping && !isDiving && !isRetreating && !isShooting) {
             if (playerRect.x < rect.x && rect.x > 0) {
-                rect.x -= BOSS_SPEED;
+                rect.x -= tuning.bossSpeed;
                 facingRight = false;
-            } else if (playerRect.x > rect.x && rect.x + rect.w < SCREEN_WIDTH) {
-                rect.x += BOSS_SPEED;
+            } else if (playerRect.x > rect.x && rect.x + rect.w < world.GetLevelWidth()) {
+                rect.x += tuning.bossSpeed;
                 facingRight = true;
             }
             // Đặt MiniBoss ngang hàng với nhân vật
             rect.y = playerRect.y;
             // Đảm bảo MiniBoss không chìm dưới sàn
-            if (rect.y + rect.h > 500) {
-                rect.y = 500 - rect.h;
+            if (rect.y + rect.h > world.GetGroundY()) {
+                rect.y = world.GetGroundY() - rect.h;
             }
-            std::cout << "MiniBoss chases player on same y-line: y=" << rect.y << "\n";
+            BOSS_LOG("MiniBoss chases player on same y-line: y=" << rect.y << "\n");
         }
     }
 
-    bool canAttack = (SDL_GetTicks() - lastAttackTime >= ATTACK_COOLDOWN);
-    bool canShoot = (SDL_GetTicks() - shootStartTime >= SHOOT_COOLDOWN);
-    if (!canAttack) {
-        std::cout << "MiniBoss in attack cooldown: " << (ATTACK_COOLDOWN - (SDL_GetTicks() - lastAttackTime)) << "ms remaining\n";
+    bool canAttack = decide && Elapsed(lastAttackTime, tuning.attackCooldown);
+    bool canShoot = decide && Elapsed(shootStartTime, tuning.shootCooldown);
+    if (decide && !canAttack) {
+        BOSS_LOG("MiniBoss in attack cooldown: " << (tuning.attackCooldown - static_cast<int>(world.GetTime() - lastAttackTime)) << "ms remaining\n");
     }
-    if (!canShoot) {
-        std::cout << "MiniBoss in shoot cooldown: " << (SHOOT_COOLDOWN - (SDL_GetTicks() - shootStartTime)) << "ms remaining\n";
+    if (decide && !canShoot) {
+        BOSS_LOG("MiniBoss in shoot cooldown: " << (tuning.shootCooldown - static_cast<int>(world.GetTime() - shootStartTime)) << "ms remaining\n");
     }
 
     if (!isIdle && !isRetreating && !isAttacking && !isTakingDamage && !isJumping && !isDashing && !isDiving && !isShooting && canAttack) {
-        int action = rand() % 100;
-        if (currentLevel == 2 && distance >= MIN_DISTANCE && distance <= MAX_DISTANCE) {
-            if (action < 70 && isOnGround && canShoot) {
+        int action = NextRandom(100);
+        if (currentLevel == 2 && playerDistance >= tuning.minDistance && playerDistance <= tuning.maxDistance) {
+            if (action < tuning.miniShootChance && isOnGround && canShoot) {
                 isShooting = true;
-                shootStartTime = SDL_GetTicks();
-                currentAttackFrame = 0;
-                lastFrameTime = SDL_GetTicks();
-                hasDealtDamage = false;
+                shootStartTime = world.GetTime();
                 // Điều chỉnh vị trí khởi tạo mũi tên (64x64)
                 int arrowX = rect.x + (facingRight ? rect.w : -64);
                 int arrowY = rect.y + (rect.h - 64) / 2; // Căn giữa theo chiều cao
-                arrows.emplace_back(arrowX, arrowY, facingRight, 64, 64);
-                std::cout << "MiniBoss shoots arrow at x=" << arrowX << ", y=" << arrowY << ", facingRight=" << facingRight << "\n";
-            } else if (action < 80 && isOnGround) {
+                arrows.emplace_back(arrowX, arrowY, facingRight, 64, 64, ++attackSerial);
+                Emit(EVENT_PROJECTILE_FIRED, ATTACK_SHOOT, arrows.back().rect);
+                BOSS_LOG("MiniBoss shoots arrow at x=" << arrowX << ", y=" << arrowY << ", facingRight=" << facingRight << "\n");
+            } else if (action < tuning.miniDashChance && isOnGround) {
                 isDashing = true;
-                dashStartTime = SDL_GetTicks();
-                currentAttackFrame = 0;
-                lastFrameTime = SDL_GetTicks();
-                hasDealtDamage = false;
-                std::cout << "MiniBoss starts dashing\n";
-            } else if (action < 90 && isOnGround) {
+                dashStartTime = world.GetTime();
+                attackSerial++;
+                Emit(EVENT_ATTACK_STARTED, ATTACK_DASH);
+                BOSS_LOG("MiniBoss starts dashing\n");
+            } else if (action < tuning.miniJumpDiveChance && isOnGround) {
                 isJumping = true;
                 verticalVelocity = JUMP_STRENGTH;
                 isOnGround = false;
-                currentJumpFrame = 0;
-                lastFrameTime = SDL_GetTicks();
-                std::cout << "MiniBoss starts jump-dive attack\n";
+                BOSS_LOG("MiniBoss starts jump-dive attack\n");
             }
-        } else if (action < 40 && isOnGround) {
+        } else if (action < tuning.farDashChance && isOnGround) {
             isDashing = true;
-            dashStartTime = SDL_GetTicks();
-            currentAttackFrame = 0;
-            lastFrameTime = SDL_GetTicks();
-            hasDealtDamage = false;
-            std::cout << "MiniBoss starts dashing (outside ideal range)\n";
-        } else if (action < 70 && isOnGround) {
+            dashStartTime = world.GetTime();
+            attackSerial++;
+            Emit(EVENT_ATTACK_STARTED, ATTACK_DASH);
+            BOSS_LOG("MiniBoss starts dashing (outside ideal range)\n");
+        } else if (action < tuning.farJumpChance && isOnGround) {
             isJumping = true;
             verticalVelocity = JUMP_STRENGTH;
             isOnGround = false;
-            currentJumpFrame = 0;
-            lastFrameTime = SDL_GetTicks();
-            std::cout << "MiniBoss starts jumping\n";
+            BOSS_LOG("MiniBoss starts jumping\n");
         }
     }
 
     if (currentLevel == 2 && isJumping && !isDiving && verticalVelocity >= 0) {
         isJumping = false;
         isDiving = true;
-        diveStartTime = SDL_GetTicks();
-        currentAttackFrame = 0;
-        lastFrameTime = SDL_GetTicks();
-        std::cout << "MiniBoss starts diving\n";
+        diveStartTime = world.GetTime();
+        attackSerial++;
+        Emit(EVENT_ATTACK_STARTED, ATTACK_DIVE);
+        BOSS_LOG("MiniBoss starts diving\n");
     }
 
     if (isDiving && currentLevel == 2) {
         if (playerRect.x < rect.x) {
-            horizontalDiveVelocity = -DIVE_SPEED_HORIZONTAL;
+            horizontalDiveVelocity = -tuning.diveSpeedHorizontal;
             facingRight = false;
         } else {
-            horizontalDiveVelocity = DIVE_SPEED_HORIZONTAL;
+            horizontalDiveVelocity = tuning.diveSpeedHorizontal;
             facingRight = true;
         }
 
         rect.x += horizontalDiveVelocity;
-        verticalVelocity = DIVE_SPEED_VERTICAL;
-        std::cout << "MiniBoss diving: horizontal=" << horizontalDiveVelocity << ", vertical=" << verticalVelocity << "\n";
+        verticalVelocity = tuning.diveSpeedVertical;
+        BOSS_LOG("MiniBoss diving: horizontal=" << horizontalDiveVelocity << ", vertical=" << verticalVelocity << "\n");
 
         if (rect.x < 0) rect.x = 0;
-        if (rect.x + rect.w > SCREEN_WIDTH) rect.x = SCREEN_WIDTH - rect.w;
-
-        SDL_Rect attackHitbox = {
-            rect.x + (facingRight ? 30 : -30),
-            rect.y + 20,
-            60,
-            60
-        };
-        std::cout << "MiniBoss dive hitbox: x=" << attackHitbox.x << ", y=" << attackHitbox.y << ", w=" << attackHitbox.w << ", h=" << attackHitbox.h << "\n";
-
-        if (SDL_HasIntersection(&attackHitbox, &playerRect)) {
-            std::cout << "MiniBoss dive collides with player\n";
-            if (!player.IsDead() && !player.IsInvulnerable() && !hasDealtDamage) {
-                std::cout << "MiniBoss dives and hits player!\n";
-                player.TakeDamage(1);
-                hasDealtDamage = true;
-            }
-            isDiving = false;
-            currentAttackFrame = 0;
-            lastAttackTime = SDL_GetTicks();
-            isRetreating = true;
-            retreatStartX = rect.x;
-            std::cout << "MiniBoss dive ends, starting cooldown and retreating from x=" << retreatStartX << "\n";
-        } else if (SDL_GetTicks() - diveStartTime >= DIVE_DURATION) {
-            std::cout << "MiniBoss dive timeout\n";
-            isDiving = false;
-            currentAttackFrame = 0;
-            lastAttackTime = SDL_GetTicks();
-            isRetreating = true;
-            retreatStartX = rect.x;
-            std::cout << "MiniBoss dive ends, starting cooldown and retreating from x=" << retreatStartX << "\n";
+        if (rect.x + rect.w > world.GetLevelWidth()) rect.x = world.GetLevelWidth() - rect.w;
+
+        // Trúng player được xử lý trong lượt kiểm tra hộp va chạm (OnAttackLanded)
+        if (Elapsed(diveStartTime, tuning.diveDuration)) {
+            BOSS_LOG("MiniBoss dive timeout\n");
+            EndAttack();
         }
     }
 
     if (isDashing && currentLevel == 2) {
         if (playerRect.x < rect.x && rect.x > 0) {
-            rect.x -= DASH_SPEED;
+            rect.x -= tuning.dashSpeed;
             facingRight = false;
-        } else if (playerRect.x > rect.x && rect.x + rect.w < SCREEN_WIDTH) {
-            rect.x += DASH_SPEED;
+        } else if (playerRect.x > rect.x && rect.x + rect.w < world.GetLevelWidth()) {
+            rect.x += tuning.dashSpeed;
             facingRight = true;
         }
 
-        SDL_Rect attackHitbox = {
-            rect.x + (facingRight ? 20 : -20),
-            rect.y,
-            80,
-            100
-        };
-        std::cout << "MiniBoss dash hitbox: x=" << attackHitbox.x << ", y=" << attackHitbox.y << ", w=" << attackHitbox.w << ", h=" << attackHitbox.h << "\n";
-
-        if (SDL_HasIntersection(&attackHitbox, &playerRect)) {
-            std::cout << "MiniBoss dash collides with player\n";
-            if (!player.IsDead() && !player.IsInvulnerable() && !hasDealtDamage) {
-                std::cout << "MiniBoss dashes and hits player!\n";
-                player.TakeDamage(1);
-                hasDealtDamage = true;
-            }
-            isDashing = false;
-            currentAttackFrame = 0;
-            lastAttackTime = SDL_GetTicks();
-            isRetreating = true;
-            retreatStartX = rect.x;
-            std::cout << "MiniBoss dash ends, starting cooldown and retreating from x=" << retreatStartX << "\n";
-        } else if (SDL_GetTicks() - dashStartTime >= DASH_DURATION) {
-            std::cout << "MiniBoss dash timeout\n";
-            isDashing = false;
-            currentAttackFrame = 0;
-            lastAttackTime = SDL_GetTicks();
-            isRetreating = true;
-            retreatStartX = rect.x;
-            std::cout << "MiniBoss dash ends, starting cooldown and retreating from x=" << retreatStartX << "\n";
+        if (Elapsed(dashStartTime, tuning.dashDuration)) {
+            BOSS_LOG("MiniBoss dash timeout\n");
+            EndAttack();
         }
     }
 
     if (isShooting && currentLevel == 2) {
-        if (SDL_GetTicks() - shootStartTime >= 1000) { // Thời gian để quan sát mũi tên
+        if (Elapsed(shootStartTime, tuning.shootDuration)) { // Thời gian để quan sát mũi tên
             isShooting = false;
-            currentAttackFrame = 0;
-            lastAttackTime = SDL_GetTicks();
+            lastAttackTime = world.GetTime();
             isRetreating = true;
             retreatStartX = rect.x;
-            std::cout << "MiniBoss stops shooting, starting cooldown and retreating from x=" << retreatStartX << "\n";
+            BOSS_LOG("MiniBoss stops shooting, starting cooldown and retreating from x=" << retreatStartX << "\n");
         }
     }
 
     // Cập nhật vị trí mũi tên
     for (auto it = arrows.begin(); it != arrows.end();) {
         it->rect.x += it->velocity;
-        std::cout << "Arrow position: x=" << it->rect.x << ", y=" << it->rect.y << "\n";
-        if (it->rect.x < 0 || it->rect.x > SCREEN_WIDTH) {
+        BOSS_LOG("Arrow position: x=" << it->rect.x << ", y=" << it->rect.y << "\n");
+        if (it->rect.x + it->rect.w < 0 || it->rect.x > world.GetLevelWidth()) {
             it = arrows.erase(it);
-            std::cout << "Arrow removed (out of bounds)\n";
+            BOSS_LOG("Arrow removed (left the world)\n");
         } else {
-            if (SDL_HasIntersection(&it->rect, &playerRect)) {
-                if (!player.IsDead() && !player.IsInvulnerable()) {
-                    std::cout << "Arrow hits player!\n";
-                    player.TakeDamage(1);
-                }
-                it = arrows.erase(it);
-                std::cout << "Arrow removed (hit player)\n";
-            } else {
-                ++it;
-            }
+            ++it;
         }
     }
 
-    verticalVelocity += GRAVITY;
-    rect.y += verticalVelocity;
-
-    bool onPlatform = false;
-    for (int i = 0; i < platformCount; ++i) {
-        if (rect.y + rect.h <= platforms[i].y + 20 &&
-            rect.y + rect.h + verticalVelocity >= platforms[i].y &&
-            rect.x + rect.w > platforms[i].x && rect.x < platforms[i].x + platforms[i].w &&
-            verticalVelocity > 0) {
-            rect.y = platforms[i].y - rect.h;
-            verticalVelocity = 0;
-            isOnGround = true;
-            isJumping = false;
-            if (isDiving && currentLevel == 2) {
-                isDiving = false;
-                currentAttackFrame = 0;
-                lastAttackTime = SDL_GetTicks();
-                isRetreating = true;
-                retreatStartX = rect.x;
-                std::cout << "MiniBoss dive ends on platform, starting cooldown and retreating from x=" << retreatStartX << "\n";
-            }
-            onPlatform = true;
-            break;
+    if (isAttacking && animator.GetClip() == &attackClip && animator.IsFinished()) {
+        isAttacking = false;
+        lastAttackTime = world.GetTime();
+        isRetreating = true;
+        retreatStartX = rect.x;
+        BOSS_LOG("MiniBoss stops attacking, starting cooldown and retreating from x=" << retreatStartX << "\n");
+        if (currentLevel == 2 && playerDistance > tuning.idleDistance) {
+            isIdle = true;
+            BOSS_LOG("MiniBoss enters idle state after attack\n");
         }
     }
+}
 
-    if (rect.y + rect.h >= 500 && !onPlatform) {
-        rect.y = 500 - rect.h;
-        verticalVelocity = 0;
-        isJumping = false;
-        if (isDiving && currentLevel == 2) {
-            isDiving = false;
-            currentAttackFrame = 0;
-            lastAttackTime = SDL_GetTicks();
-            isRetreating = true;
-            retreatStartX = rect.x;
-            std::cout << "MiniBoss dive ends on ground, starting cooldown and retreating from x=" << retreatStartX << "\n";
-        }
-        isOnGround = true;
+void MiniBoss::CollectBoxes(HitWorld& hits) {
+    Boss::CollectBoxes(hits);
+    if (isDead) return;
+    for (const Arrow& arrow : arrows) {
+        hits.AddHitBox(arrow.rect, bodyId, TEAM_ENEMY, arrow.attack, BOSS_HIT_DAMAGE);
     }
+}
 
-    if (isAttacking && currentAttackFrame >= attackFrameCount - 1) {
-        isAttacking = false;
-        currentAttackFrame = 0;
-        lastAttackTime = SDL_GetTicks();
-        isRetreating = true;
-        retreatStartX = rect.x;
-        std::cout << "MiniBoss stops attacking, starting cooldown and retreating from x=" << retreatStartX << "\n";
-        if (currentLevel == 2 && distance > IDLE_DISTANCE) {
-            isIdle = true;
-            std::cout << "MiniBoss enters idle state after attack\n";
+void MiniBoss::OnAttackLanded(Uint32 attack) {
+    for (auto it = arrows.begin(); it != arrows.end(); ++it) {
+        if (it->attack == attack) {
+            SDL_Rect tip = {it->rect.x + (it->facingRight ? it->rect.w : 0), it->rect.y, 0, it->rect.h};
+            Emit(EVENT_PROJECTILE_HIT, 0, tip);
+            arrows.erase(it);
+            BOSS_LOG("Arrow removed (hit player)\n");
+            return;
         }
     }
+    Boss::OnAttackLanded(attack);
 }
 
-void MiniBoss::Render(SDL_Renderer* renderer, SDL_Texture* idleTexture, Uint32 currentTime) {
+const AnimationClip* MiniBoss::SelectClip() const {
+    if (isShooting && !isDead && !isTakingDamage && !isDiving) return &shootClip;
+    return Boss::SelectClip();
+}
+
+void MiniBoss::HashState(StateHash& hash) const {
+    Boss::HashState(hash);
+    hash.Add(isShooting);
+    hash.Add(shootStartTime);
+    hash.Add(static_cast<int>(arrows.size()));
+    for (const Arrow& arrow : arrows) {
+        hash.Add(arrow.rect);
+        hash.Add(arrow.velocity);
+        hash.Add(arrow.facingRight);
+        hash.Add(arrow.attack);
+    }
+}
+
+void MiniBoss::Render(RenderList& list) const {
     // Vẽ thanh máu cho MiniBoss
-    RenderHealthBar(renderer);
+    RenderHealthBar(list);
 
-    SDL_Rect srcRect, destRect;
     SDL_RendererFlip flip = facingRight ? SDL_FLIP_NONE : SDL_FLIP_HORIZONTAL;
-
-    if (isDead) {
-        if (currentTime > lastFrameTime + FRAME_DELAY) {
-            lastFrameTime = currentTime;
-            currentDeathFrame++;
-        }
-        srcRect = {currentDeathFrame * deathFrameWidth, 0, deathFrameWidth, deathFrameHeight};
-        destRect = {rect.x + (rect.w - deathFrameWidth) / 2, rect.y + (rect.h - deathFrameHeight), deathFrameWidth, deathFrameHeight};
-        SDL_RenderCopyEx(renderer, deathSheet, &srcRect, &destRect, 0, nullptr, flip);
-    } else if (isTakingDamage) {
-        if (currentTime > lastFrameTime + FRAME_DELAY) {
-            lastFrameTime = currentTime;
-            currentDamageFrame++;
-            if (currentDamageFrame >= damageFrameCount) {
-                isTakingDamage = false;
-                currentDamageFrame = 0;
-            }
-        }
-        srcRect = {currentDamageFrame * damageFrameWidth, 0, damageFrameWidth, deathFrameHeight};
-        destRect = {rect.x + (rect.w - damageFrameWidth) / 2, rect.y + (rect.h - deathFrameHeight), damageFrameWidth, deathFrameHeight};
-        SDL_RenderCopyEx(renderer, damageSheet, &srcRect, &destRect, 0, nullptr, flip);
-    } else if (isDiving) {
-        if (currentTime > lastFrameTime + FRAME_DELAY) {
-            lastFrameTime = currentTime;
-            currentAttackFrame++;
-        }
-        srcRect = {currentAttackFrame * diveFrameWidth, 0, diveFrameWidth, diveFrameHeight};
-        destRect = {rect.x + (rect.w - diveFrameWidth) / 2, rect.y + (rect.h - diveFrameHeight), diveFrameWidth, diveFrameHeight};
-        SDL_RenderCopyEx(renderer, diveSheet, &srcRect, &destRect, 0, nullptr, flip);
-        std::cout << "MiniBoss rendering dive animation: frame " << currentAttackFrame << "\n";
-    } else if (isShooting) {
-        if (currentTime > lastFrameTime + FRAME_DELAY) {
-            lastFrameTime = currentTime;
-            currentAttackFrame = (currentAttackFrame + 1) % shootFrameCount;
-        }
-        srcRect = {currentAttackFrame * shootFrameWidth, 0, shootFrameWidth, shootFrameHeight};
-        destRect = {rect.x + (rect.w - shootFrameWidth) / 2, rect.y + (rect.h - shootFrameHeight), shootFrameWidth, shootFrameHeight};
-        SDL_RenderCopyEx(renderer, shootSheet, &srcRect, &destRect, 0, nullptr, flip);
-        std::cout << "MiniBoss rendering shoot animation: frame " << currentAttackFrame << "\n";
-    } else if (isAttacking || isDashing) {
-        if (currentTime > lastFrameTime + FRAME_DELAY) {
-            lastFrameTime = currentTime;
-            currentAttackFrame++;
-        }
-        srcRect = {currentAttackFrame * attackFrameWidth, 0, attackFrameWidth, attackFrameHeight};
-        destRect = {rect.x + (rect.w - attackFrameWidth) / 2, rect.y + (rect.h - attackFrameHeight), attackFrameWidth, attackFrameHeight};
-        SDL_RenderCopyEx(renderer, attackSheet, &srcRect, &destRect, 0, nullptr, flip);
-        std::cout << "MiniBoss rendering attack/dash animation: frame " << currentAttackFrame << "\n";
-    } else if (isJumping) {
-        if (currentTime > lastFrameTime + FRAME_DELAY) {
-            lastFrameTime = currentTime;
-            currentJumpFrame = (currentJumpFrame + 1) % jumpFrameCount;
-        }
-        srcRect = {currentJumpFrame * jumpFrameWidth, 0, jumpFrameWidth, jumpFrameHeight};
-        destRect = {rect.x + (rect.w - jumpFrameWidth) / 2, rect.y + (rect.h - jumpFrameHeight), jumpFrameWidth, jumpFrameHeight};
-        SDL_RenderCopyEx(renderer, jumpSheet, &srcRect, &destRect, 0, nullptr, flip);
-    } else if (isIdle) {
-        srcRect = {0, 0, runFrameWidth, runFrameHeight};
-        destRect = {rect.x + (rect.w - runFrameWidth) / 2, rect.y + (rect.h - runFrameHeight), runFrameWidth, runFrameHeight};
-        SDL_RenderCopyEx(renderer, miniBossIdle, &srcRect, &destRect, 0, nullptr, flip);
-        std::cout << "MiniBoss rendering idle animation\n";
-    } else if (isRetreating) {
-        if (currentTime > lastFrameTime + FRAME_DELAY) {
-            lastFrameTime = currentTime;
-            currentRunFrame = (currentRunFrame + 1) % runFrameCount;
-        }
-        srcRect = {currentRunFrame * runFrameWidth, 0, runFrameWidth, runFrameHeight};
-        destRect = {rect.x + (rect.w - runFrameWidth) / 2, rect.y + (rect.h - runFrameHeight), runFrameWidth, runFrameHeight};
-        SDL_RenderCopyEx(renderer, runSheet, &srcRect, &destRect, 0, nullptr, flip);
-        std::cout << "MiniBoss rendering retreat animation (using run): frame " << currentRunFrame << "\n";
-    } else {
-        if (currentTime > lastFrameTime + FRAME_DELAY) {
-            lastFrameTime = currentTime;
-            currentRunFrame = (currentRunFrame + 1) % runFrameCount;
-        }
-        srcRect = {currentRunFrame * runFrameWidth, 0, runFrameWidth, runFrameHeight};
-        destRect = {rect.x + (rect.w - runFrameWidth) / 2, rect.y + (rect.h - runFrameHeight), runFrameWidth, runFrameHeight};
-        SDL_RenderCopyEx(renderer, runSheet, &srcRect, &destRect, 0, nullptr, flip);
-    }
+    animator.Draw(list, rect, flip, LAYER_ACTOR);
 
     // Vẽ các mũi tên bay thẳng
     for (const auto& arrow : arrows) {
         SDL_Rect arrowSrcRect = {0, 0, arrow.frameWidth, arrow.frameHeight}; // Lấy toàn bộ texture 64x64
         SDL_Rect arrowDestRect = {arrow.rect.x, arrow.rect.y, arrow.frameWidth, arrow.frameHeight};
         SDL_RendererFlip arrowFlip = arrow.facingRight ? SDL_FLIP_NONE : SDL_FLIP_HORIZONTAL;
-        SDL_RenderCopyEx(renderer, arrowTexture, &arrowSrcRect, &arrowDestRect, 0.0, nullptr, arrowFlip);
-        std::cout << "Rendering flying arrow at x=" << arrowDestRect.x << ", y=" << arrowDestRect.y << ", facingRight=" << arrow.facingRight << "\n";
+        list.AddSprite(arrowSprite, &arrowSrcRect, arrowDestRect, LAYER_PROJECTILE, arrowFlip);
     }
 }
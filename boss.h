@@ -3,8 +3,27 @@
 
 #include <SDL.h>
 #include <vector>
+#include "physics.h"
+#include "animation.h"
+#include "boss_tuning.h"
+#include "hitbox.h"
+#include "event_bus.h"
 
 class Player; // Forward declaration
+class Boss;
+
+// Danh sách phẳng mọi kẻ địch của màn (boss, MiniBoss được triệu hồi, kẻ địch của các wave)
+typedef std::vector<Boss*> EnemyList;
+
+// Loại kẻ địch trong dữ liệu màn: boss của màn 1, boss của màn 2, MiniBoss
+enum EnemyKind {
+    ENEMY_BOSS1 = 1,
+    ENEMY_BOSS2 = 2,
+    ENEMY_MINIBOSS = 3
+};
+
+// Dung lượng mảng mũi tên đặt trước để bắn tên không cấp phát heap giữa trận
+const int ARROW_CAPACITY = 16;
 
 struct Arrow {
     SDL_Rect rect;
@@ -12,20 +31,25 @@ struct Arrow {
     bool facingRight;
     int frameWidth;
     int frameHeight;
-    Arrow(int x, int y, bool facingRight, int fWidth, int fHeight)
+    Uint32 attack; // Mỗi mũi tên là một lần tấn công riêng
+    Arrow(int x, int y, bool facingRight, int fWidth, int fHeight, Uint32 attack)
         : rect{x, y, fWidth, fHeight}, velocity(facingRight ? 12 : -12), facingRight(facingRight),
-          frameWidth(fWidth), frameHeight(fHeight) {}
+          frameWidth(fWidth), frameHeight(fHeight), attack(attack) {}
 };
 
 class Boss {
 protected:
-    SDL_Rect rect;
+    // Thân thể vật lý trong PhysicsWorld
+    PhysicsWorld& world;
+    int bodyId;
+
+    SDL_Rect& rect;
+    int& verticalVelocity;
+    bool& isOnGround;
     int health;
     int maxHealth;
-    int verticalVelocity;
     int horizontalDiveVelocity;
     bool isJumping;
-    bool isOnGround;
     bool facingRight;
     bool isAttacking;
     bool isDashing;
@@ -34,70 +58,83 @@ protected:
     bool isDead;
     bool isIdle;
     bool isRetreating;
-    bool hasDealtDamage;
-    int currentRunFrame;
-    int currentAttackFrame;
-    int currentJumpFrame;
-    int currentDamageFrame;
-    int currentDeathFrame;
     int retreatStartX;
-    Uint32 lastFrameTime;
     Uint32 dashStartTime;
     Uint32 diveStartTime;
     Uint32 lastAttackTime;
+    int playerDistance;       // Khoảng cách ngang tới player ở lần ra quyết định gần nhất
+    Uint32 nextDecisionTime;  // Lần ra quyết định kế tiếp theo đồng hồ game
 
-    SDL_Texture* runSheet;
-    SDL_Texture* attackSheet;
-    SDL_Texture* jumpSheet;
-    SDL_Texture* damageSheet;
-    SDL_Texture* deathSheet;
-    SDL_Texture* diveSheet;
-
-    int runFrameCount;
-    int attackFrameCount;
-    int jumpFrameCount;
-    int damageFrameCount;
-    int deathFrameCount;
-    int diveFrameCount;
-
-    int runFrameWidth;
-    int runFrameHeight;
-    int attackFrameWidth;
-    int attackFrameHeight;
-    int jumpFrameWidth;
-    int jumpFrameHeight;
-    int damageFrameWidth;
-    int damageFrameHeight;
-    int deathFrameWidth;
-    int deathFrameHeight;
-    int diveFrameWidth;
-    int diveFrameHeight;
-
-    static const Uint32 ATTACK_COOLDOWN = 2000;
-    static const Uint32 SHOOT_COOLDOWN = 2000;
-    static const int IDLE_DISTANCE = 600;
-    static const int RETREAT_DISTANCE = 400;
-
-    std::vector<Boss*> miniBosses;
+    // Clip hoạt ảnh
+    AnimationClip idleClip;
+    AnimationClip runClip;
+    AnimationClip attackClip;
+    AnimationClip jumpClip;
+    AnimationClip damageClip;
+    AnimationClip deathClip;
+    AnimationClip diveClip;
+    Animator animator;
+
+    bool canSummon;  // Boss của màn 2 triệu hồi MiniBoss khi máu xuống dưới 40%
     bool hasSummonedMiniBoss;
+    bool isSummoned; // Được boss khác triệu hồi, không tính vào điều kiện qua màn
+
+    BossTuning tuning;       // Thông số cân bằng, MiniBoss nhận bản sao khi được triệu hồi
+    Uint32 rngState;         // Bộ sinh số ngẫu nhiên riêng, an toàn khi cập nhật song song
+    Uint32 attackSerial;     // Lần tấn công hiện tại (cú lướt, cú bổ nhào, mũi tên), tăng khi bắt đầu đòn mới
+    EventBus* events;        // nullptr: không phát sự kiện; Publish an toàn khi cập nhật song song
+
+    int NextRandom(int range);
+    bool Elapsed(Uint32 since, int duration) const; // Đã qua ít nhất duration ms kể từ since (theo đồng hồ game)
+    // AI chỉ ra quyết định (đo khoảng cách, rời trạng thái nghỉ, chọn đòn) mỗi decisionInterval ms;
+    // di chuyển và bộ hẹn giờ của đòn đang đánh vẫn chạy mỗi tick. Mỗi boss lệch pha theo bodyId
+    // để các lần ra quyết định rải đều qua các tick thay vì dồn vào cùng một tick.
+    void ScheduleDecisions();
+    bool DecisionDue();
 
-    void RenderHealthBar(SDL_Renderer* renderer); // Phương thức vẽ thanh máu
+    void EndAttack(); // Kết thúc cú lướt/bổ nhào, bắt đầu hồi chiêu và lùi lại
+    void Emit(int type, int amount = 0);
+    void Emit(int type, int amount, const SDL_Rect& where); // Vị trí sự kiện khác tâm thân (chân, đầu mũi tên)
+    void RenderHealthBar(RenderList& list) const; // Phương thức vẽ thanh máu
+    virtual const AnimationClip* SelectClip() const; // Clip ứng với trạng thái hiện tại
 
 public:
-    Boss(int x, int y,
-         SDL_Texture* run, int runCount, int runWidth, int runHeight,
-         SDL_Texture* attack, int attackCount, int attackWidth, int attackHeight,
-         SDL_Texture* jump, int jumpCount, int jumpWidth, int jumpHeight,
-         SDL_Texture* damage, int damageCount, int damageWidth, int damageHeight,
-         SDL_Texture* death, int deathCount, int deathWidth, int deathHeight,
-         SDL_Texture* dive, int diveCount, int diveWidth, int diveHeight);
+    Boss(PhysicsWorld& world, int x, int y, int idle,
+         int run, int runCount, int runWidth, int runHeight,
+         int attack, int attackCount, int attackWidth, int attackHeight,
+         int jump, int jumpCount, int jumpWidth, int jumpHeight,
+         int damage, int damageCount, int damageWidth, int damageHeight,
+         int death, int deathCount, int deathWidth, int deathHeight,
+         int dive, int diveCount, int diveWidth, int diveHeight);
     virtual ~Boss();
-    virtual void Update(const SDL_Rect& playerRect, SDL_Rect* platforms, int platformCount, int currentLevel, Player& player);
-    virtual void Render(SDL_Renderer* renderer, SDL_Texture* idleTexture, Uint32 currentTime);
+    // Quyết định AI và di chuyển của riêng đối tượng này; chỉ đọc player nên các boss
+    // có thể cập nhật song song
+    virtual void Update(const SDL_Rect& playerRect, int currentLevel, const Player& player);
+    // Triệu hồi MiniBoss, chạy tuần tự sau pha song song; trả về kẻ địch mới (người gọi sở hữu) hoặc nullptr
+    Boss* UpdateSummons(int currentLevel);
+    // Thêm hộp đánh/hộp nhận đòn của khung hiện tại vào lượt kiểm tra va chạm của tick
+    virtual void CollectBoxes(HitWorld& hits);
+    // Lần tấn công attack vừa trúng mục tiêu
+    virtual void OnAttackLanded(Uint32 attack);
+    virtual int GetProjectileCount() const { return 0; }
+    void SetTuning(const BossTuning& value);
+    void SetEventBus(EventBus* bus); // MiniBoss được triệu hồi sau này dùng chung bus
+    const BossTuning& GetTuning() const { return tuning; }
+    void SeedRandom(Uint32 seed);
+    void ResolveContacts(); // Xử lý kết quả va chạm sau PhysicsWorld::Step
+    void Animate(Uint32 dt); // Tiến hoạt ảnh theo thời gian game trong pha cập nhật
+    virtual void Render(RenderList& list) const;
+    // Đưa trạng thái mô phỏng (vị trí, máu, cờ trạng thái, hẹn giờ, RNG) vào mã băm của tick
+    virtual void HashState(StateHash& hash) const;
     void ReduceHealth(int amount);
-    void SetDealtDamage(bool value) { hasDealtDamage = value; }
-    bool HasDealtDamage() const { return hasDealtDamage; }
+    int GetBodyId() const { return bodyId; }
     SDL_Rect& GetRect() { return rect; }
+    const SDL_Rect& GetRect() const { return rect; }
+    bool IsDead() const { return isDead; }
+    // Đã chết và hoạt ảnh chết đã xong: có thể xóa khỏi màn
+    bool IsRemovable() const { return isDead && animator.GetClip() == &deathClip && animator.IsFinished(); }
+    bool IsSummoned() const { return isSummoned; }
+    void SetCanSummon(bool value) { canSummon = value; }
     int GetHealth() const { return health; }
     int GetMaxHealth() const { return maxHealth; }
     bool IsAttacking() const { return isAttacking; }
@@ -110,24 +147,30 @@ private:
     bool isShooting;
     Uint32 shootStartTime;
     std::vector<Arrow> arrows;
-    SDL_Texture* arrowTexture;
-    SDL_Texture* shootSheet;
-    int shootFrameCount;
-    int shootFrameWidth;
-    int shootFrameHeight;
+    int arrowSprite;
+    AnimationClip shootClip;
+
+    const AnimationClip* SelectClip() const override;
 
 public:
-    MiniBoss(int x, int y,
-             SDL_Texture* run, int runCount, int runWidth, int runHeight,
-             SDL_Texture* attack, int attackCount, int attackWidth, int attackHeight,
-             SDL_Texture* jump, int jumpCount, int jumpWidth, int jumpHeight,
-             SDL_Texture* damage, int damageCount, int damageWidth, int damageHeight,
-             SDL_Texture* death, int deathCount, int deathWidth, int deathHeight,
-             SDL_Texture* dive, int diveCount, int diveWidth, int diveHeight,
-             SDL_Texture* shoot, int shootCount, int shootWidth, int shootHeight,
-             SDL_Texture* arrow, int arrowWidth, int arrowHeight);
-    void Update(const SDL_Rect& playerRect, SDL_Rect* platforms, int platformCount, int currentLevel, Player& player) override;
-    void Render(SDL_Renderer* renderer, SDL_Texture* idleTexture, Uint32 currentTime) override;
+    MiniBoss(PhysicsWorld& world, int x, int y, int idle,
+             int run, int runCount, int runWidth, int runHeight,
+             int attack, int attackCount, int attackWidth, int attackHeight,
+             int jump, int jumpCount, int jumpWidth, int jumpHeight,
+             int damage, int damageCount, int damageWidth, int damageHeight,
+             int death, int deathCount, int deathWidth, int deathHeight,
+             int dive, int diveCount, int diveWidth, int diveHeight,
+             int shoot, int shootCount, int shootWidth, int shootHeight,
+             int arrow, int arrowWidth, int arrowHeight);
+    void Update(const SDL_Rect& playerRect, int currentLevel, const Player& player) override;
+    void CollectBoxes(HitWorld& hits) override;
+    void OnAttackLanded(Uint32 attack) override;
+    int GetProjectileCount() const override { return static_cast<int>(arrows.size()); }
+    void Render(RenderList& list) const override;
+    void HashState(StateHash& hash) const override;
 };
 
+// Tạo kẻ địch loại kind (EnemyKind) tại (x, y); nullptr nếu PhysicsWorld đã hết thân vật lý
+Boss* CreateEnemy(PhysicsWorld& world, int kind, int x, int y);
+
 #endif
@@ -0,0 +1,102 @@
+#include "boss_tuning.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+BossTuning MakeDefaultBossTuning() {
+    BossTuning tuning;
+    tuning.bossSpeed = 3;
+    tuning.dashSpeed = 8;
+    tuning.diveSpeedVertical = 8;
+    tuning.diveSpeedHorizontal = 14;
+    tuning.dashDuration = 1000;
+    tuning.diveDuration = 2500;
+    tuning.shootDuration = 1000;
+    tuning.attackCooldown = 2000;
+    tuning.shootCooldown = 2000;
+    tuning.minDistance = 400;
+    tuning.maxDistance = 1000;
+    tuning.retreatDistance = 400;
+    tuning.idleDistance = 600;
+    tuning.decisionInterval = 100;
+    tuning.dashChance = 30;
+    tuning.jumpDiveChance = 60;
+    tuning.farDashChance = 40;
+    tuning.farJumpChance = 70;
+    tuning.miniShootChance = 70;
+    tuning.miniDashChance = 80;
+    tuning.miniJumpDiveChance = 90;
+    return tuning;
+}
+
+static const BossTuningField BOSS_TUNING_FIELDS[] = {
+    {"boss_speed", &BossTuning::bossSpeed},
+    {"dash_speed", &BossTuning::dashSpeed},
+    {"dive_speed_vertical", &BossTuning::diveSpeedVertical},
+    {"dive_speed_horizontal", &BossTuning::diveSpeedHorizontal},
+    {"dash_duration", &BossTuning::dashDuration},
+    {"dive_duration", &BossTuning::diveDuration},
+    {"shoot_duration", &BossTuning::shootDuration},
+    {"attack_cooldown", &BossTuning::attackCooldown},
+    {"shoot_cooldown", &BossTuning::shootCooldown},
+    {"min_distance", &BossTuning::minDistance},
+    {"max_distance", &BossTuning::maxDistance},
+    {"retreat_distance", &BossTuning::retreatDistance},
+    {"idle_distance", &BossTuning::idleDistance},
+    {"decision_interval", &BossTuning::decisionInterval},
+    {"dash_chance", &BossTuning::dashChance},
+    {"jump_dive_chance", &BossTuning::jumpDiveChance},
+    {"far_dash_chance", &BossTuning::farDashChance},
+    {"far_jump_chance", &BossTuning::farJumpChance},
+    {"mini_shoot_chance", &BossTuning::miniShootChance},
+    {"mini_dash_chance", &BossTuning::miniDashChance},
+    {"mini_jump_dive_chance", &BossTuning::miniJumpDiveChance}
+};
+
+const BossTuningField* GetBossTuningFields(int& count) {
+    count = static_cast<int>(sizeof(BOSS_TUNING_FIELDS) / sizeof(BOSS_TUNING_FIELDS[0]));
+    return BOSS_TUNING_FIELDS;
+}
+
+const BossTuningField* FindBossTuningField(const char* name) {
+    int count;
+    const BossTuningField* fields = GetBossTuningFields(count);
+    for (int i = 0; i < count; ++i) {
+        if (std::strcmp(fields[i].name, name) == 0) return &fields[i];
+    }
+    return nullptr;
+}
+
+bool LoadBossTuning(const std::string& path, BossTuning& tuning) {
+    std::ifstream file(path.c_str());
+    if (!file) {
+        std::cout << "Boss tuning error: cannot open " << path << "\n";
+        return false;
+    }
+
+    BossTuning loaded = tuning;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        std::istringstream in(line);
+        std::string name;
+        if (!(in >> name) || name[0] == '#') continue;
+
+        const BossTuningField* field = FindBossTuningField(name.c_str());
+        int value;
+        if (!field) {
+            std::cout << "Boss tuning error: unknown parameter '" << name << "' (" << path << ":" << lineNumber << ")\n";
+            return false;
+        }
+        if (!(in >> value)) {
+            std::cout << "Boss tuning error: bad value for '" << name << "' (" << path << ":" << lineNumber << ")\n";
+            return false;
+        }
+        loaded.*(field->value) = value;
+    }
+
+    tuning = loaded;
+    return true;
+}
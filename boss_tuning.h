@@ -0,0 +1,55 @@
+#ifndef BOSS_TUNING_H
+#define BOSS_TUNING_H
+
+#include <string>
+
+// File thông số boss của game, sửa trong lúc chơi sẽ được nạp lại ngay
+const char* const BOSS_TUNING_PATH = "assets/boss_tuning.txt";
+
+// Thông số cân bằng độ khó của boss. Thời gian tính bằng ms, tốc độ bằng pixel mỗi tick,
+// các ngưỡng *Chance là ngưỡng cộng dồn trên thang 100 của lựa chọn hành động ngẫu nhiên.
+struct BossTuning {
+    int bossSpeed;
+    int dashSpeed;
+    int diveSpeedVertical;
+    int diveSpeedHorizontal;
+    int dashDuration;
+    int diveDuration;
+    int shootDuration;
+    int attackCooldown;
+    int shootCooldown;
+    int minDistance;      // Khoảng cách tối thiểu để dùng đòn tầm xa
+    int maxDistance;      // Khoảng cách tối đa
+    int retreatDistance;
+    int idleDistance;
+    int decisionInterval; // Chu kỳ ra quyết định của AI; 0: mỗi tick
+
+    // Boss: trong tầm [minDistance, maxDistance]
+    int dashChance;       // action < dashChance: lướt
+    int jumpDiveChance;   // action < jumpDiveChance: nhảy rồi bổ nhào
+    // Boss và MiniBoss: ngoài tầm
+    int farDashChance;
+    int farJumpChance;
+    // MiniBoss: trong tầm
+    int miniShootChance;
+    int miniDashChance;
+    int miniJumpDiveChance;
+};
+
+// Một trường của BossTuning theo tên, dùng để đọc tham số từ dòng lệnh hoặc file
+struct BossTuningField {
+    const char* name;
+    int BossTuning::* value;
+};
+
+// Thông số gốc của game
+BossTuning MakeDefaultBossTuning();
+// Bảng mọi trường của BossTuning; count nhận số phần tử
+const BossTuningField* GetBossTuningFields(int& count);
+// Tìm trường theo tên, trả về nullptr nếu không có
+const BossTuningField* FindBossTuningField(const char* name);
+// Đọc file dạng "<tên> <giá trị>" mỗi dòng, '#' mở đầu chú thích. Chỉ ghi đè các trường có trong file;
+// trả về false và giữ nguyên tuning nếu file không mở được hoặc có dòng lỗi
+bool LoadBossTuning(const std::string& path, BossTuning& tuning);
+
+#endif
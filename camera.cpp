@@ -0,0 +1,56 @@
+#include "camera.h"
+#include <cstdlib>
+
+// Mỗi tick camera đi được 1/CAMERA_FOLLOW_DIVISOR khoảng cách còn lại tới mục tiêu
+const int CAMERA_FOLLOW_DIVISOR = 8;
+
+// Bước đi của camera trong một tick; phần dư nhỏ hơn CAMERA_FOLLOW_DIVISOR bị phép chia nguyên
+// làm tròn về 0 nên được đi hết luôn, nếu không camera sẽ đứng lệch mục tiêu vài pixel mãi mãi
+static int FollowStep(int delta) {
+    if (std::abs(delta) < CAMERA_FOLLOW_DIVISOR) return delta;
+    return delta / CAMERA_FOLLOW_DIVISOR;
+}
+
+Camera::Camera(int viewWidth, int viewHeight)
+    : view{0, 0, viewWidth, viewHeight}, worldWidth(viewWidth), worldHeight(viewHeight) {}
+
+void Camera::SetWorldSize(int width, int height) {
+    worldWidth = width;
+    worldHeight = height;
+    ClampToWorld();
+}
+
+void Camera::ClampToWorld() {
+    if (view.x > worldWidth - view.w) view.x = worldWidth - view.w;
+    if (view.y > worldHeight - view.h) view.y = worldHeight - view.h;
+    if (view.x < 0) view.x = 0;
+    if (view.y < 0) view.y = 0;
+}
+
+void Camera::Snap(const SDL_Rect& target) {
+    view.x = target.x + target.w / 2 - view.w / 2;
+    view.y = target.y + target.h / 2 - view.h / 2;
+    ClampToWorld();
+}
+
+void Camera::Follow(const SDL_Rect& target) {
+    int desiredX = target.x + target.w / 2 - view.w / 2;
+    int desiredY = target.y + target.h / 2 - view.h / 2;
+    view.x += FollowStep(desiredX - view.x);
+    view.y += FollowStep(desiredY - view.y);
+    ClampToWorld();
+}
+
+SDL_Rect Camera::WorldToScreen(const SDL_Rect& rect) const {
+    SDL_Rect screen = {rect.x - view.x, rect.y - view.y, rect.w, rect.h};
+    return screen;
+}
+
+SDL_Point Camera::ScreenToWorld(int x, int y) const {
+    SDL_Point world = {x + view.x, y + view.y};
+    return world;
+}
+
+bool Camera::IsVisible(const SDL_Rect& rect) const {
+    return SDL_HasIntersection(&rect, &view) == SDL_TRUE;
+}
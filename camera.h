@@ -0,0 +1,30 @@
+#ifndef CAMERA_H
+#define CAMERA_H
+
+#include <SDL.h>
+
+// Camera 2D: một khung nhìn kích thước màn hình di chuyển trong thế giới, bám theo mục tiêu
+// và không ra ngoài biên của màn chơi
+class Camera {
+private:
+    SDL_Rect view;   // Vùng thế giới đang nhìn thấy
+    int worldWidth;
+    int worldHeight;
+
+    void ClampToWorld();
+
+public:
+    Camera(int viewWidth, int viewHeight);
+    void SetWorldSize(int width, int height);
+    // Đặt tâm khung nhìn ngay vào mục tiêu (khi vào màn)
+    void Snap(const SDL_Rect& target);
+    // Tiến dần về mục tiêu mỗi tick để chuyển động mượt
+    void Follow(const SDL_Rect& target);
+
+    const SDL_Rect& GetView() const { return view; }
+    SDL_Rect WorldToScreen(const SDL_Rect& rect) const;
+    SDL_Point ScreenToWorld(int x, int y) const;
+    bool IsVisible(const SDL_Rect& rect) const;
+};
+
+#endif
@@ -0,0 +1,32 @@
+#include "combat.h"
+#include "boss.h"
+#include "player.h"
+#include <SDL.h>
+#include <iostream>
+
+#ifdef BOSS_DEBUG_LOG
+#define COMBAT_LOG(message) (std::cout << message)
+#else
+#define COMBAT_LOG(message) ((void)0)
+#endif
+
+void ResolveCombat(Player& player, Encounter& encounter, HitWorld& hits) {
+    hits.Begin();
+    player.CollectBoxes(hits);
+    for (Boss* enemy : encounter.GetEnemies()) {
+        enemy->CollectBoxes(hits);
+    }
+
+    for (const HitEvent& hit : hits.Resolve()) {
+        if (hit.target == player.GetBodyId()) {
+            COMBAT_LOG("Boss hits player!\n");
+            player.TakeDamage(hit.damage); // Bỏ qua khi player đang miễn nhiễm
+        } else if (Boss* target = encounter.FindByBody(hit.target)) {
+            COMBAT_LOG("Player attacks boss!\n");
+            target->ReduceHealth(hit.damage);
+        }
+        if (Boss* attacker = encounter.FindByBody(hit.attacker)) {
+            attacker->OnAttackLanded(hit.attack);
+        }
+    }
+}
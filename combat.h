@@ -0,0 +1,14 @@
+#ifndef COMBAT_H
+#define COMBAT_H
+
+#include "encounter.h"
+#include "hitbox.h"
+
+class Player;
+
+// Luật giao tranh chạy tuần tự sau pha cập nhật và vật lý của một tick:
+// gom hộp đánh/hộp nhận đòn của player và mọi kẻ địch vào hits, kiểm tra chồng lấn trong
+// một lượt rồi áp dụng các đòn trúng. Dùng chung cho game và bộ mô phỏng cân bằng.
+void ResolveCombat(Player& player, Encounter& encounter, HitWorld& hits);
+
+#endif
@@ -0,0 +1,133 @@
+#include "encounter.h"
+#include <iostream>
+
+static Uint32 NextSeed(Uint32& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+Encounter::Encounter(PhysicsWorld& world)
+    : world(world), bodyLookup(MAX_BODIES, nullptr), level(nullptr), tuning(MakeDefaultBossTuning()),
+      events(nullptr), rngState(1), nextWave(0), waveTimer(0) {
+    enemies.reserve(MAX_ENEMIES);
+}
+
+Encounter::~Encounter() {
+    Clear();
+}
+
+void Encounter::Add(Boss* enemy, Uint32 seed) {
+    if (!enemy) return;
+    enemy->SetTuning(tuning);
+    enemy->SetEventBus(events);
+    enemy->SeedRandom(seed);
+    enemies.push_back(enemy);
+    bodyLookup[enemy->GetBodyId()] = enemy;
+}
+
+void Encounter::Start(const Level& value, const BossTuning& tuningValue, EventBus* bus, Uint32 seed) {
+    Clear();
+    level = &value;
+    tuning = tuningValue;
+    events = bus;
+    rngState = seed ? seed : 1;
+
+    bool first = true;
+    for (const BossPlacement& placement : level->bosses) {
+        if (!world.HasFreeBody()) break;
+        Add(CreateEnemy(world, placement.kind, placement.x, placement.y), first ? seed : NextSeed(rngState));
+        first = false;
+    }
+}
+
+void Encounter::SetTuning(const BossTuning& value) {
+    tuning = value;
+    for (Boss* enemy : enemies) {
+        enemy->SetTuning(value);
+    }
+}
+
+void Encounter::SpawnWave(const WavePlacement& wave) {
+    int spawned = 0;
+    for (int i = 0; i < wave.count && world.HasFreeBody(); ++i) {
+        Add(CreateEnemy(world, wave.kind, wave.x + i * wave.spacing, wave.y), NextSeed(rngState));
+        spawned++;
+    }
+    std::cout << "Wave " << nextWave + 1 << ": " << spawned << " enemies, " << enemies.size() << " total\n";
+}
+
+bool Encounter::HasLivingEnemies() const {
+    for (const Boss* enemy : enemies) {
+        if (!enemy->IsDead() && !enemy->IsSummoned()) return true;
+    }
+    return false;
+}
+
+void Encounter::Update(Uint32 dt, int currentLevel) {
+    // Triệu hồi thêm vào cuối mảng; chỉ duyệt các kẻ địch có từ đầu tick
+    size_t count = enemies.size();
+    for (size_t i = 0; i < count; ++i) {
+        if (Boss* summoned = enemies[i]->UpdateSummons(currentLevel)) {
+            enemies.push_back(summoned);
+            bodyLookup[summoned->GetBodyId()] = summoned;
+        }
+    }
+
+    // Xóa kẻ địch đã chết xong hoạt ảnh, đổi chỗ với phần tử cuối để mảng luôn liền nhau
+    for (size_t i = 0; i < enemies.size();) {
+        Boss* enemy = enemies[i];
+        if (!enemy->IsRemovable()) {
+            ++i;
+            continue;
+        }
+        bodyLookup[enemy->GetBodyId()] = nullptr;
+        delete enemy;
+        enemies[i] = enemies.back();
+        enemies.pop_back();
+    }
+
+    if (!level || nextWave >= level->waves.size()) return;
+    if (HasLivingEnemies()) {
+        waveTimer = 0;
+        return;
+    }
+    waveTimer += dt;
+    if (waveTimer >= level->waves[nextWave].delay) {
+        SpawnWave(level->waves[nextWave]);
+        nextWave++;
+        waveTimer = 0;
+    }
+}
+
+void Encounter::Clear() {
+    for (Boss* enemy : enemies) {
+        bodyLookup[enemy->GetBodyId()] = nullptr;
+        delete enemy;
+    }
+    enemies.clear();
+    level = nullptr;
+    nextWave = 0;
+    waveTimer = 0;
+}
+
+Boss* Encounter::FindByBody(int bodyId) const {
+    if (bodyId < 0 || bodyId >= MAX_BODIES) return nullptr;
+    return bodyLookup[bodyId];
+}
+
+bool Encounter::IsCleared() const {
+    if (level && nextWave < level->waves.size()) return false;
+    return !HasLivingEnemies();
+}
+
+void Encounter::HashState(StateHash& hash) const {
+    hash.Add(rngState);
+    hash.Add(static_cast<Uint32>(nextWave));
+    hash.Add(waveTimer);
+    hash.Add(static_cast<int>(enemies.size()));
+    for (const Boss* enemy : enemies) {
+        enemy->HashState(hash);
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef ENCOUNTER_H
+#define ENCOUNTER_H
+
+#include <SDL.h>
+#include <vector>
+#include "boss.h"
+#include "boss_tuning.h"
+#include "event_bus.h"
+#include "level.h"
+#include "physics.h"
+
+// Dung lượng đặt trước của danh sách kẻ địch; vượt quá vẫn chạy nhưng phải cấp phát lại
+const int MAX_ENEMIES = 512;
+
+// Mọi kẻ địch của một trận: boss đặt sẵn trong màn, MiniBoss được triệu hồi và các wave.
+// Kẻ địch nằm trong một mảng phẳng liền nhau để AI, vật lý, giao tranh, hoạt ảnh và vẽ
+// cùng duyệt một lượt; kẻ địch chết xong hoạt ảnh bị xóa bằng cách đổi chỗ với phần tử cuối.
+class Encounter {
+private:
+    PhysicsWorld& world;
+    EnemyList enemies;
+    std::vector<Boss*> bodyLookup; // bodyId -> kẻ địch, kích thước MAX_BODIES
+    const Level* level;
+    BossTuning tuning;
+    EventBus* events;
+    Uint32 rngState;    // Sinh seed cho kẻ địch của các wave
+    size_t nextWave;
+    Uint32 waveTimer;   // Thời gian game từ khi bãi đấu trống
+
+    void Add(Boss* enemy, Uint32 seed);
+    void SpawnWave(const WavePlacement& wave);
+    bool HasLivingEnemies() const; // Không tính MiniBoss được triệu hồi
+
+public:
+    explicit Encounter(PhysicsWorld& world);
+    ~Encounter();
+
+    // Đặt các boss của màn; enemy đầu tiên nhận đúng seed, các enemy sau nhận seed suy ra từ nó
+    void Start(const Level& level, const BossTuning& tuning, EventBus* events, Uint32 seed);
+    void SetTuning(const BossTuning& value);
+    // Chạy tuần tự sau ResolveCombat: triệu hồi, mở wave kế tiếp, xóa kẻ địch đã chết hẳn
+    void Update(Uint32 dt, int currentLevel);
+    void Clear();
+
+    EnemyList& GetEnemies() { return enemies; }
+    const EnemyList& GetEnemies() const { return enemies; }
+    Boss* FindByBody(int bodyId) const;
+    // Mọi boss và wave đã bị hạ; MiniBoss được triệu hồi không cần hạ
+    bool IsCleared() const;
+    // Tiến độ wave, RNG sinh seed và mọi kẻ địch theo thứ tự trong mảng
+    void HashState(StateHash& hash) const;
+};
+
+#endif
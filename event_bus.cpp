@@ -0,0 +1,94 @@
+#include "event_bus.h"
+#include <algorithm>
+#include <iostream>
+
+EventBus::EventBus()
+    : writeCount(0), writeBuffer(0), droppedCount(0), subscriberCount(0), dispatching(false), pendingRemovals(false) {}
+
+bool EventBus::Subscribe(Uint32 mask, GameEventHandler handler, void* context) {
+    if (subscriberCount >= MAX_EVENT_SUBSCRIBERS) {
+        std::cout << "EventBus error: too many subscribers\n";
+        return false;
+    }
+    Subscriber& subscriber = subscribers[subscriberCount++];
+    subscriber.mask = mask;
+    subscriber.handler = handler;
+    subscriber.context = context;
+    return true;
+}
+
+void EventBus::Unsubscribe(GameEventHandler handler, void* context) {
+    for (int i = 0; i < subscriberCount; ++i) {
+        if (subscribers[i].handler == handler && subscribers[i].context == context) {
+            // Đánh dấu gỡ; trong lúc Dispatch đang duyệt mảng thì không dịch chuyển phần tử
+            subscribers[i].handler = nullptr;
+            pendingRemovals = true;
+            if (!dispatching) RemoveUnsubscribed();
+            return;
+        }
+    }
+}
+
+void EventBus::RemoveUnsubscribed() {
+    // Giữ thứ tự giao cho các subscriber còn lại
+    int kept = 0;
+    for (int i = 0; i < subscriberCount; ++i) {
+        if (subscribers[i].handler) subscribers[kept++] = subscribers[i];
+    }
+    subscriberCount = kept;
+    pendingRemovals = false;
+}
+
+void EventBus::Publish(const GameEvent& event) {
+    // Giữ chỗ bằng một phép cộng nguyên tử, mỗi luồng ghi vào ô riêng
+    int index = writeCount.fetch_add(1, std::memory_order_relaxed);
+    if (index < EVENT_QUEUE_CAPACITY) {
+        GameEvent& slot = buffers[writeBuffer][index];
+        slot = event;
+        slot.sequence = index;
+    }
+}
+
+void EventBus::Publish(int type, int entity, int team, int amount, const SDL_Rect& where) {
+    GameEvent event = {type, entity, team, amount, where.x + where.w / 2, where.y + where.h / 2, 0};
+    Publish(event);
+}
+
+// Thứ tự giữa các đối tượng do entity quyết định; trong một đối tượng, sequence giữ thứ tự phát
+// vốn đã tất định vì đối tượng chỉ phát từ một luồng tại một thời điểm
+static bool CompareEventOrder(const GameEvent& a, const GameEvent& b) {
+    if (a.entity != b.entity) return a.entity < b.entity;
+    return a.sequence < b.sequence;
+}
+
+void EventBus::Dispatch() {
+    // Gọi từ luồng mô phỏng sau khi mọi job của tick đã xong
+    int count = writeCount.load(std::memory_order_relaxed);
+    if (count > EVENT_QUEUE_CAPACITY) {
+        droppedCount += count - EVENT_QUEUE_CAPACITY;
+        count = EVENT_QUEUE_CAPACITY;
+    }
+    GameEvent* events = buffers[writeBuffer];
+    writeBuffer = 1 - writeBuffer;
+    writeCount.store(0, std::memory_order_relaxed);
+    if (count == 0) return;
+
+    // Khóa (entity, sequence) không trùng nhau nên std::sort cho kết quả duy nhất, không cần bộ đệm tạm
+    std::sort(events, events + count, CompareEventOrder);
+
+    Uint32 present = 0;
+    for (int i = 0; i < count; ++i) {
+        present |= EventBit(events[i].type);
+    }
+    // Subscriber đăng ký trong lúc giao bắt đầu nhận từ lô sau
+    dispatching = true;
+    int dispatchCount = subscriberCount;
+    for (int i = 0; i < dispatchCount; ++i) {
+        const Subscriber& subscriber = subscribers[i];
+        if (subscriber.handler && (subscriber.mask & present)) {
+            subscriber.handler(subscriber.context, events, count);
+        }
+    }
+    dispatching = false;
+    if (pendingRemovals) RemoveUnsubscribed();
+}
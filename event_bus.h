@@ -0,0 +1,91 @@
+#ifndef EVENT_BUS_H
+#define EVENT_BUS_H
+
+#include <SDL.h>
+#include <atomic>
+
+// Loại sự kiện gameplay
+enum GameEventType {
+    EVENT_DAMAGED = 0,      // amount: máu còn lại
+    EVENT_DIED,
+    EVENT_ATTACK_STARTED,   // amount: AttackKind
+    EVENT_PROJECTILE_FIRED,
+    EVENT_LEVEL_COMPLETED,  // amount: màn vừa xong
+    EVENT_GAME_COMPLETED,
+    EVENT_LANDED,           // Tiếp đất sau cú bổ nhào; vị trí là chân đối tượng
+    EVENT_PROJECTILE_HIT,   // Vị trí là đầu mũi tên
+    EVENT_TYPE_COUNT
+};
+
+// Loại đòn trong EVENT_ATTACK_STARTED
+enum AttackKind {
+    ATTACK_SLASH = 0,
+    ATTACK_DASH,
+    ATTACK_DIVE,
+    ATTACK_SHOOT
+};
+
+inline Uint32 EventBit(int type) { return 1u << type; }
+
+// Sự kiện là giá trị thuần, chép thẳng vào hàng đợi
+struct GameEvent {
+    int type;
+    int entity; // bodyId của đối tượng phát sự kiện, -1 nếu không gắn với đối tượng nào
+    int team;   // HitTeam của đối tượng
+    int amount;
+    int x;      // Vị trí trong thế giới (tâm đối tượng)
+    int y;
+    int sequence; // Thứ tự phát trong tick, do EventBus gán
+};
+
+// Số sự kiện tối đa của một tick; vượt quá thì bị bỏ và được đếm lại
+const int EVENT_QUEUE_CAPACITY = 256;
+const int MAX_EVENT_SUBSCRIBERS = 16;
+
+// Nhận toàn bộ sự kiện của một tick trong một lần gọi
+typedef void (*GameEventHandler)(void* context, const GameEvent* events, int count);
+
+// Hàng đợi sự kiện hai bộ đệm: trong tick, gameplay ghi vào một bộ đệm (an toàn khi các boss
+// cập nhật song song); Dispatch() ở cuối tick đổi bộ đệm, sắp lô theo (entity, sequence) rồi giao
+// cả lô cho từng subscriber. Mỗi đối tượng chỉ phát sự kiện từ một luồng tại một thời điểm nên thứ tự
+// sau khi sắp không phụ thuộc cách các job được lập lịch, và hạt/ảnh chụp vẫn lặp lại được.
+// Sự kiện phát ra trong lúc giao sẽ thuộc về tick sau. Không cấp phát heap.
+class EventBus {
+private:
+    struct Subscriber {
+        Uint32 mask;
+        GameEventHandler handler;
+        void* context;
+    };
+
+    GameEvent buffers[2][EVENT_QUEUE_CAPACITY];
+    std::atomic<int> writeCount;
+    int writeBuffer;
+    int droppedCount;
+    Subscriber subscribers[MAX_EVENT_SUBSCRIBERS];
+    int subscriberCount;
+    bool dispatching;      // Đang giao lô: Unsubscribe chỉ đánh dấu, Dispatch gỡ sau khi giao xong
+    bool pendingRemovals;
+
+    void RemoveUnsubscribed();
+
+public:
+    EventBus();
+    EventBus(const EventBus&) = delete;
+    EventBus& operator=(const EventBus&) = delete;
+
+    // Đăng ký handler cho các loại trong mask (tổ hợp EventBit); false nếu đã đủ subscriber
+    bool Subscribe(Uint32 mask, GameEventHandler handler, void* context);
+    // Gỡ subscriber đã đăng ký với cùng handler và context; gọi từ trong handler thì subscriber
+    // không nhận thêm sự kiện nào nữa và được gỡ khi lô giao xong
+    void Unsubscribe(GameEventHandler handler, void* context);
+    // Có thể gọi từ nhiều luồng cùng lúc
+    void Publish(const GameEvent& event);
+    void Publish(int type, int entity, int team, int amount, const SDL_Rect& where);
+    // Giao các sự kiện của tick vừa xong; subscriber chỉ được gọi khi lô có loại nó quan tâm
+    void Dispatch();
+
+    int GetDroppedCount() const { return droppedCount; }
+};
+
+#endif
@@ -0,0 +1,82 @@
+#include "file_watcher.h"
+#include <algorithm>
+#include <iostream>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+#ifdef __linux__
+
+FileWatcher::FileWatcher() : fd(inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) {
+    if (fd < 0) {
+        std::cout << "FileWatcher: inotify_init1 failed: " << std::strerror(errno) << "\n";
+    }
+}
+
+FileWatcher::~FileWatcher() {
+    if (fd >= 0) close(fd);
+}
+
+bool FileWatcher::WatchDirectory(const std::string& directory) {
+    if (fd < 0) return false;
+    if (std::find(directories.begin(), directories.end(), directory) != directories.end()) return true;
+
+    // Chỉ quan tâm file đã đóng sau khi ghi hoặc được đổi tên tới (trình sửa ảnh thường lưu ra file tạm rồi đổi tên)
+    int watch = inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (watch < 0) {
+        std::cout << "FileWatcher: cannot watch " << directory << ": " << std::strerror(errno) << "\n";
+        return false;
+    }
+    watches.push_back(watch);
+    directories.push_back(directory);
+    return true;
+}
+
+int FileWatcher::Poll(std::vector<std::string>& changedPaths) {
+    if (fd < 0) return 0;
+
+    int added = 0;
+    alignas(inotify_event) char buffer[4096];
+    while (true) {
+        ssize_t length = read(fd, buffer, sizeof(buffer));
+        if (length <= 0) break; // EAGAIN: không còn sự kiện
+
+        for (char* cursor = buffer; cursor < buffer + length;) {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(cursor);
+            cursor += sizeof(inotify_event) + event->len;
+            if (event->len == 0) continue;
+
+            std::vector<int>::iterator watch = std::find(watches.begin(), watches.end(), event->wd);
+            if (watch == watches.end()) continue;
+
+            std::string path = directories[watch - watches.begin()] + "/" + event->name;
+            if (std::find(changedPaths.begin(), changedPaths.end(), path) == changedPaths.end()) {
+                changedPaths.push_back(path);
+                added++;
+            }
+        }
+    }
+    return added;
+}
+
+#else
+
+FileWatcher::FileWatcher() : fd(-1) {
+    std::cout << "FileWatcher: hot reload is only supported on Linux\n";
+}
+
+FileWatcher::~FileWatcher() {}
+
+bool FileWatcher::WatchDirectory(const std::string&) {
+    return false;
+}
+
+int FileWatcher::Poll(std::vector<std::string>&) {
+    return 0;
+}
+
+#endif
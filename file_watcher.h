@@ -0,0 +1,30 @@
+#ifndef FILE_WATCHER_H
+#define FILE_WATCHER_H
+
+#include <string>
+#include <vector>
+
+// Theo dõi các thư mục và báo những file vừa được ghi xong, dùng để nạp lại asset khi đang chơi.
+// Trên Linux dùng inotify ở chế độ không chặn nên Poll() gọi mỗi tick được; trên hệ khác
+// lớp này không làm gì và Poll() luôn trả về 0.
+class FileWatcher {
+private:
+    int fd;                               // inotify, -1 nếu không dùng được
+    std::vector<int> watches;             // Watch descriptor của từng thư mục
+    std::vector<std::string> directories; // Cùng chỉ số với watches
+
+public:
+    FileWatcher();
+    ~FileWatcher();
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    bool IsAvailable() const { return fd >= 0; }
+    // Theo dõi các file nằm trực tiếp trong directory (không đệ quy); bỏ qua nếu đã theo dõi
+    bool WatchDirectory(const std::string& directory);
+    // Thêm vào changedPaths đường dẫn "<thư mục>/<tên file>" của các file đã ghi xong hoặc được
+    // đổi tên tới kể từ lần gọi trước, mỗi file một lần; trả về số đường dẫn đã thêm
+    int Poll(std::vector<std::string>& changedPaths);
+};
+
+#endif
@@ -0,0 +1,115 @@
+#include "frame_arena.h"
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+FrameArena::FrameArena(std::size_t size)
+    : blockSize(size), current(0), offset(0), used(0), peak(0) {
+    Block block = {new char[blockSize], blockSize};
+    blocks.push_back(block);
+}
+
+FrameArena::~FrameArena() {
+    for (Block& block : blocks) {
+        delete[] block.data;
+    }
+}
+
+void* FrameArena::Allocate(std::size_t size, std::size_t alignment) {
+    if (size == 0) size = 1;
+    while (true) {
+        Block& block = blocks[current];
+        std::size_t start = (offset + alignment - 1) & ~(alignment - 1);
+        if (start + size <= block.size) {
+            offset = start + size;
+            used += size;
+            if (used > peak) peak = used;
+            return block.data + start;
+        }
+        // Khối hiện tại đầy: sang khối kế tiếp đã có, hoặc xin thêm khối mới
+        if (current + 1 == blocks.size()) {
+            std::size_t newSize = size + alignment > blockSize ? size + alignment : blockSize;
+            Block newBlock = {new char[newSize], newSize};
+            blocks.push_back(newBlock);
+            std::cout << "FrameArena grew to " << GetCapacity() << " bytes\n";
+        }
+        current++;
+        offset = 0;
+    }
+}
+
+void FrameArena::Reset() {
+    current = 0;
+    offset = 0;
+    used = 0;
+}
+
+std::size_t FrameArena::GetCapacity() const {
+    std::size_t capacity = 0;
+    for (const Block& block : blocks) {
+        capacity += block.size;
+    }
+    return capacity;
+}
+
+#ifdef FRAME_ALLOC_DEBUG
+
+static std::atomic<unsigned long> heapAllocationCount(0);
+
+// Thay operator new/delete toàn cục để đếm; bộ nhớ vẫn lấy từ malloc
+void* operator new(std::size_t size) {
+    heapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    void* pointer = std::malloc(size ? size : 1);
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    heapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept {
+    std::free(pointer);
+}
+
+bool IsHeapAllocationCountEnabled() {
+    return true;
+}
+
+unsigned long GetHeapAllocationCount() {
+    return heapAllocationCount.load(std::memory_order_relaxed);
+}
+
+#else
+
+bool IsHeapAllocationCountEnabled() {
+    return false;
+}
+
+unsigned long GetHeapAllocationCount() {
+    return 0;
+}
+
+#endif
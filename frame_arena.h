@@ -0,0 +1,85 @@
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+// Kích thước khối mặc định của FrameArena; đủ cho dữ liệu tạm của một tick thông thường
+const std::size_t FRAME_ARENA_BLOCK_SIZE = 256 * 1024;
+
+// Bộ cấp phát tuyến tính cho dữ liệu tạm của một tick (hộp va chạm và các lần trúng của HitWorld).
+// Cấp phát chỉ tăng con trỏ, giải phóng từng phần là không làm gì; Reset() đầu tick thu hồi tất cả.
+// Khi hết chỗ arena xin thêm khối mới từ heap và giữ lại sau Reset(), nên sau vài tick đầu
+// không còn cấp phát heap nào. Chỉ dùng trên một luồng.
+class FrameArena {
+private:
+    struct Block {
+        char* data;
+        std::size_t size;
+    };
+
+    std::vector<Block> blocks;
+    std::size_t blockSize;
+    std::size_t current; // Khối đang cấp phát
+    std::size_t offset;  // Vị trí trống đầu tiên trong khối hiện tại
+    std::size_t used;    // Số byte đã cấp phát trong tick
+    std::size_t peak;    // used lớn nhất từ khi tạo
+
+public:
+    explicit FrameArena(std::size_t blockSize = FRAME_ARENA_BLOCK_SIZE);
+    ~FrameArena();
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void* Allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+    // Thu hồi mọi cấp phát của tick trước; mọi con trỏ và container trên arena trở nên không hợp lệ
+    void Reset();
+
+    std::size_t GetUsed() const { return used; }
+    std::size_t GetPeak() const { return peak; }
+    std::size_t GetCapacity() const;
+};
+
+// Allocator tương thích STL trỏ tới một FrameArena; arena = nullptr thì dùng heap như std::allocator,
+// nhờ vậy cùng một kiểu container dùng được cả trong vòng lặp game lẫn trong công cụ.
+// Allocator đi theo container khi gán/hoán đổi, nên gán một container rỗng mới trên arena
+// là cách gắn lại container vào arena sau mỗi Reset().
+template <typename T>
+class FrameAllocator {
+public:
+    typedef T value_type;
+    typedef std::true_type propagate_on_container_copy_assignment;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    FrameArena* arena;
+
+    FrameAllocator() : arena(nullptr) {}
+    explicit FrameAllocator(FrameArena* frameArena) : arena(frameArena) {}
+    template <typename U>
+    FrameAllocator(const FrameAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(std::size_t n) {
+        if (arena) return static_cast<T*>(arena->Allocate(n * sizeof(T), alignof(T)));
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    void deallocate(T* pointer, std::size_t) {
+        if (!arena) ::operator delete(pointer);
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const FrameAllocator<T>& a, const FrameAllocator<U>& b) { return a.arena == b.arena; }
+template <typename T, typename U>
+bool operator!=(const FrameAllocator<T>& a, const FrameAllocator<U>& b) { return a.arena != b.arena; }
+
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T> >;
+
+// Bộ đếm cấp phát heap (operator new) của cả tiến trình, chỉ hoạt động khi biên dịch với
+// -DFRAME_ALLOC_DEBUG; lấy hiệu hai lần đọc để biết số lần cấp phát trong một tick
+bool IsHeapAllocationCountEnabled();
+unsigned long GetHeapAllocationCount();
+
+#endif
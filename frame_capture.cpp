@@ -0,0 +1,227 @@
+#include "frame_capture.h"
+#include <SDL_image.h>
+#include <iostream>
+
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#endif
+
+FrameCapture::FrameCapture()
+    : freeCount(0), queueHead(0), queueCount(0), format(CAPTURE_PNG), recording(false), currentClip(0),
+      droppedFrames(0), openClip(-1), clipFrame(0), stream(nullptr), running(false) {
+    for (int i = 0; i < CAPTURE_POOL_SIZE; ++i) {
+        pool[i].width = 0;
+        pool[i].height = 0;
+        pool[i].clip = 0;
+        freeFrames[freeCount++] = i;
+    }
+}
+
+FrameCapture::~FrameCapture() {
+    Stop();
+}
+
+// Tạo lần lượt các thư mục cha của prefix (vd. "capture/clip" -> "capture"); thư mục đã có thì bỏ qua
+static bool CreateParentDirectories(const std::string& prefix) {
+    for (size_t i = 1; i < prefix.size(); ++i) {
+        if (prefix[i] != '/' && prefix[i] != '\\') continue;
+        if (prefix[i - 1] == ':') continue; // Ổ đĩa Windows, vd. "C:/"
+        std::string directory = prefix.substr(0, i);
+#ifdef _WIN32
+        _mkdir(directory.c_str());
+#else
+        mkdir(directory.c_str(), 0755);
+#endif
+        // mkdir lỗi vì đã tồn tại là bình thường; chỉ cần sau đó đường dẫn là một thư mục
+        struct stat info;
+        if (stat(directory.c_str(), &info) != 0 || (info.st_mode & S_IFDIR) == 0) {
+            std::cout << "Capture error: cannot create directory " << directory << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FrameCapture::Start(const std::string& outputPrefix, CaptureFormat outputFormat) {
+    if (running) return true;
+    // Không tạo được thư mục đầu ra thì báo lỗi một lần và không bao giờ quay, thay vì báo lỗi từng khung hình
+    if (!CreateParentDirectories(outputPrefix)) return false;
+    prefix = outputPrefix;
+    format = outputFormat;
+    running = true;
+    worker = std::thread(&FrameCapture::Run, this);
+    return true;
+}
+
+void FrameCapture::Stop() {
+    if (!worker.joinable()) return;
+    recording = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    wake.notify_all();
+    worker.join();
+    CloseStream();
+    if (droppedFrames > 0) {
+        std::cout << "Capture dropped " << droppedFrames << " frames (encoder too slow)\n";
+    }
+}
+
+void FrameCapture::SetRecording(bool value) {
+    if (value == recording) return;
+    if (value && !running) return; // Start() thất bại: không có luồng mã hóa
+    if (value) {
+        currentClip++;
+        std::cout << "Capture started: clip " << currentClip << "\n";
+    } else {
+        std::cout << "Capture stopped: clip " << currentClip << "\n";
+    }
+    recording = value;
+}
+
+CapturedFrame* FrameCapture::AcquireFrame(int width, int height) {
+    if (!recording) return nullptr;
+
+    int index;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (freeCount == 0) {
+            droppedFrames++;
+            return nullptr;
+        }
+        index = freeFrames[--freeCount];
+    }
+
+    // Bộ đệm chỉ cấp phát lại khi kích thước cửa sổ đổi
+    CapturedFrame& frame = pool[index];
+    frame.width = width;
+    frame.height = height;
+    frame.clip = currentClip;
+    frame.pixels.resize(static_cast<size_t>(width) * height * 4);
+    return &frame;
+}
+
+void FrameCapture::SubmitFrame(CapturedFrame* frame) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queuedFrames[(queueHead + queueCount) % CAPTURE_POOL_SIZE] = static_cast<int>(frame - pool);
+        queueCount++;
+    }
+    wake.notify_one();
+}
+
+void FrameCapture::ReleaseFrame(CapturedFrame* frame) {
+    std::lock_guard<std::mutex> lock(mutex);
+    freeFrames[freeCount++] = static_cast<int>(frame - pool);
+}
+
+void FrameCapture::Run() {
+    while (true) {
+        int index;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return queueCount > 0 || !running; });
+            if (queueCount == 0) break; // Đã dừng và không còn khung hình chờ
+            index = queuedFrames[queueHead];
+            queueHead = (queueHead + 1) % CAPTURE_POOL_SIZE;
+            queueCount--;
+        }
+
+        Encode(pool[index]);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        freeFrames[freeCount++] = index;
+    }
+}
+
+void FrameCapture::Encode(CapturedFrame& frame) {
+    if (frame.clip != openClip) {
+        CloseStream();
+        openClip = frame.clip;
+        clipFrame = 0;
+    }
+    if (format == CAPTURE_Y4M) {
+        WriteY4m(frame);
+    } else {
+        WritePng(frame);
+    }
+    clipFrame++;
+}
+
+void FrameCapture::WritePng(const CapturedFrame& frame) {
+    char path[512];
+    std::snprintf(path, sizeof(path), "%s_%03d_%06d.png", prefix.c_str(), frame.clip, clipFrame);
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormatFrom(const_cast<Uint8*>(frame.pixels.data()),
+                                                              frame.width, frame.height, 32, frame.width * 4,
+                                                              SDL_PIXELFORMAT_ABGR8888);
+    if (!surface) {
+        std::cout << "Capture error: " << SDL_GetError() << "\n";
+        return;
+    }
+    if (IMG_SavePNG(surface, path) != 0) {
+        std::cout << "Capture error: cannot write " << path << ": " << IMG_GetError() << "\n";
+    }
+    SDL_FreeSurface(surface);
+}
+
+void FrameCapture::WriteY4m(const CapturedFrame& frame) {
+    // YUV 4:2:0 cần kích thước chẵn; bỏ hàng/cột lẻ cuối cùng
+    int width = frame.width & ~1;
+    int height = frame.height & ~1;
+    if (!stream) {
+        char path[512];
+        std::snprintf(path, sizeof(path), "%s_%03d.y4m", prefix.c_str(), frame.clip);
+        stream = std::fopen(path, "wb");
+        if (!stream) {
+            std::cout << "Capture error: cannot write " << path << "\n";
+            return;
+        }
+        std::fprintf(stream, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, CAPTURE_FPS);
+        std::cout << "Capture writing " << path << "\n";
+    }
+
+    // RGB -> YCbCr BT.601 toàn dải (JPEG), hệ số nhân 256; U/V lấy trung bình khối 2x2
+    int chromaWidth = width / 2;
+    int chromaHeight = height / 2;
+    planes.resize(static_cast<size_t>(width) * height + 2 * chromaWidth * chromaHeight);
+    Uint8* yPlane = planes.data();
+    Uint8* uPlane = yPlane + width * height;
+    Uint8* vPlane = uPlane + chromaWidth * chromaHeight;
+    const Uint8* pixels = frame.pixels.data();
+    int pitch = frame.width * 4;
+
+    for (int y = 0; y < height; ++y) {
+        const Uint8* row = pixels + y * pitch;
+        for (int x = 0; x < width; ++x) {
+            const Uint8* p = row + x * 4;
+            yPlane[y * width + x] = static_cast<Uint8>((77 * p[0] + 150 * p[1] + 29 * p[2]) >> 8);
+        }
+    }
+    for (int y = 0; y < chromaHeight; ++y) {
+        const Uint8* top = pixels + (2 * y) * pitch;
+        const Uint8* bottom = top + pitch;
+        for (int x = 0; x < chromaWidth; ++x) {
+            const Uint8* a = top + x * 8;
+            const Uint8* b = bottom + x * 8;
+            int r = (a[0] + a[4] + b[0] + b[4]) >> 2;
+            int g = (a[1] + a[5] + b[1] + b[5]) >> 2;
+            int bl = (a[2] + a[6] + b[2] + b[6]) >> 2;
+            int u = ((-43 * r - 85 * g + 128 * bl) >> 8) + 128;
+            int v = ((128 * r - 107 * g - 21 * bl) >> 8) + 128;
+            uPlane[y * chromaWidth + x] = static_cast<Uint8>(u < 0 ? 0 : (u > 255 ? 255 : u));
+            vPlane[y * chromaWidth + x] = static_cast<Uint8>(v < 0 ? 0 : (v > 255 ? 255 : v));
+        }
+    }
+
+    std::fputs("FRAME\n", stream);
+    std::fwrite(planes.data(), 1, planes.size(), stream);
+}
+
+void FrameCapture::CloseStream() {
+    if (stream) {
+        std::fclose(stream);
+        stream = nullptr;
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef FRAME_CAPTURE_H
+#define FRAME_CAPTURE_H
+
+#include <SDL.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Định dạng đầu ra: chuỗi ảnh PNG hoặc một luồng video thô YUV4MPEG2 (mở được bằng ffmpeg, mpv)
+enum CaptureFormat {
+    CAPTURE_PNG = 0,
+    CAPTURE_Y4M
+};
+
+// Số bộ đệm khung hình; luồng render không bao giờ chờ bộ mã hóa, hết bộ đệm thì bỏ khung hình
+const int CAPTURE_POOL_SIZE = 4;
+// Nhịp khung hình ghi vào header Y4M
+const int CAPTURE_FPS = 60;
+
+// Một khung hình đã đọc về từ renderer, điểm ảnh RGBA 8 bit liền nhau
+struct CapturedFrame {
+    std::vector<Uint8> pixels;
+    int width;
+    int height;
+    int clip;
+};
+
+// Quay khung hình của game: luồng render đọc điểm ảnh thẳng vào một bộ đệm trong pool (bản sao
+// duy nhất của vòng lặp game), luồng mã hóa riêng ghi PNG/Y4M rồi trả bộ đệm về pool.
+// Mỗi lần bật quay là một clip mới: <prefix>_<clip>_<khung>.png hoặc <prefix>_<clip>.y4m
+class FrameCapture {
+private:
+    CapturedFrame pool[CAPTURE_POOL_SIZE];
+    int freeFrames[CAPTURE_POOL_SIZE];
+    int freeCount;
+    int queuedFrames[CAPTURE_POOL_SIZE]; // Hàng đợi vòng cho luồng mã hóa
+    int queueHead;
+    int queueCount;
+
+    std::string prefix;
+    CaptureFormat format;
+    std::atomic<bool> recording;
+    std::atomic<int> currentClip;
+    std::atomic<int> droppedFrames;
+
+    // Chỉ luồng mã hóa dùng
+    int openClip;
+    int clipFrame;
+    FILE* stream;
+    std::vector<Uint8> planes; // Bộ đệm Y, U, V của một khung hình Y4M
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool running;
+
+    void Run();
+    void Encode(CapturedFrame& frame);
+    void WritePng(const CapturedFrame& frame);
+    void WriteY4m(const CapturedFrame& frame);
+    void CloseStream();
+
+public:
+    FrameCapture();
+    ~FrameCapture();
+
+    // Tạo thư mục chứa prefix rồi khởi động luồng mã hóa; chưa quay cho tới khi SetRecording(true).
+    // Trả về false (và SetRecording(true) bị bỏ qua) nếu không tạo được thư mục
+    bool Start(const std::string& prefix, CaptureFormat format);
+    // Mã hóa nốt các khung hình đang chờ rồi dừng luồng
+    void Stop();
+
+    void SetRecording(bool value);
+    bool IsRecording() const { return recording; }
+    int GetDroppedFrames() const { return droppedFrames; }
+
+    // Phía luồng render: lấy bộ đệm đủ cho width x height, nullptr nếu không quay hoặc pool đã hết
+    CapturedFrame* AcquireFrame(int width, int height);
+    // Giao khung hình đã đọc xong cho luồng mã hóa
+    void SubmitFrame(CapturedFrame* frame);
+    // Trả bộ đệm về pool khi không đọc được điểm ảnh
+    void ReleaseFrame(CapturedFrame* frame);
+};
+
+#endif
@@ -0,0 +1,342 @@
+#include "game_scenes.h"
+#include "combat.h"
+#include "metrics.h"
+#include "sprites.h"
+#include <cstdlib>
+#include <iostream>
+
+const Uint32 FRAME_DELAY = 70;
+const int DEATH_FRAME_COUNT = 4;
+const Uint32 DEATH_SEQUENCE_DURATION = DEATH_FRAME_COUNT * FRAME_DELAY; // Chờ hoạt ảnh chết trước khi rời trận
+const Uint32 LEVEL_COMPLETE_DURATION = 3000;
+const Uint32 GAME_COMPLETE_DURATION = 3000;
+
+// Số phần tử mỗi đoạn khi chia việc cập nhật cho JobSystem
+const int ACTOR_JOB_GRAIN = 8;
+const int BODY_JOB_GRAIN = 64;
+
+static bool IsKeyDown(const SDL_Event& e, SDL_Keycode key) {
+    return e.type == SDL_KEYDOWN && !e.key.repeat && e.key.keysym.sym == key;
+}
+
+MenuScene::MenuScene(GameContext& context) : context(context) {}
+
+void MenuScene::HandleEvent(const SDL_Event& e) {
+    GameState state = GameState::MENU;
+    context.gui.Update(e, state);
+    if (state == GameState::PLAYING) {
+        context.scenes.Replace(new LoadingScene(context, 1));
+    } else if (state == GameState::EXITING) {
+        context.scenes.Clear(); // Vòng lặp chính dừng luồng render rồi mới giải phóng SDL
+    }
+}
+
+void MenuScene::Update(Uint32 dt, const InputFrame& input) {
+    (void)dt;
+    (void)input;
+}
+
+void MenuScene::Render(RenderList& list) const {
+    context.gui.Render(list);
+}
+
+LoadingScene::LoadingScene(GameContext& context, int levelNumber, const std::string& path)
+    : context(context), levelNumber(levelNumber), path(path) {}
+
+void LoadingScene::Update(Uint32 dt, const InputFrame& input) {
+    (void)dt;
+    (void)input;
+    Level* level = new Level();
+    if (!LoadLevel(path.empty() ? GetLevelPath(levelNumber) : path, *level)) {
+        delete level;
+        context.scenes.Clear();
+        return;
+    }
+    context.scenes.Replace(new LevelScene(context, levelNumber, level));
+}
+
+void LoadingScene::Render(RenderList& list) const {
+    list.Clear({0, 0, 0, 255});
+    list.AddText(levelNumber == 1 ? "Loading..." : "Loading next level...", SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2, {255, 255, 255, 255});
+}
+
+LevelScene::LevelScene(GameContext& context, int levelNumber, Level* level)
+    : context(context), levelNumber(levelNumber), level(level), encounter(physics), camera(SCREEN_WIDTH, SCREEN_HEIGHT),
+      player(nullptr), tuningRevision(context.tuningRevision),
+      bossDying(false), playerDying(false), endingElapsed(0) {
+    hits.SetArena(&context.frameArena);
+}
+
+// Seed kẻ địch của màn, suy ra từ seed của lượt chơi nên replay dựng lại đúng boss và wave
+static Uint32 MakeLevelSeed(Uint32 runSeed, int levelNumber) {
+    Uint32 seed = runSeed ^ (static_cast<Uint32>(levelNumber) * 0x9E3779B9u);
+    seed ^= seed >> 16;
+    seed *= 0x85EBCA6Bu;
+    seed ^= seed >> 13;
+    return seed ? seed : 1;
+}
+
+LevelScene::~LevelScene() {
+    encounter.Clear();
+    delete player;
+    delete level;
+}
+
+void LevelScene::Enter() {
+    physics.SetLevel(level);
+    player = new Player(physics, level->playerSpawn.x, level->playerSpawn.y, SPRITE_PLAYER_IDLE, SPRITE_PLAYER_RUN, SPRITE_PLAYER_ATTACK,
+                        SPRITE_PLAYER_JUMP, SPRITE_PLAYER_DAMAGE, SPRITE_PLAYER_DEATH);
+    encounter.Start(*level, context.bossTuning, &context.events, MakeLevelSeed(context.seed, levelNumber));
+    player->SetEventBus(&context.events);
+    context.events.Subscribe(EventBit(EVENT_DIED), OnGameEvents, this);
+    context.events.Subscribe(EventBit(EVENT_DAMAGED) | EventBit(EVENT_DIED) | EventBit(EVENT_ATTACK_STARTED) |
+                             EventBit(EVENT_LANDED) | EventBit(EVENT_PROJECTILE_HIT),
+                             ParticleSystem::OnGameEvents, &particles);
+
+    // Camera bám theo player trong màn có thể rộng hơn màn hình
+    camera.SetWorldSize(level->width, level->height);
+    camera.Snap(player->GetRect());
+
+    // Nền, parallax và ô của màn; luồng render dựng cache của các lớp này
+    BuildStaticScene(*level, SCREEN_WIDTH, SCREEN_HEIGHT, staticScene);
+    context.renderThread.SetStaticScene(staticScene);
+}
+
+void LevelScene::Exit() {
+    context.events.Unsubscribe(OnGameEvents, this);
+    context.events.Unsubscribe(ParticleSystem::OnGameEvents, &particles);
+    particles.Clear();
+    encounter.Clear();
+    delete player;
+    player = nullptr;
+    // Giải phóng cache lớp tĩnh của màn trên luồng render
+    context.renderThread.SetStaticScene(StaticScene());
+}
+
+void LevelScene::OnGameEvents(void* context, const GameEvent* events, int count) {
+    LevelScene* scene = static_cast<LevelScene*>(context);
+    for (int i = 0; i < count; ++i) {
+        if (events[i].type != EVENT_DIED || scene->bossDying || scene->playerDying) continue;
+        if (events[i].entity == scene->player->GetBodyId()) {
+            scene->playerDying = true;
+            scene->endingElapsed = 0;
+        }
+    }
+}
+
+void LevelScene::HandleEvent(const SDL_Event& e) {
+    if (IsKeyDown(e, SDLK_ESCAPE) || IsKeyDown(e, SDLK_p)) {
+        context.scenes.Push(new PauseScene(context));
+    }
+}
+
+void LevelScene::Simulate(Uint32 dt, const InputFrame& input) {
+    EnemyList& enemies = encounter.GetEnemies();
+    int enemyCount = static_cast<int>(enemies.size());
+
+    // Player cập nhật trước (đọc input), sau đó các pha của kẻ địch chạy song song:
+    // AI -> vật lý -> xử lý va chạm. Player chỉ được đọc trong pha song song.
+    JobSystem& jobs = context.jobs;
+    physics.AdvanceTime(dt);
+    physics.BeginStep();
+    context.input.Consume(player->ApplyInput(input));
+    player->Update();
+    // Lambda chỉ giữ một tham chiếu để std::function lưu tại chỗ, không cấp phát heap
+    struct AiTick {
+        EnemyList& enemies;
+        const Player& player;
+        int level;
+    } aiTick = {enemies, *player, levelNumber};
+    JobHandle aiJob = jobs.ParallelFor(enemyCount, ACTOR_JOB_GRAIN, [&aiTick](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            aiTick.enemies[i]->Update(aiTick.player.GetRect(), aiTick.level, aiTick.player);
+        }
+    });
+    JobHandle physicsJob = jobs.ParallelFor(physics.GetBodyCount(), BODY_JOB_GRAIN, [&](int begin, int end) {
+        physics.StepRange(begin, end);
+    }, {aiJob});
+    JobHandle contactJob = jobs.ParallelFor(enemyCount, ACTOR_JOB_GRAIN, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) enemies[i]->ResolveContacts();
+    }, {physicsJob});
+    JobHandle playerContactJob = jobs.Schedule([&]() { player->ResolveContacts(); }, {physicsJob});
+    jobs.Wait(contactJob);
+    jobs.Wait(playerContactJob);
+    jobs.Reset();
+
+    // Áp dụng tuần tự các thay đổi lên trạng thái dùng chung
+    // Triệu hồi, wave mới và xóa kẻ địch đã chết làm đổi mảng nên chạy sau cùng
+    ResolveCombat(*player, encounter, hits);
+    encounter.Update(dt, levelNumber);
+    camera.Follow(player->GetRect());
+
+#ifdef BOSS_DEBUG_LOG
+    // Debug trạng thái
+    if (!enemies.empty()) {
+        const Boss* boss = enemies[0];
+        std::cout << "Boss isAttacking: " << boss->IsAttacking() << ", isDashing: " << boss->IsDashing() << ", isDiving: " << boss->IsDiving() << "\n";
+    }
+    std::cout << "Player isAttacking: " << player->IsAttacking() << "\n";
+#endif
+}
+
+void LevelScene::Update(Uint32 dt, const InputFrame& input) {
+    // Bắt đầu phát nhạc nếu chưa phát
+    if (!context.musicStarted && Mix_PausedMusic() == 0) {
+        Mix_PlayMusic(context.backgroundMusic, -1);
+        std::cout << "Background music started\n";
+        context.musicStarted = true;
+    }
+    if (tuningRevision != context.tuningRevision) {
+        encounter.SetTuning(context.bossTuning);
+        tuningRevision = context.tuningRevision;
+    }
+
+    // Player đã chết thì trận dừng, chỉ còn hoạt ảnh chạy
+    if (!playerDying) {
+        Simulate(dt, input);
+        if (!bossDying && encounter.IsCleared()) {
+            bossDying = true;
+            endingElapsed = 0;
+        }
+    }
+
+    // Tiến hoạt ảnh trong pha cập nhật; Render chỉ đọc trạng thái
+    const EnemyList& enemies = encounter.GetEnemies();
+    JobHandle animateJob = context.jobs.ParallelFor(static_cast<int>(enemies.size()), ACTOR_JOB_GRAIN, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) enemies[i]->Animate(dt);
+    });
+    player->Animate(dt);
+    particles.Update(dt);
+    context.jobs.Wait(animateJob);
+    context.jobs.Reset();
+
+    int projectiles = 0;
+    for (const Boss* enemy : enemies) projectiles += enemy->GetProjectileCount();
+    MetricSet(METRIC_LIVE_ENTITIES, static_cast<Sint64>(enemies.size()) + 1);
+    MetricSet(METRIC_PROJECTILES, projectiles);
+    MetricSet(METRIC_PARTICLES, particles.GetCount());
+    MetricRecord(METRIC_PARTICLE_UPDATE_TIME, static_cast<Uint64>(particles.GetLastUpdateMicros()));
+
+    // Rời trận sau khi hoạt ảnh chết kết thúc
+    if (bossDying || playerDying) {
+        endingElapsed += dt;
+        if (endingElapsed >= DEATH_SEQUENCE_DURATION) {
+            if (playerDying) {
+                context.scenes.Push(new GameOverScene(context));
+            } else {
+                GameEvent completed = {EVENT_LEVEL_COMPLETED, -1, TEAM_PLAYER, levelNumber, 0, 0, 0};
+                context.events.Publish(completed);
+                context.scenes.Replace(new LevelCompleteScene(context, levelNumber));
+            }
+            bossDying = false;
+            playerDying = false;
+        }
+    }
+}
+
+void LevelScene::Render(RenderList& list) const {
+    list.Clear({0, 0, 0, 255});
+
+    // Background, parallax và ô của màn: mỗi lớp là một lần blit từ texture cache
+    list.AddStaticLayers(staticScene, camera.GetView());
+
+    // Các đối tượng thế giới vẽ qua camera; hình ngoài khung nhìn bị loại ngay khi thêm
+    list.SetView(camera.GetView());
+    player->Render(list);
+    for (const Boss* enemy : encounter.GetEnemies()) {
+        enemy->Render(list);
+    }
+    particles.Render(list);
+
+    // Hiển thị sức khỏe của player (tọa độ màn hình)
+    list.ResetView();
+    for (int i = 0; i < player->GetHealth(); ++i) {
+        SDL_Rect heartRect = {10 + i * 40, 10, 32, 32};
+        list.AddSprite(SPRITE_HEART, nullptr, heartRect, LAYER_UI);
+    }
+}
+
+Uint32 LevelScene::HashState() const {
+    StateHash hash(static_cast<Uint32>(levelNumber));
+    hash.Add(physics.GetTime());
+    player->HashState(hash);
+    encounter.HashState(hash);
+    hash.Add(bossDying);
+    hash.Add(playerDying);
+    hash.Add(endingElapsed);
+    return hash.Finish();
+}
+
+PauseScene::PauseScene(GameContext& context) : context(context) {}
+
+void PauseScene::HandleEvent(const SDL_Event& e) {
+    if (IsKeyDown(e, SDLK_ESCAPE) || IsKeyDown(e, SDLK_p)) {
+        context.scenes.Pop();
+    } else if (IsKeyDown(e, SDLK_q)) {
+        context.scenes.Clear();
+    }
+}
+
+void PauseScene::Update(Uint32 dt, const InputFrame& input) {
+    (void)dt;
+    (void)input;
+}
+
+void PauseScene::Render(RenderList& list) const {
+    SDL_Rect screenRect = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+    list.AddFillRect(screenRect, {0, 0, 0, 160}, LAYER_OVERLAY);
+    list.AddText("Paused", SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2 - 20, {255, 255, 255, 255});
+    list.AddText("Esc: continue   Q: quit", SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2 + 20, {255, 255, 255, 255});
+}
+
+GameOverScene::GameOverScene(GameContext& context) : context(context) {}
+
+void GameOverScene::HandleEvent(const SDL_Event& e) {
+    if (IsKeyDown(e, SDLK_ESCAPE)) {
+        context.scenes.Clear();
+    }
+}
+
+void GameOverScene::Update(Uint32 dt, const InputFrame& input) {
+    (void)dt;
+    (void)input;
+}
+
+void GameOverScene::Render(RenderList& list) const {
+    SDL_Rect screenRect = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+    list.AddSprite(SPRITE_GAME_OVER, nullptr, screenRect, LAYER_OVERLAY);
+}
+
+LevelCompleteScene::LevelCompleteScene(GameContext& context, int levelNumber)
+    : context(context), levelNumber(levelNumber), elapsed(0) {}
+
+void LevelCompleteScene::HandleEvent(const SDL_Event& e) {
+    if (IsLastLevel() && elapsed >= LEVEL_COMPLETE_DURATION && IsKeyDown(e, SDLK_ESCAPE)) {
+        context.scenes.Clear();
+    }
+}
+
+void LevelCompleteScene::Update(Uint32 dt, const InputFrame& input) {
+    (void)input;
+    bool wasShowingLevel = elapsed < LEVEL_COMPLETE_DURATION;
+    elapsed += dt;
+    if (wasShowingLevel && elapsed >= LEVEL_COMPLETE_DURATION) {
+        if (!IsLastLevel()) {
+            context.scenes.Replace(new LoadingScene(context, levelNumber + 1));
+            return;
+        }
+        // Âm thanh hoàn thành game do subscriber của sự kiện phát
+        GameEvent completed = {EVENT_GAME_COMPLETED, -1, TEAM_PLAYER, levelNumber, 0, 0, 0};
+        context.events.Publish(completed);
+    }
+    if (elapsed >= LEVEL_COMPLETE_DURATION + GAME_COMPLETE_DURATION) {
+        context.scenes.Clear();
+    }
+}
+
+void LevelCompleteScene::Render(RenderList& list) const {
+    SDL_Rect screenRect = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+    list.Clear({0, 0, 0, 255});
+    int sprite = elapsed < LEVEL_COMPLETE_DURATION ? SPRITE_LEVEL_COMPLETE : SPRITE_GAME_COMPLETE;
+    list.AddSprite(sprite, nullptr, screenRect, LAYER_OVERLAY);
+}
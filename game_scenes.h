@@ -0,0 +1,141 @@
+#ifndef GAME_SCENES_H
+#define GAME_SCENES_H
+
+#include <SDL.h>
+#include <SDL_mixer.h>
+#include "scene.h"
+#include "boss_tuning.h"
+#include "camera.h"
+#include "encounter.h"
+#include "event_bus.h"
+#include "frame_arena.h"
+#include "gui.h"
+#include "hitbox.h"
+#include "input.h"
+#include "job_system.h"
+#include "level.h"
+#include "particles.h"
+#include "physics.h"
+#include "player.h"
+#include "render_thread.h"
+
+// Tài nguyên sống suốt chương trình mà các scene dùng chung
+struct GameContext {
+    SceneStack& scenes;
+    RenderThread& renderThread;
+    InputSystem& input;
+    GUI& gui;
+    EventBus& events;
+    JobSystem& jobs;
+    FrameArena& frameArena;
+    Mix_Music* backgroundMusic;
+    BossTuning bossTuning;
+    Uint32 tuningRevision; // Tăng mỗi lần bossTuning được nạp lại từ file
+    bool musicStarted;
+    Uint32 seed;           // Seed của lượt chơi, ghi trong header replay; mọi RNG của mô phỏng suy ra từ nó
+};
+
+class MenuScene : public Scene {
+private:
+    GameContext& context;
+
+public:
+    explicit MenuScene(GameContext& context);
+    void HandleEvent(const SDL_Event& e) override;
+    void Update(Uint32 dt, const InputFrame& input) override;
+    void Render(RenderList& list) const override;
+};
+
+// Nạp file màn ở tick đầu tiên (sau khi đã vẽ một khung "Loading") rồi chuyển sang LevelScene
+class LoadingScene : public Scene {
+private:
+    GameContext& context;
+    int levelNumber;
+    std::string path; // File màn, rỗng thì dùng GetLevelPath(levelNumber)
+
+public:
+    // path khác rỗng: nạp file đó và chơi theo luật của màn levelNumber (màn thử tải)
+    LoadingScene(GameContext& context, int levelNumber, const std::string& path = "");
+    void Update(Uint32 dt, const InputFrame& input) override;
+    void Render(RenderList& list) const override;
+};
+
+// Trận đấu của một màn; sở hữu màn, thế giới vật lý, player và mọi kẻ địch
+class LevelScene : public Scene {
+private:
+    GameContext& context;
+    int levelNumber;
+    Level* level;
+    PhysicsWorld physics;
+    Encounter encounter; // Khai báo sau physics: kẻ địch hủy thân vật lý khi bị giải phóng
+    HitWorld hits;
+    Camera camera;
+    StaticScene staticScene;
+    ParticleSystem particles;
+    Player* player;
+    Uint32 tuningRevision;
+
+    // Chuỗi kết thúc trận theo thời gian game; bắt đầu khi player chết hoặc mọi kẻ địch bị hạ
+    bool bossDying;
+    bool playerDying;
+    Uint32 endingElapsed;
+
+    static void OnGameEvents(void* context, const GameEvent* events, int count);
+    void Simulate(Uint32 dt, const InputFrame& input);
+
+public:
+    // level được cấp phát bởi LoadingScene, LevelScene nhận quyền sở hữu
+    LevelScene(GameContext& context, int levelNumber, Level* level);
+    ~LevelScene();
+    void Enter() override;
+    void Exit() override;
+    void HandleEvent(const SDL_Event& e) override;
+    void Update(Uint32 dt, const InputFrame& input) override;
+    void Render(RenderList& list) const override;
+    bool IsGameplay() const override { return true; }
+    // Đồng hồ game, player, kẻ địch, wave và chuỗi kết thúc trận; hạt và camera chỉ để hiển thị nên bỏ qua
+    Uint32 HashState() const override;
+};
+
+// Phủ lên màn chơi đang dừng; mô phỏng bên dưới không chạy
+class PauseScene : public Scene {
+private:
+    GameContext& context;
+
+public:
+    explicit PauseScene(GameContext& context);
+    void HandleEvent(const SDL_Event& e) override;
+    void Update(Uint32 dt, const InputFrame& input) override;
+    void Render(RenderList& list) const override;
+    bool IsOverlay() const override { return true; }
+};
+
+class GameOverScene : public Scene {
+private:
+    GameContext& context;
+
+public:
+    explicit GameOverScene(GameContext& context);
+    void HandleEvent(const SDL_Event& e) override;
+    void Update(Uint32 dt, const InputFrame& input) override;
+    void Render(RenderList& list) const override;
+    bool IsOverlay() const override { return true; }
+};
+
+// Màn hình hoàn thành màn; sau màn cuối là màn hình hoàn thành game rồi thoát
+class LevelCompleteScene : public Scene {
+private:
+    GameContext& context;
+    int levelNumber;
+    Uint32 elapsed;
+
+    bool IsLastLevel() const { return levelNumber >= LEVEL_COUNT; }
+
+public:
+    LevelCompleteScene(GameContext& context, int levelNumber);
+    void HandleEvent(const SDL_Event& e) override;
+    void Update(Uint32 dt, const InputFrame& input) override;
+    void Render(RenderList& list) const override;
+};
+
+#endif
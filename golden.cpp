@@ -0,0 +1,117 @@
+#include "golden.h"
+#include <SDL_image.h>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+GoldenRun::GoldenRun(const std::string& directory, const std::string& name, bool update)
+    : directory(directory), name(name), update(update), checked(0), failed(0), written(0) {}
+
+std::string GoldenRun::MakePath(int tick, const char* suffix) const {
+    char file[256];
+    std::snprintf(file, sizeof(file), "%s_%06d%s.png", name.c_str(), tick, suffix);
+    return directory + "/" + file;
+}
+
+bool GoldenRun::SavePng(const std::string& path, const Uint8* pixels, int width, int height) const {
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormatFrom(const_cast<Uint8*>(pixels), width, height, 32,
+                                                              width * 4, SDL_PIXELFORMAT_ABGR8888);
+    if (!surface) {
+        std::cout << "Golden error: " << SDL_GetError() << "\n";
+        return false;
+    }
+    bool ok = IMG_SavePNG(surface, path.c_str()) == 0;
+    if (!ok) std::cout << "Golden error: cannot write " << path << ": " << IMG_GetError() << "\n";
+    SDL_FreeSurface(surface);
+    return ok;
+}
+
+void GoldenRun::Compare(int tick, const Uint8* pixels, int width, int height) {
+    std::string goldenPath = MakePath(tick, "");
+    if (update) {
+        if (SavePng(goldenPath, pixels, width, height)) {
+            written++;
+            std::cout << "Golden written: " << goldenPath << "\n";
+        }
+        return;
+    }
+
+    // Ảnh chuẩn thiếu là lỗi: nếu không, checkout mới hoặc CI luôn đạt mà không kiểm tra gì
+    SDL_Surface* loaded = IMG_Load(goldenPath.c_str());
+    if (!loaded) {
+        std::cout << "Golden FAIL tick " << tick << ": missing " << goldenPath << " (run with --golden-update to create it)\n";
+        failed++;
+        SavePng(MakePath(tick, "_actual"), pixels, width, height);
+        return;
+    }
+
+    SDL_Surface* golden = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_ABGR8888, 0);
+    SDL_FreeSurface(loaded);
+    checked++;
+    if (!golden || golden->w != width || golden->h != height) {
+        std::cout << "Golden FAIL tick " << tick << ": size differs from " << goldenPath << "\n";
+        failed++;
+        SavePng(MakePath(tick, "_actual"), pixels, width, height);
+        if (golden) SDL_FreeSurface(golden);
+        return;
+    }
+
+    // Ảnh khác biệt: điểm ảnh lệch tô đỏ, phần còn lại là ảnh chuẩn dạng xám tối để dễ định vị
+    std::vector<Uint8> diff(static_cast<size_t>(width) * height * 4);
+    int badPixels = 0;
+    int worstChannel = 0;
+    SDL_LockSurface(golden);
+    for (int y = 0; y < height; ++y) {
+        const Uint8* expected = static_cast<const Uint8*>(golden->pixels) + y * golden->pitch;
+        const Uint8* actual = pixels + y * width * 4;
+        Uint8* out = &diff[static_cast<size_t>(y) * width * 4];
+        for (int x = 0; x < width * 4; x += 4) {
+            int delta = 0;
+            for (int c = 0; c < 3; ++c) {
+                int d = std::abs(expected[x + c] - actual[x + c]);
+                if (d > delta) delta = d;
+            }
+            if (delta > worstChannel) worstChannel = delta;
+            if (delta > GOLDEN_CHANNEL_TOLERANCE) {
+                badPixels++;
+                out[x] = 255;
+                out[x + 1] = 0;
+                out[x + 2] = 0;
+            } else {
+                Uint8 gray = static_cast<Uint8>((expected[x] + expected[x + 1] + expected[x + 2]) / 12);
+                out[x] = gray;
+                out[x + 1] = gray;
+                out[x + 2] = gray;
+            }
+            out[x + 3] = 255;
+        }
+    }
+    SDL_UnlockSurface(golden);
+    SDL_FreeSurface(golden);
+
+    double badFraction = static_cast<double>(badPixels) / (static_cast<double>(width) * height);
+    if (badFraction > GOLDEN_MAX_BAD_FRACTION) {
+        failed++;
+        std::cout << "Golden FAIL tick " << tick << ": " << badPixels << " pixels differ (max channel delta "
+                  << worstChannel << ")\n";
+        SavePng(MakePath(tick, "_actual"), pixels, width, height);
+        SavePng(MakePath(tick, "_diff"), diff.data(), width, height);
+    } else {
+        std::cout << "Golden ok tick " << tick << " (" << badPixels << " pixels over tolerance)\n";
+    }
+}
+
+bool GoldenRun::Report() const {
+    std::cout << "Golden images: " << checked << " checked, " << failed << " failed, " << written << " written\n";
+    // Replay quá ngắn để tới khung hình mốc nào cũng là lỗi
+    if (!update && checked == 0 && failed == 0) {
+        std::cout << "Golden FAIL: the replay reached no checkpoint\n";
+        return false;
+    }
+    return failed == 0;
+}
+
+void GoldenRun::OnSnapshot(void* context, int tag, const Uint8* pixels, int width, int height) {
+    static_cast<GoldenRun*>(context)->Compare(tag, pixels, width, height);
+}
@@ -0,0 +1,43 @@
+#ifndef GOLDEN_H
+#define GOLDEN_H
+
+#include <SDL.h>
+#include <string>
+
+// Khung hình được so sánh sau mỗi GOLDEN_TICK_INTERVAL tick của replay
+const int GOLDEN_TICK_INTERVAL = 60;
+// Mỗi kênh màu được lệch tối đa GOLDEN_CHANNEL_TOLERANCE (khử răng cưa, làm tròn của renderer)
+const int GOLDEN_CHANNEL_TOLERANCE = 8;
+// Tỉ lệ điểm ảnh lệch quá ngưỡng tối đa trước khi khung hình bị coi là sai
+const double GOLDEN_MAX_BAD_FRACTION = 0.001;
+
+// Kiểm tra hồi quy hình ảnh: chạy một replay bằng renderer phần mềm, so sánh các khung hình
+// mốc với ảnh chuẩn <directory>/<name>_<tick>.png. Khung hình sai được ghi thành
+// <name>_<tick>_actual.png và <name>_<tick>_diff.png (đỏ: lệch, xám: khớp) để xem lại.
+// Ảnh chuẩn chưa có là lỗi; chạy với update để ghi khung hình hiện tại làm ảnh chuẩn.
+// Replay và ảnh chuẩn chạy trên CI nằm trong tests/golden (target GoldenTest trong MyGame.cbp).
+class GoldenRun {
+private:
+    std::string directory;
+    std::string name;
+    bool update;
+    int checked;
+    int failed;
+    int written;
+
+    std::string MakePath(int tick, const char* suffix) const;
+    bool SavePng(const std::string& path, const Uint8* pixels, int width, int height) const;
+    void Compare(int tick, const Uint8* pixels, int width, int height);
+
+public:
+    GoldenRun(const std::string& directory, const std::string& name, bool update);
+
+    bool IsCheckpoint(int tick) const { return tick > 0 && tick % GOLDEN_TICK_INTERVAL == 0; }
+    // In kết quả; trả về true nếu không có khung hình nào sai
+    bool Report() const;
+
+    // SnapshotHandler của RenderThread; tag là số tick của replay
+    static void OnSnapshot(void* context, int tag, const Uint8* pixels, int width, int height);
+};
+
+#endif
@@ -1,9 +1,15 @@
 #include "gui.h"
+#include "physics.h"
 #include <SDL.h>
 #include <SDL_ttf.h>
 #include <SDL_mixer.h>
 #include <iostream>
 
+// Nút menu xếp dọc giữa màn hình logic
+const int BUTTON_WIDTH = 200;
+const int BUTTON_HEIGHT = 50;
+const int BUTTON_X = (SCREEN_WIDTH - BUTTON_WIDTH) / 2;
+
 // Hàm hành động cho các nút
 bool StartAction(GameState& state, bool& soundEnabled, Mix_Music* music, Mix_Chunk* gameOverSound, Mix_Chunk* attackSound) {
     state = GameState::PLAYING;
@@ -31,16 +37,15 @@ bool OptionAction(GameState& state, bool& soundEnabled, Mix_Music* music, Mix_Ch
 
 bool ExitAction(GameState& state, bool& soundEnabled, Mix_Music* music, Mix_Chunk* gameOverSound, Mix_Chunk* attackSound) {
     std::cout << "Exiting game\n";
-    SDL_Quit();
-    exit(0);
+    state = GameState::EXITING; // Vòng lặp chính dừng luồng render rồi mới giải phóng SDL
     return false;
 }
 
-GUI::GUI(SDL_Renderer* renderer, TTF_Font* font, Mix_Music* music, Mix_Chunk* gameOverSound, Mix_Chunk* attackSound)
-    : renderer(renderer), font(font), soundEnabled(true), backgroundMusic(music), gameOverSound(gameOverSound), attackSound(attackSound) {
+GUI::GUI(Mix_Music* music, Mix_Chunk* gameOverSound, Mix_Chunk* attackSound)
+    : soundEnabled(true), backgroundMusic(music), gameOverSound(gameOverSound), attackSound(attackSound) {
     // Khởi tạo các nút
     Button startButton = {
-        {500, 200, 200, 50},
+        {BUTTON_X, 200, BUTTON_WIDTH, BUTTON_HEIGHT},
         "Start",
         {0, 255, 0, 255},
         {100, 255, 100, 255},
@@ -50,7 +55,7 @@ GUI::GUI(SDL_Renderer* renderer, TTF_Font* font, Mix_Music* music, Mix_Chunk* ga
     };
 
     Button optionButton = {
-        {500, 300, 200, 50},
+        {BUTTON_X, 300, BUTTON_WIDTH, BUTTON_HEIGHT},
         "Option",
         {255, 255, 0, 255},
         {255, 255, 100, 255},
@@ -60,7 +65,7 @@ GUI::GUI(SDL_Renderer* renderer, TTF_Font* font, Mix_Music* music, Mix_Chunk* ga
     };
 
     Button exitButton = {
-        {500, 400, 200, 50},
+        {BUTTON_X, 400, BUTTON_WIDTH, BUTTON_HEIGHT},
         "Exit",
         {255, 0, 0, 255},
         {255, 100, 100, 255},
@@ -75,10 +80,10 @@ GUI::GUI(SDL_Renderer* renderer, TTF_Font* font, Mix_Music* music, Mix_Chunk* ga
 }
 
 GUI::~GUI() {
-    // Font, music, gameOverSound, attackSound được giải phóng trong main.cpp
+    // Music, gameOverSound, attackSound được giải phóng trong main.cpp
 }
 
-void GUI::Update(SDL_Event& e, GameState& state) {
+void GUI::Update(const SDL_Event& e, GameState& state) {
     int mouseX, mouseY;
     SDL_GetMouseState(&mouseX, &mouseY);
 
@@ -96,39 +101,14 @@ void GUI::Update(SDL_Event& e, GameState& state) {
     }
 }
 
-void GUI::RenderText(const std::string& text, int x, int y, SDL_Color color) {
-    SDL_Surface* surface = TTF_RenderText_Solid(font, text.c_str(), color);
-    if (!surface) {
-        std::cerr << "TTF_RenderText_Solid Error: " << TTF_GetError() << "\n";
-        return;
-    }
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (!texture) {
-        std::cerr << "SDL_CreateTextureFromSurface Error: " << SDL_GetError() << "\n";
-        SDL_FreeSurface(surface);
-        return;
-    }
-    int textW, textH;
-    SDL_QueryTexture(texture, nullptr, nullptr, &textW, &textH);
-    SDL_Rect dstRect = {x - textW / 2, y - textH / 2, textW, textH};
-    SDL_RenderCopy(renderer, texture, nullptr, &dstRect);
-    SDL_FreeSurface(surface);
-    SDL_DestroyTexture(texture);
-}
-
-void GUI::Render() {
-    SDL_SetRenderDrawColor(renderer, 50, 50, 50, 255);
-    SDL_RenderClear(renderer);
+void GUI::Render(RenderList& list) const {
+    list.Clear({50, 50, 50, 255});
 
     for (const auto& button : buttons) {
         SDL_Color color = button.isHovered ? button.hoverColor : button.normalColor;
-        SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
-        SDL_RenderFillRect(renderer, &button.rect);
-        RenderText(button.text, button.rect.x + button.rect.w / 2, button.rect.y + button.rect.h / 2, {255, 255, 255, 255});
+        list.AddFillRect(button.rect, color, LAYER_UI);
+        list.AddText(button.text.c_str(), button.rect.x + button.rect.w / 2, button.rect.y + button.rect.h / 2, {255, 255, 255, 255});
     }
 
-    std::string soundText = "Sound: " + std::string(soundEnabled ? "ON" : "OFF");
-    RenderText(soundText, 600, 500, {255, 255, 255, 255});
-
-    SDL_RenderPresent(renderer);
+    list.AddText(soundEnabled ? "Sound: ON" : "Sound: OFF", SCREEN_WIDTH / 2, SCREEN_HEIGHT - 100, {255, 255, 255, 255});
 }
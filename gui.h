@@ -6,10 +6,12 @@
 #include <SDL_mixer.h>
 #include <string>
 #include <vector>
+#include "render_list.h"
 
 enum class GameState {
     MENU,
-    PLAYING
+    PLAYING,
+    EXITING
 };
 
 struct Button {
@@ -24,21 +26,17 @@ struct Button {
 
 class GUI {
 private:
-    TTF_Font* font;
     std::vector<Button> buttons;
     bool soundEnabled;
-    SDL_Renderer* renderer;
     Mix_Music* backgroundMusic;
     Mix_Chunk* gameOverSound;
     Mix_Chunk* attackSound; // Thêm âm thanh tấn công
 
-    void RenderText(const std::string& text, int x, int y, SDL_Color color);
-
 public:
-    GUI(SDL_Renderer* renderer, TTF_Font* font, Mix_Music* music, Mix_Chunk* gameOverSound, Mix_Chunk* attackSound);
+    GUI(Mix_Music* music, Mix_Chunk* gameOverSound, Mix_Chunk* attackSound);
     ~GUI();
-    void Update(SDL_Event& e, GameState& state);
-    void Render();
+    void Update(const SDL_Event& e, GameState& state);
+    void Render(RenderList& list) const;
     bool IsSoundEnabled() const { return soundEnabled; }
 };
 
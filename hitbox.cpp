@@ -0,0 +1,108 @@
+#include "hitbox.h"
+
+// Dung lượng đặt trước để tick bình thường không cấp phát heap
+const int BOX_CAPACITY = 64;
+const int EVENT_CAPACITY = 16;
+
+HitWorld::HitWorld() : arena(nullptr) {
+    hitBoxes.reserve(BOX_CAPACITY);
+    hurtBoxes.reserve(BOX_CAPACITY);
+    landed.reserve(BOX_CAPACITY);
+    events.reserve(EVENT_CAPACITY);
+}
+
+void HitWorld::Begin() {
+    if (!arena) {
+        hitBoxes.clear();
+        hurtBoxes.clear();
+        events.clear();
+        return;
+    }
+    // Bộ nhớ của tick trước đã bị arena thu hồi: gắn các mảng vào arena của tick này
+    hitBoxes = FrameVector<HitBox>(FrameAllocator<HitBox>(arena));
+    hurtBoxes = FrameVector<HurtBox>(FrameAllocator<HurtBox>(arena));
+    events = FrameVector<HitEvent>(FrameAllocator<HitEvent>(arena));
+    hitBoxes.reserve(BOX_CAPACITY);
+    hurtBoxes.reserve(BOX_CAPACITY);
+    events.reserve(EVENT_CAPACITY);
+}
+
+void HitWorld::Clear() {
+    Begin();
+    landed.clear();
+}
+
+void HitWorld::AddHitBox(const SDL_Rect& rect, int owner, int team, Uint32 attack, int damage) {
+    HitBox box = {rect, owner, team, attack, damage};
+    hitBoxes.push_back(box);
+}
+
+void HitWorld::AddHurtBox(const SDL_Rect& rect, int owner, int team) {
+    HurtBox box = {rect, owner, team};
+    hurtBoxes.push_back(box);
+}
+
+void HitWorld::AddClipBoxes(const Animator& animator, const SDL_Rect& body, bool facingRight,
+                            int owner, int team, Uint32 attack) {
+    const AnimationClip* clip = animator.GetClip();
+    bool hasHurtBox = false;
+    if (clip) {
+        int frame = animator.GetFrame();
+        for (const FrameBox& box : clip->boxes) {
+            if (frame < box.firstFrame || frame > box.lastFrame) continue;
+            SDL_Rect placed = PlaceFrameBox(box.rect, body, facingRight);
+            if (box.kind == BOX_HIT) {
+                AddHitBox(placed, owner, team, attack, box.damage);
+            } else {
+                AddHurtBox(placed, owner, team);
+                hasHurtBox = true;
+            }
+        }
+    }
+    if (!hasHurtBox) AddHurtBox(body, owner, team);
+}
+
+bool HitWorld::HasLanded(int attacker, Uint32 attack, int target) const {
+    for (const HitRecord& record : landed) {
+        if (record.attacker == attacker && record.attack == attack && record.target == target) return true;
+    }
+    return false;
+}
+
+const FrameVector<HitEvent>& HitWorld::Resolve() {
+    events.clear();
+
+    // Bỏ các lần tấn công đã kết thúc (không còn hộp đánh trong tick này)
+    size_t kept = 0;
+    for (size_t i = 0; i < landed.size(); ++i) {
+        bool active = false;
+        for (const HitBox& hit : hitBoxes) {
+            if (hit.owner == landed[i].attacker && hit.attack == landed[i].attack) {
+                active = true;
+                break;
+            }
+        }
+        if (active) landed[kept++] = landed[i];
+    }
+    landed.resize(kept);
+
+    for (const HitBox& hit : hitBoxes) {
+        int hitRight = hit.rect.x + hit.rect.w;
+        int hitBottom = hit.rect.y + hit.rect.h;
+        for (const HurtBox& hurt : hurtBoxes) {
+            if (hurt.team == hit.team) continue;
+            if (hurt.rect.x >= hitRight || hit.rect.x >= hurt.rect.x + hurt.rect.w ||
+                hurt.rect.y >= hitBottom || hit.rect.y >= hurt.rect.y + hurt.rect.h) {
+                continue;
+            }
+            // Một mục tiêu có thể có nhiều hộp nhận đòn, chỉ tính trúng một lần
+            if (HasLanded(hit.owner, hit.attack, hurt.owner)) continue;
+
+            HitRecord record = {hit.owner, hit.attack, hurt.owner};
+            landed.push_back(record);
+            HitEvent event = {hit.owner, hit.attack, hurt.owner, hit.damage};
+            events.push_back(event);
+        }
+    }
+    return events;
+}
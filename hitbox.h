@@ -0,0 +1,84 @@
+#ifndef HITBOX_H
+#define HITBOX_H
+
+#include <SDL.h>
+#include <vector>
+#include "animation.h"
+#include "frame_arena.h"
+
+// Phe của hộp va chạm: hộp đánh chỉ trúng hộp nhận đòn của phe khác
+enum HitTeam {
+    TEAM_PLAYER = 0,
+    TEAM_ENEMY
+};
+
+// Hộp đánh trong thế giới của một tick. owner là bodyId của đối tượng tấn công,
+// attack định danh lần tấn công của owner (mỗi cú chém, cú lướt, mũi tên là một lần).
+struct HitBox {
+    SDL_Rect rect;
+    int owner;
+    int team;
+    Uint32 attack;
+    int damage;
+};
+
+struct HurtBox {
+    SDL_Rect rect;
+    int owner;
+    int team;
+};
+
+// Một lần tấn công trúng mục tiêu; mỗi (owner, attack) trúng mỗi mục tiêu đúng một lần
+struct HitEvent {
+    int attacker;
+    Uint32 attack;
+    int target;
+    int damage;
+};
+
+// Thu thập hộp đánh/hộp nhận đòn của mọi đối tượng trong tick rồi kiểm tra chồng lấn
+// trong một lượt duy nhất trên các mảng liền nhau. Nhớ các cặp (lần tấn công, mục tiêu)
+// đã trúng qua nhiều tick cho tới khi lần tấn công đó không còn hộp đánh nào.
+// Hộp và lần trúng của tick nằm trên FrameArena nếu có (vòng lặp game), không thì trên heap (công cụ).
+class HitWorld {
+private:
+    // Cặp đã trúng của một lần tấn công còn đang diễn ra
+    struct HitRecord {
+        int attacker;
+        Uint32 attack;
+        int target;
+    };
+
+    FrameArena* arena;
+    FrameVector<HitBox> hitBoxes;
+    FrameVector<HurtBox> hurtBoxes;
+    std::vector<HitRecord> landed; // Sống qua nhiều tick nên luôn nằm trên heap
+    FrameVector<HitEvent> events;
+
+    bool HasLanded(int attacker, Uint32 attack, int target) const;
+
+public:
+    HitWorld();
+
+    // Arena phải được Reset() trước mỗi tick và sống lâu hơn HitWorld; nullptr thì dùng heap
+    void SetArena(FrameArena* value) { arena = value; }
+    // Bắt đầu tick mới: xóa hộp của tick trước (cấp phát lại trên arena nếu có), giữ lại các cặp đã trúng
+    void Begin();
+    // Quên mọi cặp đã trúng (khi nạp lại màn)
+    void Clear();
+
+    void AddHitBox(const SDL_Rect& rect, int owner, int team, Uint32 attack, int damage);
+    void AddHurtBox(const SDL_Rect& rect, int owner, int team);
+    // Thêm các hộp mà khung hiện tại của animator khai báo, đặt lên body theo hướng mặt.
+    // Khung không khai báo hộp nhận đòn thì cả body là hộp nhận đòn.
+    void AddClipBoxes(const Animator& animator, const SDL_Rect& body, bool facingRight,
+                      int owner, int team, Uint32 attack);
+
+    // Lượt kiểm tra chồng lấn của tick; trả về các lần trúng mới theo thứ tự hộp đánh được thêm
+    const FrameVector<HitEvent>& Resolve();
+
+    int GetHitBoxCount() const { return static_cast<int>(hitBoxes.size()); }
+    int GetHurtBoxCount() const { return static_cast<int>(hurtBoxes.size()); }
+};
+
+#endif
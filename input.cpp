@@ -0,0 +1,237 @@
+#include "input.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// Ngưỡng cần gạt trái để tính là giữ hướng
+const Sint16 STICK_DEADZONE = 12000;
+
+static const char* const INPUT_ACTION_NAMES[ACTION_COUNT] = {
+    "move_left",
+    "move_right",
+    "jump",
+    "attack",
+    "dash"
+};
+
+const char* GetInputActionName(int action) {
+    if (action < 0 || action >= ACTION_COUNT) return nullptr;
+    return INPUT_ACTION_NAMES[action];
+}
+
+int FindInputAction(const char* name) {
+    for (int i = 0; i < ACTION_COUNT; ++i) {
+        if (std::strcmp(INPUT_ACTION_NAMES[i], name) == 0) return i;
+    }
+    return -1;
+}
+
+InputSystem::InputSystem()
+    : controller(nullptr), eventPressed(0), eventReleased(0), previousHeld(0) {
+    for (int i = 0; i < ACTION_COUNT; ++i) {
+        for (int slot = 0; slot < MAX_KEYS_PER_ACTION; ++slot) {
+            keys[i][slot] = SDL_SCANCODE_UNKNOWN;
+        }
+        buttons[i] = -1;
+        bufferWindow[i] = 0;
+        bufferedAt[i] = 0;
+        hasBuffered[i] = false;
+    }
+
+    // Gán mặc định giống điều khiển cũ, thêm phím mũi tên và tay cầm
+    BindKey(ACTION_MOVE_LEFT, 0, SDL_SCANCODE_A);
+    BindKey(ACTION_MOVE_LEFT, 1, SDL_SCANCODE_LEFT);
+    BindKey(ACTION_MOVE_RIGHT, 0, SDL_SCANCODE_D);
+    BindKey(ACTION_MOVE_RIGHT, 1, SDL_SCANCODE_RIGHT);
+    BindKey(ACTION_JUMP, 0, SDL_SCANCODE_SPACE);
+    BindKey(ACTION_ATTACK, 0, SDL_SCANCODE_J);
+    BindKey(ACTION_DASH, 0, SDL_SCANCODE_LSHIFT);
+    BindKey(ACTION_DASH, 1, SDL_SCANCODE_RSHIFT);
+    BindButton(ACTION_MOVE_LEFT, SDL_CONTROLLER_BUTTON_DPAD_LEFT);
+    BindButton(ACTION_MOVE_RIGHT, SDL_CONTROLLER_BUTTON_DPAD_RIGHT);
+    BindButton(ACTION_JUMP, SDL_CONTROLLER_BUTTON_A);
+    BindButton(ACTION_ATTACK, SDL_CONTROLLER_BUTTON_X);
+    BindButton(ACTION_DASH, SDL_CONTROLLER_BUTTON_RIGHTSHOULDER);
+    SetBufferWindow(ACTION_JUMP, DEFAULT_INPUT_BUFFER_MS);
+    SetBufferWindow(ACTION_ATTACK, DEFAULT_INPUT_BUFFER_MS);
+    SetBufferWindow(ACTION_DASH, DEFAULT_INPUT_BUFFER_MS);
+
+    OpenFirstController();
+}
+
+InputSystem::~InputSystem() {
+    if (controller) SDL_GameControllerClose(controller);
+}
+
+void InputSystem::OpenFirstController() {
+    for (int i = 0; i < SDL_NumJoysticks() && !controller; ++i) {
+        if (SDL_IsGameController(i)) {
+            controller = SDL_GameControllerOpen(i);
+            if (controller) std::cout << "Game controller " << i << " connected\n";
+        }
+    }
+}
+
+Uint32 InputSystem::ActionsForKey(SDL_Scancode key) const {
+    Uint32 actions = 0;
+    for (int i = 0; i < ACTION_COUNT; ++i) {
+        for (int slot = 0; slot < MAX_KEYS_PER_ACTION; ++slot) {
+            if (keys[i][slot] == key) actions |= ActionBit(i);
+        }
+    }
+    return actions;
+}
+
+Uint32 InputSystem::ActionsForButton(int button) const {
+    Uint32 actions = 0;
+    for (int i = 0; i < ACTION_COUNT; ++i) {
+        if (buttons[i] == button) actions |= ActionBit(i);
+    }
+    return actions;
+}
+
+void InputSystem::HandleEvent(const SDL_Event& e) {
+    if (e.type == SDL_KEYDOWN && !e.key.repeat) {
+        eventPressed |= ActionsForKey(e.key.keysym.scancode);
+    } else if (e.type == SDL_KEYUP) {
+        eventReleased |= ActionsForKey(e.key.keysym.scancode);
+    } else if (e.type == SDL_CONTROLLERBUTTONDOWN) {
+        eventPressed |= ActionsForButton(e.cbutton.button);
+    } else if (e.type == SDL_CONTROLLERBUTTONUP) {
+        eventReleased |= ActionsForButton(e.cbutton.button);
+    } else if (e.type == SDL_CONTROLLERDEVICEADDED) {
+        OpenFirstController();
+    } else if (e.type == SDL_CONTROLLERDEVICEREMOVED) {
+        // Không biết tay cầm nào bị rút: đóng tay cầm hiện tại rồi mở lại tay cầm còn lại (nếu có)
+        if (controller) {
+            SDL_GameControllerClose(controller);
+            controller = nullptr;
+            std::cout << "Game controller disconnected\n";
+        }
+        OpenFirstController();
+    }
+}
+
+InputFrame InputSystem::Sample(Uint32 now) {
+    Uint32 held = 0;
+    const Uint8* keyboard = SDL_GetKeyboardState(nullptr);
+    for (int i = 0; i < ACTION_COUNT; ++i) {
+        for (int slot = 0; slot < MAX_KEYS_PER_ACTION; ++slot) {
+            if (keys[i][slot] != SDL_SCANCODE_UNKNOWN && keyboard[keys[i][slot]]) held |= ActionBit(i);
+        }
+    }
+    if (controller) {
+        for (int i = 0; i < ACTION_COUNT; ++i) {
+            if (buttons[i] >= 0 && SDL_GameControllerGetButton(controller, static_cast<SDL_GameControllerButton>(buttons[i]))) {
+                held |= ActionBit(i);
+            }
+        }
+        Sint16 stickX = SDL_GameControllerGetAxis(controller, SDL_CONTROLLER_AXIS_LEFTX);
+        if (stickX < -STICK_DEADZONE) held |= ActionBit(ACTION_MOVE_LEFT);
+        if (stickX > STICK_DEADZONE) held |= ActionBit(ACTION_MOVE_RIGHT);
+    }
+
+    InputFrame frame;
+    frame.held = held;
+    frame.pressed = (held & ~previousHeld) | eventPressed;
+    frame.released = (previousHeld & ~held) | eventReleased;
+    frame.buffered = 0;
+    for (int i = 0; i < ACTION_COUNT; ++i) {
+        if (frame.pressed & ActionBit(i)) {
+            bufferedAt[i] = now;
+            hasBuffered[i] = true;
+        }
+        if (hasBuffered[i] && now - bufferedAt[i] > bufferWindow[i]) {
+            hasBuffered[i] = false;
+        }
+        if (hasBuffered[i]) frame.buffered |= ActionBit(i);
+    }
+
+    eventPressed = 0;
+    eventReleased = 0;
+    previousHeld = held;
+    return frame;
+}
+
+void InputSystem::Consume(Uint32 actions) {
+    for (int i = 0; i < ACTION_COUNT; ++i) {
+        if (actions & ActionBit(i)) hasBuffered[i] = false;
+    }
+}
+
+void InputSystem::BindKey(int action, int slot, SDL_Scancode key) {
+    if (action < 0 || action >= ACTION_COUNT || slot < 0 || slot >= MAX_KEYS_PER_ACTION) return;
+    keys[action][slot] = key;
+}
+
+void InputSystem::BindButton(int action, int button) {
+    if (action < 0 || action >= ACTION_COUNT) return;
+    buttons[action] = button;
+}
+
+void InputSystem::SetBufferWindow(int action, Uint32 milliseconds) {
+    if (action < 0 || action >= ACTION_COUNT) return;
+    bufferWindow[action] = milliseconds;
+}
+
+bool InputSystem::LoadBindings(const std::string& path) {
+    std::ifstream file(path.c_str());
+    if (!file) return false;
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        std::istringstream in(line);
+        std::string name, kind;
+        if (!(in >> name) || name[0] == '#') continue;
+
+        int action = FindInputAction(name.c_str());
+        if (action < 0 || !(in >> kind)) {
+            std::cout << "Input error: bad binding '" << line << "' (" << path << ":" << lineNumber << ")\n";
+            return false;
+        }
+
+        if (kind == "key") {
+            // Tên phím theo SDL, cách nhau bởi dấu phẩy vì tên có thể chứa khoảng trắng ("Left Shift")
+            std::string rest;
+            std::getline(in, rest);
+            std::istringstream names(rest);
+            std::string keyName;
+            int slot = 0;
+            while (std::getline(names, keyName, ',') && slot < MAX_KEYS_PER_ACTION) {
+                size_t first = keyName.find_first_not_of(" \t");
+                size_t last = keyName.find_last_not_of(" \t\r");
+                if (first == std::string::npos) continue;
+                keyName = keyName.substr(first, last - first + 1);
+                SDL_Scancode key = SDL_GetScancodeFromName(keyName.c_str());
+                if (key == SDL_SCANCODE_UNKNOWN) {
+                    std::cout << "Input error: unknown key '" << keyName << "' (" << path << ":" << lineNumber << ")\n";
+                    return false;
+                }
+                BindKey(action, slot++, key);
+            }
+            while (slot < MAX_KEYS_PER_ACTION) BindKey(action, slot++, SDL_SCANCODE_UNKNOWN);
+        } else if (kind == "button") {
+            int button;
+            if (!(in >> button)) {
+                std::cout << "Input error: bad button number (" << path << ":" << lineNumber << ")\n";
+                return false;
+            }
+            BindButton(action, button);
+        } else if (kind == "buffer") {
+            int milliseconds;
+            if (!(in >> milliseconds) || milliseconds < 0) {
+                std::cout << "Input error: bad buffer window (" << path << ":" << lineNumber << ")\n";
+                return false;
+            }
+            SetBufferWindow(action, static_cast<Uint32>(milliseconds));
+        } else {
+            std::cout << "Input error: unknown binding kind '" << kind << "' (" << path << ":" << lineNumber << ")\n";
+            return false;
+        }
+    }
+    std::cout << "Loaded input bindings from " << path << "\n";
+    return true;
+}
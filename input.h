@@ -0,0 +1,84 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <SDL.h>
+#include <string>
+
+// Hành động của người chơi; mô phỏng chỉ đọc hành động, không đọc phím
+enum InputAction {
+    ACTION_MOVE_LEFT = 0,
+    ACTION_MOVE_RIGHT,
+    ACTION_JUMP,
+    ACTION_ATTACK,
+    ACTION_DASH,
+    ACTION_COUNT
+};
+
+inline Uint32 ActionBit(int action) { return 1u << action; }
+
+// Input của một tick dưới dạng bitset theo InputAction. Là giá trị thuần nên có thể
+// ghi lại, phát lại và tạo ra trong mô phỏng không có cửa sổ.
+struct InputFrame {
+    Uint32 held;     // Đang giữ tại thời điểm lấy mẫu
+    Uint32 pressed;  // Vừa bấm trong tick (kể cả bấm rồi nhả trước khi lấy mẫu)
+    Uint32 released; // Vừa nhả trong tick
+    Uint32 buffered; // Đã bấm trong cửa sổ đệm và chưa được dùng
+
+    bool IsHeld(int action) const { return (held & ActionBit(action)) != 0; }
+    bool WasPressed(int action) const { return (pressed & ActionBit(action)) != 0; }
+    bool WasReleased(int action) const { return (released & ActionBit(action)) != 0; }
+    bool IsBuffered(int action) const { return (buffered & ActionBit(action)) != 0; }
+};
+
+// Số phím có thể gán cho một hành động
+const int MAX_KEYS_PER_ACTION = 2;
+// Cửa sổ đệm mặc định: bấm sớm hơn lúc hành động thực hiện được tối đa chừng này ms vẫn có hiệu lực
+const Uint32 DEFAULT_INPUT_BUFFER_MS = 150;
+// File gán phím tùy chọn
+const char* const INPUT_BINDINGS_PATH = "assets/input.txt";
+
+// Lấy mẫu bàn phím và tay cầm một lần mỗi tick thành InputFrame
+class InputSystem {
+private:
+    SDL_Scancode keys[ACTION_COUNT][MAX_KEYS_PER_ACTION]; // SDL_SCANCODE_UNKNOWN: ô trống
+    int buttons[ACTION_COUNT];                             // SDL_GameControllerButton, -1: không gán
+    Uint32 bufferWindow[ACTION_COUNT];                     // 0: không đệm
+    SDL_GameController* controller;
+
+    Uint32 eventPressed;  // Gom từ sự kiện giữa hai lần Sample, để lần bấm rất nhanh không bị mất
+    Uint32 eventReleased;
+    Uint32 previousHeld;
+    Uint32 bufferedAt[ACTION_COUNT];  // Thời điểm bấm còn chờ dùng
+    bool hasBuffered[ACTION_COUNT];
+
+    Uint32 ActionsForKey(SDL_Scancode key) const;
+    Uint32 ActionsForButton(int button) const;
+    void OpenFirstController();
+
+public:
+    InputSystem();
+    ~InputSystem();
+    InputSystem(const InputSystem&) = delete;
+    InputSystem& operator=(const InputSystem&) = delete;
+
+    // Nhận mọi sự kiện SDL; chỉ ghi nhận, trạng thái được tổng hợp ở Sample()
+    void HandleEvent(const SDL_Event& e);
+    // Lấy mẫu mọi thiết bị cho tick tại thời điểm now (ms)
+    InputFrame Sample(Uint32 now);
+    // Bỏ các lần bấm đã đệm của actions sau khi mô phỏng đã dùng chúng
+    void Consume(Uint32 actions);
+
+    // Gán phím thứ slot của action; SDL_SCANCODE_UNKNOWN để xóa
+    void BindKey(int action, int slot, SDL_Scancode key);
+    void BindButton(int action, int button);
+    void SetBufferWindow(int action, Uint32 milliseconds);
+    // Đọc file dạng "<hành động> key <tên phím> [tên phím]" / "<hành động> button <số>" /
+    // "<hành động> buffer <ms>", '#' mở đầu chú thích
+    bool LoadBindings(const std::string& path);
+};
+
+// Tên hành động dùng trong file gán phím ("move_left", "jump", ...)
+const char* GetInputActionName(int action);
+int FindInputAction(const char* name);
+
+#endif
@@ -0,0 +1,238 @@
+#include "job_system.h"
+#include <iostream>
+
+// Chỉ số hàng đợi của luồng hiện tại; luồng không thuộc JobSystem dùng hàng đợi 0
+static thread_local int currentWorker = 0;
+
+JobSystem::JobSystem(int workerCount)
+    : jobPool(new Job[MAX_JOBS]), nextJob(0), queuedJobs(0), running(true) {
+    if (workerCount < 0) {
+        int cores = static_cast<int>(std::thread::hardware_concurrency());
+        workerCount = cores > 2 ? cores - 2 : 0;
+    }
+
+    for (int i = 0; i <= workerCount; ++i) {
+        queues.push_back(new WorkerQueue());
+    }
+    for (int i = 1; i <= workerCount; ++i) {
+        workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+    }
+    std::cout << "JobSystem started with " << workerCount << " worker threads\n";
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        running = false;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    for (WorkerQueue* queue : queues) {
+        delete queue;
+    }
+    delete[] jobPool;
+}
+
+Job* JobSystem::AllocateJob() {
+    int index = nextJob.fetch_add(1);
+    if (index >= MAX_JOBS) {
+        std::cerr << "JobSystem: out of jobs (MAX_JOBS = " << MAX_JOBS << ")\n";
+        return nullptr;
+    }
+    Job* job = &jobPool[index];
+    job->task = nullptr;
+    job->range = nullptr;
+    job->begin = 0;
+    job->end = 0;
+    job->grain = 0;
+    job->parent = nullptr;
+    job->unfinished = 1;
+    job->pendingDeps = 1; // Giữ job cho đến khi nối xong mọi phụ thuộc
+    job->done = false;
+    job->continuationsClosed = false;
+    job->continuationCount = 0;
+    return job;
+}
+
+void JobSystem::AddDependencies(Job* job, std::initializer_list<JobHandle> dependencies) {
+    for (JobHandle dependency : dependencies) {
+        if (!dependency) continue;
+        bool full = false;
+        {
+            std::lock_guard<std::mutex> lock(dependency->continuationMutex);
+            if (dependency->continuationsClosed) continue;
+            if (dependency->continuationCount < MAX_JOB_CONTINUATIONS) {
+                job->pendingDeps.fetch_add(1);
+                dependency->continuations[dependency->continuationCount++] = job;
+            } else {
+                full = true;
+            }
+        }
+        if (full) {
+            // Hết chỗ nối: chờ phụ thuộc xong ngay tại đây để thứ tự vẫn đúng
+            std::cerr << "JobSystem: more than " << MAX_JOB_CONTINUATIONS << " jobs wait on one job\n";
+            Wait(dependency);
+        }
+    }
+}
+
+void JobSystem::Release(Job* job) {
+    if (job->pendingDeps.fetch_sub(1) == 1) {
+        Submit(job);
+    }
+}
+
+void JobSystem::Submit(Job* job) {
+    WorkerQueue* queue = queues[currentWorker];
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        queue->jobs[(queue->head + queue->count) % MAX_JOBS] = job;
+        queue->count++;
+    }
+    queuedJobs.fetch_add(1);
+    {
+        // Khóa ngắn để luồng đang chuẩn bị ngủ không bỏ lỡ thông báo
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    wake.notify_one();
+}
+
+void JobSystem::Finish(Job* job) {
+    if (job->unfinished.fetch_sub(1) != 1) return;
+
+    // Đọc hết dữ liệu cần dùng trước khi đánh dấu done: ngay sau đó luồng đang Wait
+    // có thể Reset() và ô job được cấp phát lại cho tick sau
+    Job* parent = job->parent;
+    Job* ready[MAX_JOB_CONTINUATIONS];
+    int readyCount;
+    {
+        std::lock_guard<std::mutex> lock(job->continuationMutex);
+        job->continuationsClosed = true;
+        readyCount = job->continuationCount;
+        for (int i = 0; i < readyCount; ++i) ready[i] = job->continuations[i];
+        job->continuationCount = 0;
+    }
+    job->done = true;
+
+    for (int i = 0; i < readyCount; ++i) {
+        Release(ready[i]);
+    }
+    if (parent) {
+        Finish(parent);
+    }
+}
+
+void JobSystem::Execute(Job* job) {
+    if (job->task) {
+        job->task();
+    } else if (job->range) {
+        // Job gốc của ParallelFor: tách thành các đoạn con, đoạn cuối chạy ngay tại đây
+        int start = job->begin;
+        while (job->end - start > job->grain) {
+            Job* chunk = AllocateJob();
+            if (!chunk) break;
+            chunk->parent = job;
+            chunk->begin = start;
+            chunk->end = start + job->grain;
+            job->unfinished.fetch_add(1);
+            Release(chunk);
+            start += job->grain;
+        }
+        job->range(start, job->end);
+    } else if (job->parent) {
+        job->parent->range(job->begin, job->end);
+    }
+    Finish(job);
+}
+
+Job* JobSystem::FindJob() {
+    int count = static_cast<int>(queues.size());
+
+    // Lấy việc mới nhất của chính mình (còn nóng trong cache)
+    WorkerQueue* own = queues[currentWorker];
+    {
+        std::lock_guard<std::mutex> lock(own->mutex);
+        if (own->count > 0) {
+            own->count--;
+            Job* job = own->jobs[(own->head + own->count) % MAX_JOBS];
+            queuedJobs.fetch_sub(1);
+            return job;
+        }
+    }
+
+    // Trộm việc cũ nhất của luồng khác
+    for (int i = 1; i < count; ++i) {
+        WorkerQueue* victim = queues[(currentWorker + i) % count];
+        std::lock_guard<std::mutex> lock(victim->mutex);
+        if (victim->count > 0) {
+            Job* job = victim->jobs[victim->head];
+            victim->head = (victim->head + 1) % MAX_JOBS;
+            victim->count--;
+            queuedJobs.fetch_sub(1);
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+void JobSystem::WorkerLoop(int index) {
+    currentWorker = index;
+    while (running) {
+        Job* job = FindJob();
+        if (job) {
+            Execute(job);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this] { return queuedJobs > 0 || !running; });
+    }
+}
+
+JobHandle JobSystem::Schedule(JobFunc task, std::initializer_list<JobHandle> dependencies) {
+    Job* job = AllocateJob();
+    if (!job) {
+        // Hết chỗ: chạy đồng bộ để tick vẫn đúng
+        for (JobHandle dependency : dependencies) Wait(dependency);
+        task();
+        return nullptr;
+    }
+    job->task = task;
+    AddDependencies(job, dependencies);
+    Release(job);
+    return job;
+}
+
+JobHandle JobSystem::ParallelFor(int count, int grain, JobRangeFunc range,
+                                 std::initializer_list<JobHandle> dependencies) {
+    if (grain < 1) grain = 1;
+    Job* job = AllocateJob();
+    if (!job) {
+        for (JobHandle dependency : dependencies) Wait(dependency);
+        if (count > 0) range(0, count);
+        return nullptr;
+    }
+    job->range = range;
+    job->end = count;
+    job->grain = grain;
+    AddDependencies(job, dependencies);
+    Release(job);
+    return job;
+}
+
+void JobSystem::Wait(JobHandle job) {
+    if (!job) return;
+    while (!job->done) {
+        Job* other = FindJob();
+        if (other) {
+            Execute(other);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::Reset() {
+    nextJob = 0;
+}
@@ -0,0 +1,92 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Số job tối đa trong một tick; bộ nhớ job được cấp phát một lần và tái sử dụng sau Reset()
+const int MAX_JOBS = 4096;
+// Số phần tử tối thiểu của một đoạn trong ParallelFor; ít hơn thì chạy ngay trên luồng gọi
+const int DEFAULT_JOB_GRAIN = 16;
+// Số job tối đa chờ trực tiếp một job; lưu trong mảng cố định của Job nên nối phụ thuộc không cấp phát
+const int MAX_JOB_CONTINUATIONS = 8;
+
+typedef std::function<void()> JobFunc;
+typedef std::function<void(int begin, int end)> JobRangeFunc;
+
+// Một nút trong đồ thị công việc
+struct Job {
+    JobFunc task;                  // Thân job thường
+    JobRangeFunc range;            // Thân ParallelFor, các đoạn con dùng chung qua parent
+    int begin;
+    int end;
+    int grain;                     // Kích thước đoạn của job gốc ParallelFor
+    Job* parent;                   // Job cha nhận thông báo khi job con xong
+    std::atomic<int> unfinished;   // 1 cho chính job + số job con chưa xong
+    std::atomic<int> pendingDeps;  // Số phụ thuộc chưa xong; job được đưa vào hàng đợi khi về 0
+    std::atomic<bool> done;        // Ghi cuối cùng: sau đó luồng chạy job không chạm vào job nữa
+    std::mutex continuationMutex;
+    bool continuationsClosed;      // Không nhận thêm continuation (bảo vệ bởi continuationMutex)
+    Job* continuations[MAX_JOB_CONTINUATIONS]; // Các job chờ job này
+    int continuationCount;
+};
+
+typedef Job* JobHandle;
+
+// Bộ lập lịch work-stealing: mỗi luồng có hàng đợi riêng, lấy việc ở cuối hàng đợi của mình
+// và trộm ở đầu hàng đợi của luồng khác khi hết việc. Luồng gọi Wait() (luồng mô phỏng)
+// cũng tham gia chạy job thay vì đứng chờ.
+class JobSystem {
+private:
+    // Vòng đệm cố định thay cho std::deque để đưa/lấy job không cấp phát heap;
+    // một tick có tối đa MAX_JOBS job nên hàng đợi không bao giờ đầy
+    struct WorkerQueue {
+        std::mutex mutex;
+        Job* jobs[MAX_JOBS];
+        int head;  // Job cũ nhất
+        int count;
+        WorkerQueue() : head(0), count(0) {}
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<WorkerQueue*> queues; // queues[0] thuộc luồng sở hữu JobSystem
+    Job* jobPool;
+    std::atomic<int> nextJob;
+    std::atomic<int> queuedJobs;
+    std::atomic<bool> running;
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+
+    Job* AllocateJob();
+    void AddDependencies(Job* job, std::initializer_list<JobHandle> dependencies);
+    void Release(Job* job);   // Bỏ một phụ thuộc; đưa job vào hàng đợi khi hết phụ thuộc
+    void Submit(Job* job);
+    void Finish(Job* job);
+    void Execute(Job* job);
+    Job* FindJob();
+    void WorkerLoop(int index);
+
+public:
+    // workerCount < 0: dùng số lõi trừ luồng mô phỏng và luồng render
+    explicit JobSystem(int workerCount = -1);
+    ~JobSystem();
+
+    int GetThreadCount() const { return static_cast<int>(queues.size()); }
+
+    // Tạo job chạy task sau khi mọi dependencies hoàn tất
+    JobHandle Schedule(JobFunc task, std::initializer_list<JobHandle> dependencies = {});
+    // Chia [0, count) thành các đoạn grain phần tử và chạy song song; handle hoàn tất khi mọi đoạn xong
+    JobHandle ParallelFor(int count, int grain, JobRangeFunc range,
+                          std::initializer_list<JobHandle> dependencies = {});
+    // Chờ job hoàn tất, trong lúc chờ luồng gọi chạy các job khác
+    void Wait(JobHandle job);
+    // Thu hồi toàn bộ job của tick; chỉ gọi khi mọi job đã Wait xong
+    void Reset();
+};
+
+#endif
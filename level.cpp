@@ -0,0 +1,195 @@
+#include "level.h"
+#include "physics.h"
+#include "sprites.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+std::string GetLevelPath(int levelNumber) {
+    std::ostringstream path;
+    path << "assets/levels/level" << levelNumber << ".txt";
+    return path.str();
+}
+
+static bool ReadTilemapRows(std::ifstream& file, int& lineNumber, Level& level,
+                            int cols, int rows, int tileWidth, int tileHeight, int originX, int originY) {
+    std::string row;
+    for (int r = 0; r < rows; ++r) {
+        if (!std::getline(file, row)) {
+            std::cout << "Level error: tilemap expects " << rows << " rows, got " << r << "\n";
+            return false;
+        }
+        lineNumber++;
+
+        int runStart = -1;
+        for (int c = 0; c <= cols; ++c) {
+            bool solid = c < cols && c < static_cast<int>(row.size()) && row[c] == '#';
+            if (solid) {
+                SDL_Rect tileRect = {originX + c * tileWidth, originY + r * tileHeight, tileWidth, tileHeight};
+                level.tiles.push_back({tileRect, SPRITE_PLATFORM});
+                if (runStart < 0) runStart = c;
+            } else if (runStart >= 0) {
+                // Gộp các ô liền nhau thành một nền tảng để giảm số hình va chạm
+                SDL_Rect solidRect = {originX + runStart * tileWidth, originY + r * tileHeight,
+                                      (c - runStart) * tileWidth, tileHeight};
+                level.solids.push_back(solidRect);
+                runStart = -1;
+            }
+        }
+    }
+    return true;
+}
+
+bool LoadLevel(const std::string& path, Level& level) {
+    std::ifstream file(path.c_str());
+    if (!file) {
+        std::cout << "Level error: cannot open " << path << "\n";
+        return false;
+    }
+
+    Level loaded;
+    loaded.width = SCREEN_WIDTH;
+    loaded.height = SCREEN_HEIGHT;
+    loaded.groundY = GROUND_Y;
+    loaded.background = SPRITE_NONE;
+    loaded.playerSpawn = {120, 400};
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        std::istringstream in(line);
+        std::string command;
+        if (!(in >> command) || command[0] == '#') continue;
+
+        bool ok = true;
+        if (command == "size") {
+            ok = static_cast<bool>(in >> loaded.width >> loaded.height);
+        } else if (command == "ground") {
+            ok = static_cast<bool>(in >> loaded.groundY);
+        } else if (command == "background") {
+            std::string image;
+            ok = static_cast<bool>(in >> image);
+            loaded.background = FindSpriteByPath(image.c_str());
+            if (ok && loaded.background == SPRITE_NONE) {
+                std::cout << "Level error: unknown background " << image << " (" << path << ":" << lineNumber << ")\n";
+                return false;
+            }
+        } else if (command == "parallax") {
+            std::string image;
+            ParallaxLayer layer;
+            ok = static_cast<bool>(in >> image >> layer.percent);
+            layer.sprite = FindSpriteByPath(image.c_str());
+            if (ok && layer.sprite == SPRITE_NONE) {
+                std::cout << "Level error: unknown parallax image " << image << " (" << path << ":" << lineNumber << ")\n";
+                return false;
+            }
+            if (ok) {
+                if (layer.percent < 0) layer.percent = 0;
+                if (layer.percent > 100) layer.percent = 100;
+                loaded.parallax.push_back(layer);
+            }
+        } else if (command == "player") {
+            ok = static_cast<bool>(in >> loaded.playerSpawn.x >> loaded.playerSpawn.y);
+        } else if (command == "boss") {
+            BossPlacement boss;
+            ok = static_cast<bool>(in >> boss.kind >> boss.x >> boss.y);
+            if (ok) loaded.bosses.push_back(boss);
+        } else if (command == "wave") {
+            WavePlacement wave;
+            ok = static_cast<bool>(in >> wave.delay >> wave.kind >> wave.count >> wave.x >> wave.y >> wave.spacing);
+            if (ok && wave.count > 0) loaded.waves.push_back(wave);
+        } else if (command == "platform") {
+            SDL_Rect rect;
+            ok = static_cast<bool>(in >> rect.x >> rect.y >> rect.w >> rect.h);
+            if (ok && rect.w > 0 && rect.h > 0) {
+                loaded.tiles.push_back({rect, SPRITE_PLATFORM});
+                loaded.solids.push_back(rect);
+            }
+        } else if (command == "decor") {
+            std::string image;
+            SDL_Rect rect;
+            ok = static_cast<bool>(in >> image >> rect.x >> rect.y >> rect.w >> rect.h);
+            int sprite = FindSpriteByPath(image.c_str());
+            if (ok && sprite == SPRITE_NONE) {
+                std::cout << "Level error: unknown decor image " << image << " (" << path << ":" << lineNumber << ")\n";
+                return false;
+            }
+            if (ok && rect.w > 0 && rect.h > 0) loaded.tiles.push_back({rect, sprite});
+        } else if (command == "tilemap") {
+            int cols, rows, tileWidth, tileHeight, originX, originY;
+            ok = static_cast<bool>(in >> cols >> rows >> tileWidth >> tileHeight >> originX >> originY);
+            if (ok && !ReadTilemapRows(file, lineNumber, loaded, cols, rows, tileWidth, tileHeight, originX, originY)) {
+                return false;
+            }
+        } else {
+            std::cout << "Level error: unknown command '" << command << "' (" << path << ":" << lineNumber << ")\n";
+            return false;
+        }
+
+        if (!ok) {
+            std::cout << "Level error: bad arguments for '" << command << "' (" << path << ":" << lineNumber << ")\n";
+            return false;
+        }
+    }
+
+    if (loaded.bosses.empty() && loaded.waves.empty()) {
+        std::cout << "Level error: " << path << " has no boss or wave\n";
+        return false;
+    }
+
+    // Lưới phủ cả vùng phía trên màn để vật đang nhảy vẫn truy vấn đúng
+    SDL_Rect area = {0, -loaded.height, loaded.width, loaded.height * 2};
+    std::vector<SDL_Rect> tileRects;
+    for (const LevelTile& tile : loaded.tiles) {
+        tileRects.push_back(tile.rect);
+    }
+    loaded.tileGrid.Build(tileRects, area, LEVEL_CELL_SIZE);
+    loaded.solidGrid.Build(loaded.solids, area, LEVEL_CELL_SIZE);
+
+    level = loaded;
+    std::cout << "Loaded level " << path << ": " << loaded.tiles.size() << " tiles, "
+              << loaded.solids.size() << " solids\n";
+    return true;
+}
+
+static RenderItem MakeStaticSprite(int sprite, const SDL_Rect& dst) {
+    RenderItem item;
+    item.sprite = static_cast<Uint16>(sprite);
+    item.kind = RENDER_SPRITE;
+    item.layer = 0;
+    item.flip = SDL_FLIP_NONE;
+    item.color = {255, 255, 255, 255};
+    item.src = {0, 0, 0, 0};
+    item.dst = dst;
+    return item;
+}
+
+void BuildStaticScene(const Level& level, int viewWidth, int viewHeight, StaticScene& scene) {
+    scene.layers.clear();
+
+    if (level.background != SPRITE_NONE) {
+        StaticLayer background = {0, LAYER_BACKGROUND, viewWidth, viewHeight, {}};
+        SDL_Rect screenRect = {0, 0, viewWidth, viewHeight};
+        background.items.push_back(MakeStaticSprite(level.background, screenRect));
+        scene.layers.push_back(background);
+    }
+
+    // Lớp parallax chỉ cần đủ lớn cho quãng cuộn của nó: camera đi hết màn thì lớp đi percent%
+    for (const ParallaxLayer& parallax : level.parallax) {
+        int width = viewWidth + (level.width > viewWidth ? (level.width - viewWidth) * parallax.percent / 100 : 0);
+        int height = viewHeight + (level.height > viewHeight ? (level.height - viewHeight) * parallax.percent / 100 : 0);
+        StaticLayer layer = {parallax.percent, LAYER_BACKGROUND, width, height, {}};
+        SDL_Rect layerRect = {0, 0, width, height};
+        layer.items.push_back(MakeStaticSprite(parallax.sprite, layerRect));
+        scene.layers.push_back(layer);
+    }
+
+    if (!level.tiles.empty()) {
+        StaticLayer world = {100, LAYER_PLATFORM, level.width, level.height, {}};
+        for (const LevelTile& tile : level.tiles) {
+            world.items.push_back(MakeStaticSprite(tile.sprite, tile.rect));
+        }
+        scene.layers.push_back(world);
+    }
+}
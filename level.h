@@ -0,0 +1,84 @@
+#ifndef LEVEL_H
+#define LEVEL_H
+
+#include <SDL.h>
+#include <string>
+#include <vector>
+#include "render_list.h"
+#include "spatial_grid.h"
+
+// Kích thước ô của lưới không gian cho hình học tĩnh
+const int LEVEL_CELL_SIZE = 128;
+
+// Một ô hoặc vật thể tĩnh được vẽ
+struct LevelTile {
+    SDL_Rect rect;
+    int sprite;
+};
+
+// Lớp ảnh xa cuộn chậm hơn thế giới; percent là tốc độ cuộn so với camera (0..100)
+struct ParallaxLayer {
+    int sprite;
+    int percent;
+};
+
+// Vị trí đặt boss; kind là loại boss theo màn (1 hoặc 2)
+struct BossPlacement {
+    int kind;
+    int x;
+    int y;
+};
+
+// Một đợt kẻ địch: count con loại kind xếp hàng từ (x, y), cách nhau spacing theo chiều ngang.
+// Các wave chạy lần lượt: wave bắt đầu khi mọi kẻ địch trước đó đã bị hạ và đã qua delay ms
+struct WavePlacement {
+    Uint32 delay;
+    int kind;
+    int count;
+    int x;
+    int y;
+    int spacing;
+};
+
+// Dữ liệu màn chơi nạp từ file. Định dạng văn bản, mỗi dòng một lệnh, '#' mở đầu chú thích:
+//   size <rộng> <cao>
+//   ground <y>
+//   background <đường dẫn ảnh>
+//   parallax <đường dẫn ảnh> <phần trăm>     lớp ảnh xa, vẽ theo thứ tự khai báo
+//   player <x> <y>
+//   boss <loại> <x> <y>                      loại 1, 2: boss của màn 1, 2; loại 3: MiniBoss
+//   wave <delay ms> <loại> <số lượng> <x> <y> <khoảng cách>
+//   platform <x> <y> <w> <h>                 nền tảng một chiều, vẽ bằng ảnh platform
+//   decor <đường dẫn ảnh> <x> <y> <w> <h>     vật trang trí, không va chạm
+//   tilemap <cột> <hàng> <rộng ô> <cao ô> <x> <y>
+//   <hàng ký tự>...                          '#' là ô nền tảng, '.' là ô trống
+// Các ô '#' liền nhau trên một hàng được gộp thành một nền tảng va chạm.
+struct Level {
+    int width;
+    int height;
+    int groundY;
+    int background;                    // SpriteId của ảnh nền
+    std::vector<ParallaxLayer> parallax;
+    SDL_Point playerSpawn;
+    std::vector<BossPlacement> bosses;
+    std::vector<WavePlacement> waves;
+    std::vector<LevelTile> tiles;      // Mọi thứ được vẽ, đánh chỉ mục trong tileGrid
+    std::vector<SDL_Rect> solids;      // Nền tảng va chạm, đánh chỉ mục trong solidGrid
+    StaticGrid tileGrid;
+    StaticGrid solidGrid;
+};
+
+// Số màn của game, đánh số từ 1
+const int LEVEL_COUNT = 2;
+// Màn thử tải với hàng trăm kẻ địch (--stress), chơi theo luật của màn cuối
+const char* const STRESS_LEVEL_PATH = "assets/levels/stress.txt";
+
+// Đường dẫn file của màn số levelNumber
+std::string GetLevelPath(int levelNumber);
+// Nạp và xây chỉ mục không gian; trả về false và giữ nguyên level nếu file lỗi
+bool LoadLevel(const std::string& path, Level& level);
+// Chia phần tĩnh của màn thành các lớp cho luồng render dựng cache: nền đứng yên,
+// mỗi lớp parallax, rồi lớp thế giới chứa mọi ô và vật trang trí
+void BuildStaticScene(const Level& level, int viewWidth, int viewHeight, StaticScene& scene);
+
+#endif
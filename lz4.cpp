@@ -0,0 +1,139 @@
+#include "lz4.h"
+#include <cstring>
+#include <vector>
+
+// Giới hạn của định dạng khối LZ4
+const int LZ4_MIN_MATCH = 4;
+const int LZ4_LAST_LITERALS = 5; // 5 byte cuối luôn là literal
+const int LZ4_MFLIMIT = 12;      // Match cuối phải bắt đầu trước 12 byte cuối
+const int LZ4_MAX_OFFSET = 65535;
+const int LZ4_HASH_BITS = 16;
+
+static Uint32 Read32(const Uint8* p) {
+    Uint32 value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static int Hash(Uint32 sequence) {
+    return static_cast<int>((sequence * 2654435761u) >> (32 - LZ4_HASH_BITS));
+}
+
+// Ghi phần dư của độ dài (đã trừ 15) thành chuỗi byte 255 ... n
+static int WriteLength(Uint8* dst, int length) {
+    int written = 0;
+    while (length >= 255) {
+        dst[written++] = 255;
+        length -= 255;
+    }
+    dst[written++] = static_cast<Uint8>(length);
+    return written;
+}
+
+int Lz4CompressBound(int inputSize) {
+    return inputSize + inputSize / 255 + 16;
+}
+
+int Lz4Compress(const Uint8* src, int srcSize, Uint8* dst, int dstCapacity) {
+    if (srcSize < 0 || dstCapacity < Lz4CompressBound(srcSize)) return 0;
+
+    std::vector<int> table(1 << LZ4_HASH_BITS, -1); // Vị trí gần nhất của mỗi chuỗi 4 byte
+    int ip = 0;
+    int anchor = 0; // Đầu đoạn literal chưa ghi
+    int op = 0;
+
+    if (srcSize > LZ4_MFLIMIT) {
+        int matchLimit = srcSize - LZ4_LAST_LITERALS;
+        int searchEnd = srcSize - LZ4_MFLIMIT;
+        while (ip <= searchEnd) {
+            Uint32 sequence = Read32(src + ip);
+            int h = Hash(sequence);
+            int candidate = table[h];
+            table[h] = ip;
+            if (candidate < 0 || ip - candidate > LZ4_MAX_OFFSET || Read32(src + candidate) != sequence) {
+                ip++;
+                continue;
+            }
+
+            int matchLength = LZ4_MIN_MATCH;
+            while (ip + matchLength < matchLimit && src[candidate + matchLength] == src[ip + matchLength]) {
+                matchLength++;
+            }
+
+            // Token: 4 bit cao là độ dài literal, 4 bit thấp là độ dài match - 4
+            int literalLength = ip - anchor;
+            int extraMatch = matchLength - LZ4_MIN_MATCH;
+            Uint8* token = dst + op++;
+            *token = static_cast<Uint8>((literalLength < 15 ? literalLength : 15) << 4);
+            if (literalLength >= 15) op += WriteLength(dst + op, literalLength - 15);
+            std::memcpy(dst + op, src + anchor, literalLength);
+            op += literalLength;
+
+            int offset = ip - candidate;
+            dst[op++] = static_cast<Uint8>(offset & 0xFF);
+            dst[op++] = static_cast<Uint8>(offset >> 8);
+            *token |= static_cast<Uint8>(extraMatch < 15 ? extraMatch : 15);
+            if (extraMatch >= 15) op += WriteLength(dst + op, extraMatch - 15);
+
+            ip += matchLength;
+            anchor = ip;
+        }
+    }
+
+    // Đoạn literal cuối
+    int literalLength = srcSize - anchor;
+    dst[op++] = static_cast<Uint8>((literalLength < 15 ? literalLength : 15) << 4);
+    if (literalLength >= 15) op += WriteLength(dst + op, literalLength - 15);
+    if (literalLength > 0) std::memcpy(dst + op, src + anchor, literalLength);
+    op += literalLength;
+    return op;
+}
+
+// Đọc phần dư của độ dài; trả về false nếu hết dữ liệu
+static bool ReadLength(const Uint8* src, int srcSize, int& ip, int& length) {
+    Uint8 value;
+    do {
+        if (ip >= srcSize) return false;
+        value = src[ip++];
+        length += value;
+    } while (value == 255);
+    return true;
+}
+
+int Lz4Decompress(const Uint8* src, int srcSize, Uint8* dst, int dstCapacity) {
+    int ip = 0;
+    int op = 0;
+    while (ip < srcSize) {
+        int token = src[ip++];
+
+        int literalLength = token >> 4;
+        if (literalLength == 15 && !ReadLength(src, srcSize, ip, literalLength)) return -1;
+        if (literalLength > srcSize - ip || literalLength > dstCapacity - op) return -1;
+        std::memcpy(dst + op, src + ip, literalLength);
+        ip += literalLength;
+        op += literalLength;
+
+        if (ip == srcSize) break; // Chuỗi cuối chỉ có literal
+        if (srcSize - ip < 2) return -1;
+        int offset = src[ip] | (src[ip + 1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > op) return -1;
+
+        int matchLength = token & 15;
+        if (matchLength == 15 && !ReadLength(src, srcSize, ip, matchLength)) return -1;
+        matchLength += LZ4_MIN_MATCH;
+        if (matchLength > dstCapacity - op) return -1;
+
+        const Uint8* match = dst + op - offset;
+        if (offset >= matchLength) {
+            std::memcpy(dst + op, match, matchLength);
+        } else {
+            // Match chồng lên chính phần đang ghi (lặp mẫu ngắn): phải chép từng byte
+            for (int i = 0; i < matchLength; ++i) {
+                dst[op + i] = match[i];
+            }
+        }
+        op += matchLength;
+    }
+    return op;
+}
@@ -0,0 +1,17 @@
+#ifndef LZ4_H
+#define LZ4_H
+
+#include <SDL.h>
+
+// Nén và giải nén theo định dạng khối LZ4 (không có frame header), đủ cho gói asset.
+// Bộ nén tham lam đơn giản chỉ chạy lúc đóng gói; bộ giải nén kiểm tra biên nên an toàn
+// với dữ liệu hỏng.
+
+// Kích thước tối đa của dữ liệu nén cho inputSize byte đầu vào
+int Lz4CompressBound(int inputSize);
+// Nén src vào dst, trả về số byte đã ghi hoặc 0 nếu dst không đủ chỗ
+int Lz4Compress(const Uint8* src, int srcSize, Uint8* dst, int dstCapacity);
+// Giải nén src vào dst, trả về số byte đã ghi hoặc -1 nếu dữ liệu hỏng hoặc dst không đủ chỗ
+int Lz4Decompress(const Uint8* src, int srcSize, Uint8* dst, int dstCapacity);
+
+#endif
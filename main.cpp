@@ -6,90 +6,72 @@
 #include <string>
 #include <cstdlib>
 #include <ctime>
-#include "boss.h"
-#include "player.h"
 #include "gui.h"
-
-// Screen dimensions
-const int SCREEN_WIDTH = 1200;
-const int SCREEN_HEIGHT = 600;
+#include "physics.h"
+#include "job_system.h"
+#include "render_thread.h"
+#include "sprites.h"
+#include "frame_arena.h"
+#include "file_watcher.h"
+#include "input.h"
+#include "replay.h"
+#include "event_bus.h"
+#include "scene.h"
+#include "game_scenes.h"
+#include "metrics.h"
+#include "frame_capture.h"
+#include "golden.h"
 
 // Global SDL variables
 SDL_Window* g_window = nullptr;
-SDL_Renderer* g_renderer = nullptr;
-SDL_Texture* level1Background = nullptr;
-SDL_Texture* level2Background = nullptr;
-SDL_Texture* platformTexture = nullptr;
-SDL_Texture* heartTexture = nullptr;
-SDL_Texture* gameOverTexture = nullptr;
-SDL_Texture* levelCompleteTexture = nullptr;
-SDL_Texture* gameCompleteTexture = nullptr;
-
-// Boss textures cho các màn
-SDL_Texture* boss1Idle = nullptr;
-SDL_Texture* boss1RunSheet = nullptr;
-SDL_Texture* boss1AttackSheet = nullptr;
-SDL_Texture* boss1JumpSheet = nullptr;
-SDL_Texture* boss1DamageSheet = nullptr;
-SDL_Texture* boss1DeathSheet = nullptr;
-SDL_Texture* boss1DiveSheet = nullptr;
-SDL_Texture* boss2Idle = nullptr;
-SDL_Texture* boss2RunSheet = nullptr;
-SDL_Texture* boss2AttackSheet = nullptr;
-SDL_Texture* boss2JumpSheet = nullptr;
-SDL_Texture* boss2DamageSheet = nullptr;
-SDL_Texture* boss2DeathSheet = nullptr;
-
-// MiniBoss textures
-SDL_Texture* miniBossIdle = nullptr;
-SDL_Texture* miniBossRunSheet = nullptr;
-SDL_Texture* miniBossAttackSheet = nullptr;
-SDL_Texture* miniBossJumpSheet = nullptr;
-SDL_Texture* miniBossDamageSheet = nullptr;
-SDL_Texture* miniBossDeathSheet = nullptr;
-SDL_Texture* miniBossDiveSheet = nullptr;
-SDL_Texture* miniBossShootSheet = nullptr;
-SDL_Texture* miniBossArrowTexture = nullptr;
-
-// Platforms cho các màn
-SDL_Rect level1Platforms[] = {
-    {0, 0, 0, 0},
-    {0, 0, 0, 0},
-    {0, 0, 0, 0}
-};
 
-SDL_Rect level2Platforms[] = {
-    {0, 0, 0, 0},
-    {0, 0, 0, 0},
-    {0, 0, 0, 0}
+// Màn bắt đầu của một trận mới
+const int FIRST_LEVEL = 1;
+
+// Âm thanh phản ứng theo lô sự kiện của tick, gameplay không cần biết tới audio
+struct GameAudio {
+    const GUI* gui;
+    Mix_Chunk* attackSound;
+    Mix_Chunk* gameOverSound;
 };
 
-// Game state
-int currentLevel = 1;
-bool levelTransition = false;
-bool showGameOver = false;
-bool showLevelComplete = false;
-bool showGameComplete = false;
-const Uint32 FRAME_DELAY = 70;
-const int DEATH_FRAME_COUNT = 4;
-const Uint32 LEVEL_COMPLETE_DURATION = 3000;
-const Uint32 GAME_COMPLETE_DURATION = 3000;
-
-bool Init() {
-    if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0) {
+void PlayEventSounds(void* context, const GameEvent* events, int count) {
+    const GameAudio* audio = static_cast<const GameAudio*>(context);
+    if (!audio->gui->IsSoundEnabled()) return;
+    for (int i = 0; i < count; ++i) {
+        const GameEvent& event = events[i];
+        if (event.type == EVENT_ATTACK_STARTED && event.team == TEAM_PLAYER) {
+            Mix_PlayChannel(-1, audio->attackSound, 0);
+            std::cout << "Player attack sound played\n";
+        } else if (event.type == EVENT_DIED && event.team == TEAM_PLAYER) {
+            Mix_PlayChannel(-1, audio->gameOverSound, 0);
+            std::cout << "Game Over sound played\n";
+        } else if (event.type == EVENT_GAME_COMPLETED) {
+            Mix_PlayChannel(-1, audio->gameOverSound, 0);
+            std::cout << "Game Complete sound played\n";
+        }
+    }
+}
+
+// headless: không mở cửa sổ hay thiết bị âm thanh thật (máy chủ, CI); vẫn render bằng renderer phần mềm
+// Cửa sổ thường đổi được kích thước; game luôn vẽ ở độ phân giải logic SCREEN_WIDTH x SCREEN_HEIGHT
+bool Init(bool headless, bool fullscreen) {
+    if (headless) {
+        SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+        SDL_SetHint(SDL_HINT_AUDIODRIVER, "dummy");
+    }
+    if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO | SDL_INIT_GAMECONTROLLER) < 0) {
         std::cout << "SDL_Init Error: " << SDL_GetError() << "\n";
         return false;
     }
-    g_window = SDL_CreateWindow("SDL2 Spritesheet Animation", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN);
+    Uint32 windowFlags = SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE;
+    if (fullscreen) windowFlags |= SDL_WINDOW_FULLSCREEN_DESKTOP;
+    g_window = SDL_CreateWindow("SDL2 Spritesheet Animation", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, SCREEN_WIDTH, SCREEN_HEIGHT,
+                                headless ? SDL_WINDOW_HIDDEN : windowFlags);
     if (!g_window) {
         std::cout << "SDL_CreateWindow Error: " << SDL_GetError() << "\n";
         return false;
     }
-    g_renderer = SDL_CreateRenderer(g_window, -1, SDL_RENDERER_ACCELERATED);
-    if (!g_renderer) {
-        std::cout << "SDL_CreateRenderer Error: " << SDL_GetError() << "\n";
-        return false;
-    }
     if (!(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG)) {
         std::cout << "IMG_Init Error: " << IMG_GetError() << "\n";
         return false;
@@ -109,113 +91,7 @@ bool Init() {
     return true;
 }
 
-SDL_Texture* LoadTexture(const std::string& path) {
-    SDL_Surface* surface = IMG_Load(path.c_str());
-    if (!surface) {
-        std::cout << "IMG_Load Error: " << IMG_GetError() << " (file: " << path << ")\n";
-        return nullptr;
-    }
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(g_renderer, surface);
-    SDL_FreeSurface(surface);
-    if (!texture) {
-        std::cout << "SDL_CreateTextureFromSurface Error: " << SDL_GetError() << " (file: " << path << ")\n";
-    } else {
-        std::cout << "Successfully loaded texture: " << path << "\n";
-    }
-    return texture;
-}
-
-bool LoadAssets(SDL_Texture*& playerIdle, SDL_Texture*& runSheet, SDL_Texture*& attackSheet,
-                SDL_Texture*& jumpSheet, SDL_Texture*& damageSheet,
-                SDL_Texture*& deathSheet) {
-    level1Background = LoadTexture("assets/map_and_objects/level1_background.png");
-    level2Background = LoadTexture("assets/map_and_objects/level2_background.png");
-    platformTexture = LoadTexture("assets/map_and_objects/platform.png");
-    heartTexture = LoadTexture("assets/map_and_objects/heart.png");
-    gameOverTexture = LoadTexture("assets/map_and_objects/game_over.png");
-    levelCompleteTexture = LoadTexture("assets/map_and_objects/level_complete.png");
-    gameCompleteTexture = LoadTexture("assets/map_and_objects/game_complete.png");
-    playerIdle = LoadTexture("assets/player_assets/idle.png");
-    runSheet = LoadTexture("assets/player_assets/run.png");
-    attackSheet = LoadTexture("assets/player_assets/attack.png");
-    jumpSheet = LoadTexture("assets/player_assets/jump.png");
-    damageSheet = LoadTexture("assets/player_assets/damage.png");
-    deathSheet = LoadTexture("assets/player_assets/death.png");
-    // Boss màn 1
-    boss1Idle = LoadTexture("assets/boss_assets/boss1/idle.png");
-    boss1RunSheet = LoadTexture("assets/boss_assets/boss1/run.png");
-    boss1AttackSheet = LoadTexture("assets/boss_assets/boss1/attack.png");
-    boss1JumpSheet = LoadTexture("assets/boss_assets/boss1/jump.png");
-    boss1DamageSheet = LoadTexture("assets/boss_assets/boss1/damage.png");
-    boss1DeathSheet = LoadTexture("assets/boss_assets/boss1/death.png");
-    boss1DiveSheet = LoadTexture("assets/boss_assets/boss1/dive.png");
-    // Boss màn 2
-    boss2Idle = LoadTexture("assets/boss_assets/boss2/idle.png");
-    boss2RunSheet = LoadTexture("assets/boss_assets/boss2/run.png");
-    boss2AttackSheet = LoadTexture("assets/boss_assets/boss2/attack.png");
-    boss2JumpSheet = LoadTexture("assets/boss_assets/boss2/jump.png");
-    boss2DamageSheet = LoadTexture("assets/boss_assets/boss2/damage.png");
-    boss2DeathSheet = LoadTexture("assets/boss_assets/boss2/death.png");
-    // MiniBoss textures
-    miniBossIdle = LoadTexture("assets/miniboss/idle.png");
-    miniBossRunSheet = LoadTexture("assets/miniboss/run.png");
-    miniBossAttackSheet = LoadTexture("assets/miniboss/attack.png");
-    miniBossJumpSheet = LoadTexture("assets/miniboss/jump.png");
-    miniBossDamageSheet = LoadTexture("assets/miniboss/damage.png");
-    miniBossDeathSheet = LoadTexture("assets/miniboss/death.png");
-    miniBossDiveSheet = LoadTexture("assets/miniboss/dive.png");
-    miniBossShootSheet = LoadTexture("assets/miniboss/shoot.png");
-    miniBossArrowTexture = LoadTexture("assets/miniboss/arrow.png");
-
-    return level1Background && level2Background && platformTexture && heartTexture &&
-           gameOverTexture && levelCompleteTexture && gameCompleteTexture && playerIdle && runSheet && attackSheet &&
-           jumpSheet && damageSheet && deathSheet &&
-           boss1Idle && boss1RunSheet && boss1AttackSheet && boss1JumpSheet &&
-           boss1DamageSheet && boss1DeathSheet && boss1DiveSheet &&
-           boss2Idle && boss2RunSheet && boss2AttackSheet && boss2JumpSheet &&
-           boss2DamageSheet && boss2DeathSheet &&
-           miniBossIdle && miniBossRunSheet && miniBossAttackSheet && miniBossJumpSheet &&
-           miniBossDamageSheet && miniBossDeathSheet && miniBossDiveSheet && miniBossShootSheet && miniBossArrowTexture;
-}
-
-void CleanUp(SDL_Texture* playerIdle, SDL_Texture* runSheet, SDL_Texture* attackSheet,
-             SDL_Texture* jumpSheet, SDL_Texture* damageSheet,
-             SDL_Texture* deathSheet, TTF_Font* font, Mix_Music* music, Mix_Chunk* gameOverSound, Mix_Chunk* attackSound) {
-    SDL_DestroyTexture(level1Background);
-    SDL_DestroyTexture(level2Background);
-    SDL_DestroyTexture(platformTexture);
-    SDL_DestroyTexture(heartTexture);
-    SDL_DestroyTexture(gameOverTexture);
-    SDL_DestroyTexture(levelCompleteTexture);
-    SDL_DestroyTexture(gameCompleteTexture);
-    SDL_DestroyTexture(playerIdle);
-    SDL_DestroyTexture(runSheet);
-    SDL_DestroyTexture(attackSheet);
-    SDL_DestroyTexture(jumpSheet);
-    SDL_DestroyTexture(damageSheet);
-    SDL_DestroyTexture(deathSheet);
-    SDL_DestroyTexture(boss1Idle);
-    SDL_DestroyTexture(boss1RunSheet);
-    SDL_DestroyTexture(boss1AttackSheet);
-    SDL_DestroyTexture(boss1JumpSheet);
-    SDL_DestroyTexture(boss1DamageSheet);
-    SDL_DestroyTexture(boss1DeathSheet);
-    SDL_DestroyTexture(boss1DiveSheet);
-    SDL_DestroyTexture(boss2Idle);
-    SDL_DestroyTexture(boss2RunSheet);
-    SDL_DestroyTexture(boss2AttackSheet);
-    SDL_DestroyTexture(boss2JumpSheet);
-    SDL_DestroyTexture(boss2DamageSheet);
-    SDL_DestroyTexture(boss2DeathSheet);
-    SDL_DestroyTexture(miniBossIdle);
-    SDL_DestroyTexture(miniBossRunSheet);
-    SDL_DestroyTexture(miniBossAttackSheet);
-    SDL_DestroyTexture(miniBossJumpSheet);
-    SDL_DestroyTexture(miniBossDamageSheet);
-    SDL_DestroyTexture(miniBossDeathSheet);
-    SDL_DestroyTexture(miniBossDiveSheet);
-    SDL_DestroyTexture(miniBossShootSheet);
-    SDL_DestroyTexture(miniBossArrowTexture);
+void CleanUp(TTF_Font* font, Mix_Music* music, Mix_Chunk* gameOverSound, Mix_Chunk* attackSound) {
     if (font) TTF_CloseFont(font);
     if (music) Mix_FreeMusic(music);
     if (gameOverSound) Mix_FreeChunk(gameOverSound);
@@ -223,25 +99,106 @@ void CleanUp(SDL_Texture* playerIdle, SDL_Texture* runSheet, SDL_Texture* attack
     Mix_CloseAudio();
     Mix_Quit();
     TTF_Quit();
-    SDL_DestroyRenderer(g_renderer);
     SDL_DestroyWindow(g_window);
     IMG_Quit();
     SDL_Quit();
 }
 
 int main(int argc, char* argv[]) {
-    if (!Init()) {
+    // Replay: --record <file> ghi lại trận đấu, --replay <file> phát lại trận đã ghi và báo tick đầu tiên
+    // có trạng thái khác bản ghi; dùng cả hai để ghi lại lần phát rồi so bằng replay_diff
+    // Số liệu: --metrics-file <file> ghi định kỳ, --metrics-port <port> phục vụ HTTP trên 127.0.0.1
+    // Quay hình: --capture <prefix> quay ngay từ đầu, --capture-format png|y4m, F9 bật/tắt quay
+    // --headless: chạy không cửa sổ (thường đi kèm --replay và --capture)
+    // Ảnh chuẩn: --golden <dir> --replay <file> so sánh khung hình mốc với ảnh chuẩn, --golden-update ghi lại ảnh chuẩn
+    // --stress: vào thẳng màn thử tải với hàng trăm kẻ địch
+    // Cửa sổ: --fullscreen, F11 bật/tắt toàn màn hình; --fixed-scale tắt việc tự hạ độ phân giải render khi máy yếu
+    // --software: vẽ bằng CPU (tự chuyển sang khi không tạo được renderer tăng tốc; luôn dùng khi --headless)
+    std::string recordPath;
+    std::string metricsPath;
+    int metricsPort = 0;
+    std::string capturePath = "capture/clip";
+    CaptureFormat captureFormat = CAPTURE_PNG;
+    bool captureAtStart = false;
+    bool headless = false;
+    std::string replayPath;
+    std::string goldenPath;
+    bool goldenUpdate = false;
+    bool stress = false;
+    bool fullscreen = false;
+    bool fixedScale = false;
+    bool softwareRendering = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--headless") {
+            headless = true;
+        } else if (arg == "--golden-update") {
+            goldenUpdate = true;
+        } else if (arg == "--stress") {
+            stress = true;
+        } else if (arg == "--fullscreen") {
+            fullscreen = true;
+        } else if (arg == "--fixed-scale") {
+            fixedScale = true;
+        } else if (arg == "--software") {
+            softwareRendering = true;
+        } else if (i + 1 >= argc) {
+            break;
+        } else if (arg == "--record") {
+            recordPath = argv[++i];
+        } else if (arg == "--replay") {
+            replayPath = argv[++i];
+        } else if (arg == "--golden") {
+            goldenPath = argv[++i];
+        } else if (arg == "--capture") {
+            capturePath = argv[++i];
+            captureAtStart = true;
+        } else if (arg == "--capture-format") {
+            captureFormat = std::string(argv[++i]) == "y4m" ? CAPTURE_Y4M : CAPTURE_PNG;
+        } else if (arg == "--metrics-file") {
+            metricsPath = argv[++i];
+        } else if (arg == "--metrics-port") {
+            metricsPort = atoi(argv[++i]);
+        }
+    }
+
+    // Ảnh chuẩn luôn được tạo bằng renderer phần mềm để giống nhau giữa các máy
+    if (!goldenPath.empty()) headless = true;
+
+    if (!Init(headless, fullscreen)) {
         std::cout << "Initialization failed\n";
         return -1;
     }
 
-    srand(static_cast<unsigned>(time(0)));
+    Replay replay;
+    bool playingReplay = !replayPath.empty() && LoadReplay(replayPath, replay);
+    size_t replayIndex = 0;
+    int divergedTick = -1; // Tick đầu tiên có mã băm trạng thái khác bản ghi
+
+    GoldenRun* golden = nullptr;
+    if (!goldenPath.empty()) {
+        if (!playingReplay) {
+            std::cout << "--golden needs a valid --replay file\n";
+            CleanUp(nullptr, nullptr, nullptr, nullptr);
+            return -1;
+        }
+        // Tên ảnh chuẩn lấy theo tên file replay (bỏ thư mục và đuôi)
+        std::string name = replayPath.substr(replayPath.find_last_of("/\\") + 1);
+        name = name.substr(0, name.rfind('.'));
+        golden = new GoldenRun(goldenPath, name, goldenUpdate);
+    }
+
+    Uint32 seed = playingReplay ? replay.seed : static_cast<Uint32>(time(0));
+    Replay recording;
+    recording.seed = seed;
+    recording.startLevel = playingReplay ? replay.startLevel : FIRST_LEVEL;
+    if (!recordPath.empty()) recording.ticks.reserve(60 * 60 * 10); // 10 phút mà không phải cấp phát lại
 
     // Load font
     TTF_Font* font = TTF_OpenFont("assets/font.ttf", 24);
     if (!font) {
         std::cout << "TTF_OpenFont Error: " << TTF_GetError() << "\n";
-        CleanUp(nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr);
+        CleanUp(nullptr, nullptr, nullptr, nullptr);
         return -1;
     }
 
@@ -249,7 +206,7 @@ int main(int argc, char* argv[]) {
     Mix_Music* backgroundMusic = Mix_LoadMUS("assets/audio/background_music.mp3");
     if (!backgroundMusic) {
         std::cout << "Mix_LoadMUS Error: " << Mix_GetError() << "\n";
-        CleanUp(nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, font, nullptr, nullptr, nullptr);
+        CleanUp(font, nullptr, nullptr, nullptr);
         return -1;
     }
 
@@ -257,7 +214,7 @@ int main(int argc, char* argv[]) {
     Mix_Chunk* gameOverSound = Mix_LoadWAV("assets/audio/game_over.mp3");
     if (!gameOverSound) {
         std::cout << "Mix_LoadWAV Error: " << Mix_GetError() << "\n";
-        CleanUp(nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, font, backgroundMusic, nullptr, nullptr);
+        CleanUp(font, backgroundMusic, nullptr, nullptr);
         return -1;
     }
 
@@ -265,206 +222,204 @@ int main(int argc, char* argv[]) {
     Mix_Chunk* attackSound = Mix_LoadWAV("assets/audio/attack.mp3");
     if (!attackSound) {
         std::cout << "Mix_LoadWAV Error: " << Mix_GetError() << "\n";
-        CleanUp(nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, font, backgroundMusic, gameOverSound, nullptr);
+        CleanUp(font, backgroundMusic, gameOverSound, nullptr);
         return -1;
     }
 
-    // Load textures
-    SDL_Texture *playerIdle, *runSheet, *attackSheet, *jumpSheet, *damageSheet, *deathSheet;
-    if (!LoadAssets(playerIdle, runSheet, attackSheet, jumpSheet, damageSheet, deathSheet)) {
-        CleanUp(playerIdle, runSheet, attackSheet, jumpSheet, damageSheet, deathSheet, font, backgroundMusic, gameOverSound, attackSound);
+    // Khởi động luồng render; renderer và texture được tạo trên luồng đó
+    RenderThread renderThread;
+    FrameCapture capture;
+    capture.Start(capturePath, captureFormat);
+    capture.SetRecording(captureAtStart);
+    renderThread.SetSoftwareRendering(headless || softwareRendering);
+    renderThread.SetDynamicScale(!headless && !fixedScale);
+    renderThread.SetFrameCapture(&capture);
+    if (golden) renderThread.SetSnapshotHandler(GoldenRun::OnSnapshot, golden);
+    if (!renderThread.Start(g_window, font)) {
+        CleanUp(font, backgroundMusic, gameOverSound, attackSound);
         return -1;
     }
 
     // Initialize GUI
-    GameState state = GameState::MENU;
-    GUI gui(g_renderer, font, backgroundMusic, gameOverSound, attackSound); // Truyền attackSound
-
-    // Initialize player and boss (màn 1)
-    Player player(120, 400, playerIdle, runSheet, attackSheet, jumpSheet, damageSheet, deathSheet);
-    Boss boss(800, 0,
-              boss1RunSheet, 8, 128, 128,
-              boss1AttackSheet, 5, 128, 128,
-              boss1JumpSheet, 9, 128, 128,
-              boss1DamageSheet, 3, 128, 128,
-              boss1DeathSheet, 5, 128, 128,
-              boss1DiveSheet, 5, 128, 128);
+    InputSystem input;
+    input.LoadBindings(INPUT_BINDINGS_PATH);
+    GUI gui(backgroundMusic, gameOverSound, attackSound); // Truyền attackSound
+
+    // Bộ lập lịch chia các pha mô phỏng cho nhiều lõi
+    JobSystem jobs;
+    FrameArena frameArena; // Dữ liệu tạm của tick, thu hồi toàn bộ ở đầu tick sau
+
+    // Sự kiện gameplay của tick được giao theo lô ở cuối tick; audio nghe suốt chương trình,
+    // các scene tự đăng ký khi vào và gỡ khi ra
+    EventBus gameEvents;
+    GameAudio audio = {&gui, attackSound, gameOverSound};
+    gameEvents.Subscribe(EventBit(EVENT_ATTACK_STARTED) | EventBit(EVENT_DIED) | EventBit(EVENT_GAME_COMPLETED),
+                         PlayEventSounds, &audio);
+
+    // Luồng game: menu -> nạp màn -> màn chơi -> hoàn thành màn / game over, tạm dừng phủ lên màn chơi
+    SceneStack scenes;
+    GameContext context = {scenes, renderThread, input, gui, gameEvents, jobs, frameArena, backgroundMusic,
+                           MakeDefaultBossTuning(), 0, false, seed};
+    LoadBossTuning(BOSS_TUNING_PATH, context.bossTuning);
+    if (playingReplay) {
+        scenes.Push(new LoadingScene(context, replay.startLevel));
+    } else if (stress) {
+        scenes.Push(new LoadingScene(context, LEVEL_COUNT, STRESS_LEVEL_PATH));
+    } else {
+        scenes.Push(new MenuScene(context));
+    }
+    scenes.ApplyChanges();
+
+    // Hot reload: theo dõi thư mục của mọi sprite và file thông số boss
+    FileWatcher watcher;
+    std::vector<std::string> changedFiles;
+    for (int i = SPRITE_NONE + 1; i < SPRITE_COUNT; ++i) {
+        std::string path = GetSpritePath(i);
+        watcher.WatchDirectory(path.substr(0, path.rfind('/')));
+    }
+    std::string tuningPath = BOSS_TUNING_PATH;
+    watcher.WatchDirectory(tuningPath.substr(0, tuningPath.rfind('/')));
+
+    MetricsExporter metricsExporter;
+    metricsExporter.Start(metricsPath, metricsPort, METRICS_DUMP_INTERVAL);
 
     SDL_Event e;
-    bool quit = false;
-    bool musicStarted = false;
-    bool gameOverSoundPlayed = false;
-    bool gameCompleteSoundPlayed = false;
-    bool wasAttacking = false; // Theo dõi trạng thái tấn công trước đó
-
-    // Biến theo dõi trạng thái chết của boss và hoạt ảnh
-    bool bossDeathAnimationStarted = false;
-    Uint32 bossDeathStartTime = 0;
-    Uint32 levelCompleteStartTime = 0;
-    Uint32 gameCompleteStartTime = 0;
-
-    while (!quit) {
-        while (SDL_PollEvent(&e)) {
-            if (e.type == SDL_QUIT) {
-                quit = true;
-            } else if (state == GameState::MENU) {
-                gui.Update(e, state);
-            } else if (state == GameState::PLAYING) {
-                if (e.type == SDL_KEYDOWN && (showGameOver || showGameComplete) && e.key.keysym.sym == SDLK_ESCAPE) {
-                    quit = true;
-                } else {
-                    player.HandleInput(e);
+    Uint32 lastTickTime = SDL_GetTicks();
+    Uint64 lastTickCounter = SDL_GetPerformanceCounter();
+    int reportedDroppedEvents = 0;
+
+    while (!scenes.IsEmpty()) {
+        // Thời gian game trôi qua kể từ vòng lặp trước
+        Uint32 tickTime = SDL_GetTicks();
+        Uint32 dt = tickTime - lastTickTime;
+        lastTickTime = tickTime;
+        Uint64 tickCounter = SDL_GetPerformanceCounter();
+        MetricRecord(METRIC_FRAME_TIME, (tickCounter - lastTickCounter) * 1000000 / SDL_GetPerformanceFrequency());
+        lastTickCounter = tickCounter;
+        unsigned long heapAllocationsAtTickStart = GetHeapAllocationCount();
+        frameArena.Reset();
+
+        // Nạp lại những file vừa được sửa; chỉ giải mã lại đúng các ảnh đã đổi
+        changedFiles.clear();
+        if (watcher.Poll(changedFiles) > 0) {
+            for (const std::string& path : changedFiles) {
+                int sprite = FindSpriteByPath(path.c_str());
+                if (sprite != SPRITE_NONE) {
+                    renderThread.ReloadSprite(sprite);
+                } else if (path == tuningPath && LoadBossTuning(tuningPath, context.bossTuning)) {
+                    context.tuningRevision++;
+                    std::cout << "Reloaded boss tuning\n";
                 }
             }
         }
 
-        if (state == GameState::MENU) {
-            gui.Render();
-        } else if (state == GameState::PLAYING) {
-            // Bắt đầu phát nhạc nếu chưa phát
-            if (!musicStarted && Mix_PausedMusic() == 0) {
-                Mix_PlayMusic(backgroundMusic, -1);
-                std::cout << "Background music started\n";
-                musicStarted = true;
+        while (SDL_PollEvent(&e)) {
+            input.HandleEvent(e);
+            if (e.type == SDL_QUIT) {
+                scenes.Clear();
+            } else if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_F9 && !e.key.repeat) {
+                capture.SetRecording(!capture.IsRecording());
+            } else if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_F11 && !e.key.repeat) {
+                bool isFullscreen = (SDL_GetWindowFlags(g_window) & SDL_WINDOW_FULLSCREEN_DESKTOP) == SDL_WINDOW_FULLSCREEN_DESKTOP;
+                SDL_SetWindowFullscreen(g_window, isFullscreen ? 0 : SDL_WINDOW_FULLSCREEN_DESKTOP);
+            } else if (e.type == SDL_RENDER_TARGETS_RESET || e.type == SDL_RENDER_DEVICE_RESET ||
+                       (e.type == SDL_WINDOWEVENT && e.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)) {
+                // Nội dung render target có thể đã mất
+                renderThread.InvalidateStaticLayers();
+            } else {
+                scenes.HandleEvent(e);
             }
+        }
 
-            if (!showGameOver && !levelTransition && !showLevelComplete && !showGameComplete) {
-                // Cập nhật player và boss
-                player.Update(currentLevel == 1 ? level1Platforms : level2Platforms, 3);
-                boss.Update(player.GetRect(), currentLevel == 1 ? level1Platforms : level2Platforms, 3, currentLevel, player);
-
-                // Phát âm thanh tấn công
-                bool isAttacking = player.IsAttacking();
-                if (isAttacking && !wasAttacking && gui.IsSoundEnabled()) {
-                    Mix_PlayChannel(-1, attackSound, 0);
-                    std::cout << "Player attack sound played\n";
-                }
-                wasAttacking = isAttacking;
-
-                // Debug trạng thái
-                std::cout << "Boss isAttacking: " << boss.IsAttacking() << ", isDashing: " << boss.IsDashing() << ", isDiving: " << boss.IsDiving() << "\n";
-                std::cout << "Player isAttacking: " << player.IsAttacking() << "\n";
-                if (SDL_HasIntersection(&player.GetRect(), &boss.GetRect())) {
-                    std::cout << "Collision detected between player and boss\n";
-                }
-
-                // Xử lý tấn công của boss 2
-                if (!player.IsDead() && currentLevel == 2 && boss.IsAttacking() && SDL_HasIntersection(&player.GetRect(), &boss.GetRect())) {
-                    if (!boss.HasDealtDamage() && !player.IsInvulnerable()) {
-                        std::cout << "Boss hits player!\n";
-                        player.TakeDamage(1);
-                        boss.SetDealtDamage(true);
-                    }
-                } else if (!SDL_HasIntersection(&player.GetRect(), &boss.GetRect())) {
-                    boss.SetDealtDamage(false);
-                }
-
-                // Nhân vật tấn công boss
-                if (player.IsAttacking() && SDL_HasIntersection(&player.GetRect(), &boss.GetRect())) {
-                    std::cout << "Player attacks boss!\n";
-                    boss.ReduceHealth(1);
+        // Mọi thiết bị được lấy mẫu một lần mỗi tick; khi phát lại, input và dt lấy từ bản ghi
+        InputFrame tickInput = input.Sample(tickTime);
+        int snapshotTag = -1;
+        int playedTick = -1;
+        if (playingReplay && scenes.IsGameplay()) {
+            if (replayIndex < replay.ticks.size()) {
+                playedTick = static_cast<int>(replayIndex);
+                dt = replay.ticks[replayIndex].dt;
+                tickInput = replay.ticks[replayIndex].input;
+                replayIndex++;
+                if (golden && golden->IsCheckpoint(static_cast<int>(replayIndex))) {
+                    snapshotTag = static_cast<int>(replayIndex);
                 }
+            } else {
+                std::cout << "Replay finished after " << replayIndex << " ticks"
+                          << (divergedTick < 0 ? ", state matched the recording" : "") << "\n";
+                playingReplay = false;
+                if (golden) scenes.Clear(); // Kiểm tra ảnh chuẩn kết thúc cùng replay
             }
+        }
+        bool recordTick = !recordPath.empty() && scenes.IsGameplay();
+        if (recordTick) {
+            ReplayTick tick = {dt, tickInput, 0};
+            recording.ticks.push_back(tick);
+        }
 
-            // Kiểm tra boss chết để bắt đầu hoạt ảnh chết
-            if (boss.GetHealth() <= 0 && !levelTransition && !showLevelComplete && !bossDeathAnimationStarted && !showGameComplete) {
-                bossDeathAnimationStarted = true;
-                bossDeathStartTime = SDL_GetTicks();
-            }
-
-            // Chuyển sang hoạt ảnh kết thúc màn sau khi hoạt ảnh chết hoàn tất
-            if (bossDeathAnimationStarted && !levelTransition && !showLevelComplete && !showGameComplete) {
-                if (SDL_GetTicks() - bossDeathStartTime >= DEATH_FRAME_COUNT * FRAME_DELAY) {
-                    showLevelComplete = true;
-                    levelCompleteStartTime = SDL_GetTicks();
-                }
+        // Chỉ scene trên cùng được cập nhật; sự kiện của tick được giao trước khi đổi scene
+        bool simulated = scenes.IsGameplay();
+        Uint64 updateStart = SDL_GetPerformanceCounter();
+        scenes.Update(dt, tickInput);
+        // Băm trạng thái trước ApplyChanges để scene trên cùng vẫn là scene vừa chạy tick
+        if (recordTick || playedTick >= 0) {
+            Uint32 stateHash = scenes.HashState();
+            if (recordTick) recording.ticks.back().stateHash = stateHash;
+            if (playedTick >= 0 && divergedTick < 0 && stateHash != replay.ticks[playedTick].stateHash) {
+                divergedTick = playedTick;
+                std::cout << "Replay diverged at tick " << playedTick << ": state hash " << std::hex << stateHash
+                          << ", recorded " << replay.ticks[playedTick].stateHash << std::dec << "\n";
             }
+        }
+        gameEvents.Dispatch();
+        scenes.ApplyChanges();
+        MetricRecordSince(METRIC_UPDATE_TIME, updateStart);
+        MetricAdd(METRIC_TICKS);
+        MetricSet(METRIC_AUDIO_VOICES, Mix_Playing(-1));
+        MetricSet(METRIC_ARENA_PEAK_BYTES, static_cast<Sint64>(frameArena.GetPeak()));
+        int droppedEvents = gameEvents.GetDroppedCount();
+        if (droppedEvents != reportedDroppedEvents) {
+            MetricAdd(METRIC_EVENTS_DROPPED, static_cast<Uint64>(droppedEvents - reportedDroppedEvents));
+            reportedDroppedEvents = droppedEvents;
+        }
 
-            // Chuyển màn hoặc hiển thị hoàn thành game
-            if (showLevelComplete && SDL_GetTicks() - levelCompleteStartTime >= LEVEL_COMPLETE_DURATION) {
-                levelTransition = true;
-                if (currentLevel == 1) {
-                    currentLevel = 2;
-                    player.Reset();
-                    boss = Boss(800, 0,
-                                boss2RunSheet, 8, 128, 128,
-                                boss2AttackSheet, 4, 128, 128,
-                                boss2JumpSheet, 7, 128, 128,
-                                boss2DamageSheet, 2, 128, 128,
-                                boss2DeathSheet, 6, 128, 128,
-                                nullptr, 0, 0, 0);
-                    levelTransition = false;
-                    showLevelComplete = false;
-                    bossDeathAnimationStarted = false;
-                } else if (currentLevel == 2) {
-                    showGameComplete = true;
-                    gameCompleteStartTime = SDL_GetTicks();
-                    levelTransition = false;
-                    showLevelComplete = false;
-                    bossDeathAnimationStarted = false;
-                    // Phát âm thanh Game Complete
-                    if (!gameCompleteSoundPlayed && gui.IsSoundEnabled()) {
-                        Mix_PlayChannel(-1, gameOverSound, 0);
-                        std::cout << "Game Complete sound played\n";
-                        gameCompleteSoundPlayed = true;
-                    }
-                }
-            }
+        // Tạo danh sách vẽ cho khung hình này và công bố cho luồng render
+        if (!scenes.IsEmpty()) {
+            RenderList& frame = renderThread.BeginFrame();
+            scenes.Render(frame);
+            frame.SortByLayer();
+            frame.snapshotTag = snapshotTag;
+            renderThread.EndFrame();
+            if (snapshotTag >= 0) renderThread.WaitForSnapshot(snapshotTag);
+        }
 
-            // Thoát game sau khi hiển thị hoạt ảnh hoàn thành
-            if (showGameComplete && SDL_GetTicks() - gameCompleteStartTime >= GAME_COMPLETE_DURATION) {
-                quit = true;
+        // Mục tiêu: không có cấp phát heap nào trong tick khi game đã ổn định
+        if (IsHeapAllocationCountEnabled() && simulated) {
+            unsigned long tickAllocations = GetHeapAllocationCount() - heapAllocationsAtTickStart;
+            MetricAdd(METRIC_HEAP_ALLOCATIONS, tickAllocations);
+            if (tickAllocations > 0) {
+                std::cout << "Heap allocations this tick: " << tickAllocations
+                          << " (arena peak " << frameArena.GetPeak() << " bytes)\n";
             }
+        }
 
-            // Render
-            SDL_SetRenderDrawColor(g_renderer, 0, 0, 0, 255);
-            SDL_RenderClear(g_renderer);
-
-            if (showGameOver) {
-                SDL_RenderCopy(g_renderer, gameOverTexture, nullptr, nullptr);
-                boss.Render(g_renderer, currentLevel == 1 ? boss1Idle : boss2Idle, SDL_GetTicks());
-            } else if (showGameComplete) {
-                SDL_RenderCopy(g_renderer, gameCompleteTexture, nullptr, nullptr);
-            } else if (showLevelComplete) {
-                SDL_RenderCopy(g_renderer, levelCompleteTexture, nullptr, nullptr);
-            } else {
-                // Hiển thị background
-                SDL_Texture* currentBackground = currentLevel == 1 ? level1Background : level2Background;
-                SDL_RenderCopy(g_renderer, currentBackground, nullptr, nullptr);
-
-                // Hiển thị platforms
-                SDL_Rect* currentPlatforms = currentLevel == 1 ? level1Platforms : level2Platforms;
-                for (int i = 0; i < 3; ++i) {
-                    SDL_RenderCopy(g_renderer, platformTexture, nullptr, &currentPlatforms[i]);
-                }
+        // Nhịp mô phỏng; luồng render vẽ và present song song. Kiểm tra ảnh chuẩn chạy nhanh nhất có thể
+        if (!golden) SDL_Delay(FIXED_TICK_MS);
+    }
 
-                // Hiển thị sức khỏe của player
-                for (int i = 0; i < player.GetHealth(); ++i) {
-                    SDL_Rect heartRect = {10 + i * 40, 10, 32, 32};
-                    SDL_RenderCopy(g_renderer, heartTexture, nullptr, &heartRect);
-                }
+    if (!recordPath.empty()) {
+        SaveReplay(recordPath, recording);
+    }
 
-                // Render player và boss
-                player.Render(g_renderer);
-                boss.Render(g_renderer, currentLevel == 1 ? boss1Idle : boss2Idle, SDL_GetTicks());
-
-                // Kiểm tra trạng thái chết của player để hiển thị Game Over
-                if (player.IsDead() && SDL_GetTicks() - bossDeathStartTime >= DEATH_FRAME_COUNT * FRAME_DELAY) {
-                    showGameOver = true;
-                    // Phát âm thanh Game Over
-                    if (!gameOverSoundPlayed && gui.IsSoundEnabled()) {
-                        Mix_PlayChannel(-1, gameOverSound, 0);
-                        std::cout << "Game Over sound played\n";
-                        gameOverSoundPlayed = true;
-                    }
-                }
-            }
+    metricsExporter.Stop();
+    renderThread.Stop();
+    capture.Stop();
+    CleanUp(font, backgroundMusic, gameOverSound, attackSound);
 
-            SDL_RenderPresent(g_renderer);
-            SDL_Delay(16);
-        }
+    int exitCode = divergedTick < 0 ? 0 : 1;
+    if (golden) {
+        if (!golden->Report()) exitCode = 1;
+        delete golden;
     }
-
-    CleanUp(playerIdle, runSheet, attackSheet, jumpSheet, damageSheet, deathSheet, font, backgroundMusic, gameOverSound, attackSound);
-    return 0;
+    return exitCode;
 }
@@ -0,0 +1,317 @@
+#include "metrics.h"
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#include <winsock2.h>
+typedef SOCKET MetricSocket;
+#define CloseMetricSocket closesocket
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+typedef int MetricSocket;
+const MetricSocket INVALID_SOCKET = -1;
+#define CloseMetricSocket close
+#endif
+
+// Thời gian tối đa chờ một client gửi yêu cầu hoặc nhận phản hồi; client im lặng bị đóng kết nối
+// để luồng xuất không bị treo và Stop() luôn kết thúc
+const int METRICS_CLIENT_TIMEOUT_MS = 1000;
+
+// Số liệu của một luồng; căn theo dòng cache để hai shard không dùng chung dòng nào
+struct alignas(64) MetricShard {
+    std::atomic<Uint64> counters[METRIC_COUNTER_COUNT];
+    std::atomic<Uint64> buckets[METRIC_HISTOGRAM_COUNT][HISTOGRAM_BUCKETS];
+    std::atomic<Uint64> sums[METRIC_HISTOGRAM_COUNT];
+};
+
+// Bộ nhớ tĩnh được khởi tạo bằng 0 trước khi có luồng nào chạy
+static MetricShard shards[MAX_METRIC_SHARDS];
+static std::atomic<Sint64> gauges[METRIC_GAUGE_COUNT];
+static std::atomic<int> nextShard(0);
+static thread_local MetricShard* currentShard = nullptr;
+
+struct MetricInfo {
+    const char* name;
+    const char* help;
+};
+
+static const MetricInfo COUNTER_INFO[METRIC_COUNTER_COUNT] = {
+    {"mygame_ticks_total", "Simulation ticks run"},
+    {"mygame_frames_drawn_total", "Frames drawn by the render thread"},
+    {"mygame_heap_allocations_total", "Heap allocations during ticks (FRAME_ALLOC_DEBUG builds only)"},
+    {"mygame_events_dropped_total", "Gameplay events dropped because the event queue was full"}
+};
+
+static const MetricInfo GAUGE_INFO[METRIC_GAUGE_COUNT] = {
+    {"mygame_live_entities", "Player, bosses and minibosses alive in the current level"},
+    {"mygame_projectiles", "Arrows in flight"},
+    {"mygame_particles", "Live particles"},
+    {"mygame_draw_calls", "Draw calls issued for the last frame"},
+    {"mygame_audio_voices", "Mixer channels currently playing"},
+    {"mygame_frame_arena_peak_bytes", "Peak frame arena usage"},
+    {"mygame_render_scale_percent", "Internal render resolution in percent of the logical size"}
+};
+
+static const MetricInfo HISTOGRAM_INFO[METRIC_HISTOGRAM_COUNT] = {
+    {"mygame_frame_time_seconds", "Time between simulation ticks"},
+    {"mygame_update_time_seconds", "Time spent updating the active scenes"},
+    {"mygame_draw_time_seconds", "Time the render thread spent drawing a frame"},
+    {"mygame_particle_update_time_seconds", "Time spent updating particles"}
+};
+
+static MetricShard& GetShard() {
+    if (!currentShard) {
+        // Luồng thứ MAX_METRIC_SHARDS + 1 trở đi dùng chung shard; phép cộng nguyên tử vẫn đúng
+        currentShard = &shards[nextShard.fetch_add(1) % MAX_METRIC_SHARDS];
+    }
+    return *currentShard;
+}
+
+static int BucketIndex(Uint64 micros) {
+    if (micros < static_cast<Uint64>(HISTOGRAM_SUB_BUCKETS)) return static_cast<int>(micros);
+    int octave = 63 - __builtin_clzll(micros); // >= 2
+    int sub = static_cast<int>((micros >> (octave - 2)) & (HISTOGRAM_SUB_BUCKETS - 1));
+    int index = HISTOGRAM_SUB_BUCKETS + (octave - 2) * HISTOGRAM_SUB_BUCKETS + sub;
+    return index < HISTOGRAM_BUCKETS ? index : HISTOGRAM_BUCKETS - 1;
+}
+
+// Giá trị lớn nhất (µs) rơi vào ô index
+static Uint64 BucketUpperBound(int index) {
+    if (index < HISTOGRAM_SUB_BUCKETS) return static_cast<Uint64>(index);
+    int octave = (index - HISTOGRAM_SUB_BUCKETS) / HISTOGRAM_SUB_BUCKETS + 2;
+    int sub = (index - HISTOGRAM_SUB_BUCKETS) % HISTOGRAM_SUB_BUCKETS;
+    return (static_cast<Uint64>(HISTOGRAM_SUB_BUCKETS + sub + 1) << (octave - 2)) - 1;
+}
+
+void MetricAdd(MetricCounter counter, Uint64 amount) {
+    GetShard().counters[counter].fetch_add(amount, std::memory_order_relaxed);
+}
+
+void MetricSet(MetricGauge gauge, Sint64 value) {
+    gauges[gauge].store(value, std::memory_order_relaxed);
+}
+
+void MetricRecord(MetricHistogram histogram, Uint64 micros) {
+    MetricShard& shard = GetShard();
+    shard.buckets[histogram][BucketIndex(micros)].fetch_add(1, std::memory_order_relaxed);
+    shard.sums[histogram].fetch_add(micros, std::memory_order_relaxed);
+}
+
+void MetricRecordSince(MetricHistogram histogram, Uint64 startCounter) {
+    Uint64 elapsed = SDL_GetPerformanceCounter() - startCounter;
+    MetricRecord(histogram, elapsed * 1000000 / SDL_GetPerformanceFrequency());
+}
+
+static void AppendLine(std::string& out, const char* format, ...) {
+    char line[256];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    out += line;
+}
+
+void WriteMetricsText(std::string& out) {
+    out.clear();
+
+    for (int i = 0; i < METRIC_COUNTER_COUNT; ++i) {
+        Uint64 total = 0;
+        for (int s = 0; s < MAX_METRIC_SHARDS; ++s) total += shards[s].counters[i].load(std::memory_order_relaxed);
+        AppendLine(out, "# HELP %s %s\n# TYPE %s counter\n", COUNTER_INFO[i].name, COUNTER_INFO[i].help, COUNTER_INFO[i].name);
+        AppendLine(out, "%s %llu\n", COUNTER_INFO[i].name, static_cast<unsigned long long>(total));
+    }
+
+    for (int i = 0; i < METRIC_GAUGE_COUNT; ++i) {
+        AppendLine(out, "# HELP %s %s\n# TYPE %s gauge\n", GAUGE_INFO[i].name, GAUGE_INFO[i].help, GAUGE_INFO[i].name);
+        AppendLine(out, "%s %lld\n", GAUGE_INFO[i].name, static_cast<long long>(gauges[i].load(std::memory_order_relaxed)));
+    }
+
+    for (int i = 0; i < METRIC_HISTOGRAM_COUNT; ++i) {
+        const char* name = HISTOGRAM_INFO[i].name;
+        AppendLine(out, "# HELP %s %s\n# TYPE %s histogram\n", name, HISTOGRAM_INFO[i].help, name);
+        Uint64 cumulative = 0;
+        Uint64 sum = 0;
+        for (int s = 0; s < MAX_METRIC_SHARDS; ++s) sum += shards[s].sums[i].load(std::memory_order_relaxed);
+        for (int b = 0; b < HISTOGRAM_BUCKETS; ++b) {
+            for (int s = 0; s < MAX_METRIC_SHARDS; ++s) cumulative += shards[s].buckets[i][b].load(std::memory_order_relaxed);
+            // Ô cuối nhận cả giá trị tràn nên chỉ xuất dưới dạng +Inf
+            if (b == HISTOGRAM_BUCKETS - 1) break;
+            AppendLine(out, "%s_bucket{le=\"%g\"} %llu\n", name, BucketUpperBound(b) / 1000000.0,
+                       static_cast<unsigned long long>(cumulative));
+        }
+        AppendLine(out, "%s_bucket{le=\"+Inf\"} %llu\n", name, static_cast<unsigned long long>(cumulative));
+        AppendLine(out, "%s_sum %g\n", name, sum / 1000000.0);
+        AppendLine(out, "%s_count %llu\n", name, static_cast<unsigned long long>(cumulative));
+    }
+}
+
+MetricsExporter::MetricsExporter() : port(0), intervalMs(1000), listener(-1), running(false) {}
+
+MetricsExporter::~MetricsExporter() {
+    Stop();
+}
+
+bool MetricsExporter::Start(const std::string& path, int listenPort, Uint32 interval) {
+    if (path.empty() && listenPort <= 0) return true;
+
+    filePath = path;
+    port = listenPort;
+    intervalMs = interval;
+
+    if (port > 0) {
+#ifdef _WIN32
+        WSADATA wsaData;
+        if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+            std::cout << "Metrics error: WSAStartup failed\n";
+            return false;
+        }
+#endif
+        MetricSocket server = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // Chỉ máy cục bộ, không mở ra mạng
+        address.sin_port = htons(static_cast<unsigned short>(port));
+        int reuse = 1;
+        if (server != INVALID_SOCKET) {
+            setsockopt(server, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+        }
+        if (server == INVALID_SOCKET ||
+            bind(server, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            listen(server, 4) != 0) {
+            std::cout << "Metrics error: cannot listen on 127.0.0.1:" << port << "\n";
+            if (server != INVALID_SOCKET) CloseMetricSocket(server);
+#ifdef _WIN32
+            WSACleanup();
+#endif
+            return false;
+        }
+        listener = static_cast<intptr_t>(server);
+        std::cout << "Serving metrics on http://127.0.0.1:" << port << "/metrics\n";
+    }
+    if (!filePath.empty()) {
+        std::cout << "Writing metrics to " << filePath << " every " << intervalMs << " ms\n";
+    }
+
+    running = true;
+    thread = std::thread(&MetricsExporter::Run, this);
+    return true;
+}
+
+void MetricsExporter::Stop() {
+    if (!running) return;
+    running = false;
+    thread.join();
+    if (listener != -1) {
+        CloseMetricSocket(static_cast<MetricSocket>(listener));
+        listener = -1;
+#ifdef _WIN32
+        WSACleanup();
+#endif
+    }
+}
+
+bool MetricsExporter::WriteFile(const std::string& text) {
+    // Ghi file tạm rồi đổi tên để bên đọc không bao giờ thấy file ghi dở
+    std::string tempPath = filePath + ".tmp";
+    FILE* file = std::fopen(tempPath.c_str(), "wb");
+    if (!file) {
+        std::cout << "Metrics error: cannot write " << tempPath << "\n";
+        return false;
+    }
+    bool ok = std::fwrite(text.data(), 1, text.size(), file) == text.size();
+    ok = std::fclose(file) == 0 && ok;
+    std::remove(filePath.c_str()); // rename trên Windows không ghi đè file có sẵn
+    if (!ok || std::rename(tempPath.c_str(), filePath.c_str()) != 0) {
+        std::cout << "Metrics error: failed writing " << filePath << "\n";
+        return false;
+    }
+    return true;
+}
+
+// Chờ socket có dữ liệu đọc tối đa timeoutMs
+static bool WaitReadable(MetricSocket socket, int timeoutMs) {
+    fd_set readable;
+    FD_ZERO(&readable);
+    FD_SET(socket, &readable);
+    timeval timeout = {timeoutMs / 1000, (timeoutMs % 1000) * 1000};
+    return select(static_cast<int>(socket) + 1, &readable, nullptr, nullptr, &timeout) > 0;
+}
+
+static void SetSendTimeout(MetricSocket socket, int timeoutMs) {
+#ifdef _WIN32
+    DWORD timeout = static_cast<DWORD>(timeoutMs);
+#else
+    timeval timeout = {timeoutMs / 1000, (timeoutMs % 1000) * 1000};
+#endif
+    setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+}
+
+void MetricsExporter::ServeClient(intptr_t client, std::string& text) {
+    MetricSocket connection = static_cast<MetricSocket>(client);
+    // Client không gửi yêu cầu trong thời hạn thì bỏ qua; người gọi đóng socket
+    if (!WaitReadable(connection, METRICS_CLIENT_TIMEOUT_MS)) return;
+    SetSendTimeout(connection, METRICS_CLIENT_TIMEOUT_MS);
+
+    char request[1024];
+    int received = recv(connection, request, sizeof(request) - 1, 0);
+    if (received <= 0) return;
+    request[received] = '\0';
+
+    char header[160];
+    if (std::strncmp(request, "GET /metrics", 12) == 0 || std::strncmp(request, "GET / ", 6) == 0) {
+        WriteMetricsText(text);
+        std::snprintf(header, sizeof(header),
+                      "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: %u\r\nConnection: close\r\n\r\n",
+                      static_cast<unsigned>(text.size()));
+    } else {
+        text = "not found\n";
+        std::snprintf(header, sizeof(header),
+                      "HTTP/1.0 404 Not Found\r\nContent-Type: text/plain\r\nContent-Length: %u\r\nConnection: close\r\n\r\n",
+                      static_cast<unsigned>(text.size()));
+    }
+    send(connection, header, static_cast<int>(std::strlen(header)), 0);
+    send(connection, text.data(), static_cast<int>(text.size()), 0);
+}
+
+void MetricsExporter::Run() {
+    std::string text;
+    Uint32 lastDump = SDL_GetTicks();
+    while (running) {
+        if (listener != -1) {
+            // Chờ kết nối tối đa 100 ms rồi kiểm tra lại cờ dừng và lịch ghi file
+            MetricSocket server = static_cast<MetricSocket>(listener);
+            fd_set readable;
+            FD_ZERO(&readable);
+            FD_SET(server, &readable);
+            timeval timeout = {0, 100000};
+            if (select(static_cast<int>(server) + 1, &readable, nullptr, nullptr, &timeout) > 0) {
+                MetricSocket client = accept(server, nullptr, nullptr);
+                if (client != INVALID_SOCKET) {
+                    ServeClient(static_cast<intptr_t>(client), text);
+                    CloseMetricSocket(client);
+                }
+            }
+        } else {
+            SDL_Delay(100);
+        }
+
+        if (!filePath.empty() && SDL_GetTicks() - lastDump >= intervalMs) {
+            WriteMetricsText(text);
+            WriteFile(text);
+            lastDump = SDL_GetTicks();
+        }
+    }
+
+    // Lần ghi cuối để file phản ánh toàn bộ phiên chơi
+    if (!filePath.empty()) {
+        WriteMetricsText(text);
+        WriteFile(text);
+    }
+}
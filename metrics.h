@@ -0,0 +1,87 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <SDL.h>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+// Bộ đếm chỉ tăng
+enum MetricCounter {
+    METRIC_TICKS = 0,
+    METRIC_FRAMES_DRAWN,
+    METRIC_HEAP_ALLOCATIONS, // Chỉ tăng khi biên dịch với -DFRAME_ALLOC_DEBUG
+    METRIC_EVENTS_DROPPED,
+    METRIC_COUNTER_COUNT
+};
+
+// Giá trị tức thời, lần ghi sau đè lần ghi trước
+enum MetricGauge {
+    METRIC_LIVE_ENTITIES = 0,
+    METRIC_PROJECTILES,
+    METRIC_PARTICLES,
+    METRIC_DRAW_CALLS,
+    METRIC_AUDIO_VOICES,
+    METRIC_ARENA_PEAK_BYTES,
+    METRIC_RENDER_SCALE, // Phần trăm độ phân giải logic mà cảnh đang được vẽ
+    METRIC_GAUGE_COUNT
+};
+
+// Phân bố thời gian, ghi bằng micro giây
+enum MetricHistogram {
+    METRIC_FRAME_TIME = 0,
+    METRIC_UPDATE_TIME,
+    METRIC_DRAW_TIME,
+    METRIC_PARTICLE_UPDATE_TIME,
+    METRIC_HISTOGRAM_COUNT
+};
+
+// Histogram kiểu HDR: 4 ô tuyến tính cho 0-3 µs, sau đó mỗi lũy thừa của 2 chia 4 ô bằng nhau
+// (sai số tương đối tối đa 25%) tới khoảng 16 giây; giá trị lớn hơn rơi vào ô cuối
+const int HISTOGRAM_SUB_BUCKETS = 4;
+const int HISTOGRAM_OCTAVES = 23;
+const int HISTOGRAM_BUCKETS = HISTOGRAM_SUB_BUCKETS + HISTOGRAM_OCTAVES * HISTOGRAM_SUB_BUCKETS;
+
+// Mỗi luồng ghi vào một shard riêng nên luồng mô phỏng, luồng render và worker không tranh
+// nhau cùng dòng cache; luồng xuất cộng các shard lại khi đọc
+const int MAX_METRIC_SHARDS = 8;
+
+// Chu kỳ ghi file số liệu (ms)
+const Uint32 METRICS_DUMP_INTERVAL = 1000;
+
+// Ghi từ bất kỳ luồng nào, không khóa và không cấp phát
+void MetricAdd(MetricCounter counter, Uint64 amount = 1);
+void MetricSet(MetricGauge gauge, Sint64 value);
+void MetricRecord(MetricHistogram histogram, Uint64 micros);
+// Thời gian từ một lần đọc SDL_GetPerformanceCounter() tới hiện tại
+void MetricRecordSince(MetricHistogram histogram, Uint64 startCounter);
+
+// Ảnh chụp toàn bộ số liệu ở định dạng văn bản của Prometheus
+void WriteMetricsText(std::string& out);
+
+// Luồng xuất số liệu: ghi file định kỳ (ghi file tạm rồi đổi tên) và/hoặc trả lời
+// HTTP GET trên 127.0.0.1:port. Không cấu hình gì thì không chạy luồng nào.
+class MetricsExporter {
+private:
+    std::string filePath;
+    int port;
+    Uint32 intervalMs;
+    intptr_t listener; // Socket đang nghe, -1 nếu không mở HTTP
+    std::thread thread;
+    std::atomic<bool> running;
+
+    void Run();
+    void ServeClient(intptr_t client, std::string& text);
+    bool WriteFile(const std::string& text);
+
+public:
+    MetricsExporter();
+    ~MetricsExporter();
+
+    // filePath rỗng: không ghi file; port 0: không mở HTTP
+    bool Start(const std::string& filePath, int port, Uint32 intervalMs);
+    void Stop();
+};
+
+#endif
@@ -0,0 +1,136 @@
+// Công cụ đóng gói asset: giải mã mọi ảnh trong bảng sprite thành điểm ảnh RGBA,
+// nén LZ4 và ghi vào một file gói để game nạp bằng ánh xạ bộ nhớ thay vì giải mã PNG.
+// Chạy từ thư mục gốc của game: pack_assets [--out assets/assets.pak]
+#include <SDL.h>
+#include <SDL_image.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "asset_pack.h"
+#include "lz4.h"
+#include "sprites.h"
+
+static bool CompareHash(const AssetPackEntry& a, const AssetPackEntry& b) {
+    return a.pathHash < b.pathHash;
+}
+
+// Giải mã ảnh thành điểm ảnh RGBA32 liền hàng
+static bool DecodeImage(const char* path, AssetPackEntry& entry, std::vector<Uint8>& pixels) {
+    SDL_Surface* loaded = IMG_Load(path);
+    if (!loaded) {
+        std::cerr << "IMG_Load Error: " << IMG_GetError() << " (file: " << path << ")\n";
+        return false;
+    }
+    SDL_Surface* surface = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(loaded);
+    if (!surface) {
+        std::cerr << "SDL_ConvertSurfaceFormat Error: " << SDL_GetError() << " (file: " << path << ")\n";
+        return false;
+    }
+
+    entry.format = SDL_PIXELFORMAT_RGBA32;
+    entry.width = static_cast<Uint32>(surface->w);
+    entry.height = static_cast<Uint32>(surface->h);
+    entry.rawSize = entry.width * entry.height * 4;
+    pixels.resize(entry.rawSize);
+    SDL_LockSurface(surface);
+    for (int y = 0; y < surface->h; ++y) {
+        std::memcpy(&pixels[y * entry.width * 4], static_cast<Uint8*>(surface->pixels) + y * surface->pitch, entry.width * 4);
+    }
+    SDL_UnlockSurface(surface);
+    SDL_FreeSurface(surface);
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    std::string outputPath = ASSET_PACK_PATH;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--out" && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else {
+            std::cout << "Usage: pack_assets [--out " << ASSET_PACK_PATH << "]\n";
+            return 1;
+        }
+    }
+
+    if (SDL_Init(0) < 0 || !(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG)) {
+        std::cerr << "Init Error: " << SDL_GetError() << "\n";
+        return 1;
+    }
+
+    std::vector<AssetPackEntry> entries;
+    std::vector<std::vector<Uint8> > blobs;
+    std::vector<Uint8> pixels;
+    Uint64 offset = sizeof(AssetPackHeader) + (SPRITE_COUNT - 1) * sizeof(AssetPackEntry);
+    Uint64 rawTotal = 0;
+    bool ok = true;
+
+    for (int sprite = SPRITE_NONE + 1; sprite < SPRITE_COUNT && ok; ++sprite) {
+        const char* path = GetSpritePath(sprite);
+        AssetPackEntry entry;
+        std::memset(&entry, 0, sizeof(entry));
+        if (std::strlen(path) >= sizeof(entry.path)) {
+            std::cerr << "Path too long for pack: " << path << "\n";
+            ok = false;
+            break;
+        }
+        std::strcpy(entry.path, path);
+        entry.pathHash = HashAssetPath(path);
+        if (!DecodeImage(path, entry, pixels)) {
+            ok = false;
+            break;
+        }
+
+        std::vector<Uint8> compressed(Lz4CompressBound(static_cast<int>(pixels.size())));
+        int compressedSize = Lz4Compress(pixels.data(), static_cast<int>(pixels.size()),
+                                         compressed.data(), static_cast<int>(compressed.size()));
+        compressed.resize(compressedSize);
+        entry.compressedSize = static_cast<Uint32>(compressedSize);
+        entry.offset = offset;
+        offset += compressedSize;
+        rawTotal += entry.rawSize;
+
+        std::cout << path << ": " << entry.width << "x" << entry.height << ", "
+                  << entry.rawSize << " -> " << entry.compressedSize << " bytes\n";
+        entries.push_back(entry);
+        blobs.push_back(compressed);
+    }
+
+    // Mục lục sắp theo hash để tra cứu nhị phân; dữ liệu vẫn theo thứ tự sprite
+    std::sort(entries.begin(), entries.end(), CompareHash);
+    for (size_t i = 1; i < entries.size() && ok; ++i) {
+        if (entries[i].pathHash == entries[i - 1].pathHash) {
+            std::cerr << "Hash collision: " << entries[i].path << " and " << entries[i - 1].path << "\n";
+            ok = false;
+        }
+    }
+
+    if (ok) {
+        std::ofstream out(outputPath.c_str(), std::ios::binary);
+        AssetPackHeader header;
+        std::memcpy(header.magic, "MGPK", 4);
+        header.version = ASSET_PACK_VERSION;
+        header.entryCount = static_cast<Uint32>(entries.size());
+        header.reserved = 0;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(AssetPackEntry));
+        for (const std::vector<Uint8>& blob : blobs) {
+            out.write(reinterpret_cast<const char*>(blob.data()), blob.size());
+        }
+        if (!out) {
+            std::cerr << "Cannot write " << outputPath << "\n";
+            ok = false;
+        } else {
+            std::cout << "Wrote " << outputPath << ": " << entries.size() << " images, "
+                      << rawTotal << " bytes of pixels in " << offset << " bytes\n";
+        }
+    }
+
+    IMG_Quit();
+    SDL_Quit();
+    return ok ? 0 : 1;
+}
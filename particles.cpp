@@ -0,0 +1,182 @@
+#include "particles.h"
+#include "hitbox.h"
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PARTICLES_SSE2 1
+#endif
+
+const float DEGREES_TO_RADIANS = 3.14159265f / 180.0f;
+
+//                                          count speed        angle         gravity life        size        color
+const ParticleEmitter EMITTER_HIT_SPARKS  = {24,  120.0f, 360.0f, 0.0f, 360.0f, 600.0f, 0.15f, 0.35f, 2.0f, 4.0f, {255, 220, 120, 255}};
+const ParticleEmitter EMITTER_DUST        = {16,  30.0f,  90.0f,  180.0f, 360.0f, 60.0f, 0.30f, 0.60f, 3.0f, 6.0f, {170, 150, 120, 200}};
+const ParticleEmitter EMITTER_DEATH_BURST = {400, 60.0f,  420.0f, 0.0f, 360.0f, 300.0f, 0.50f, 1.20f, 2.0f, 6.0f, {255, 120, 60, 255}};
+
+ParticleSystem::ParticleSystem() : count(0), randomState(0x9E3779B9u), lastUpdateTicks(0) {
+    posX = new float[MAX_PARTICLES];
+    posY = new float[MAX_PARTICLES];
+    velX = new float[MAX_PARTICLES];
+    velY = new float[MAX_PARTICLES];
+    gravity = new float[MAX_PARTICLES];
+    life = new float[MAX_PARTICLES];
+    lifeScale = new float[MAX_PARTICLES];
+    size = new float[MAX_PARTICLES];
+    color = new SDL_Color[MAX_PARTICLES];
+}
+
+ParticleSystem::~ParticleSystem() {
+    delete[] posX;
+    delete[] posY;
+    delete[] velX;
+    delete[] velY;
+    delete[] gravity;
+    delete[] life;
+    delete[] lifeScale;
+    delete[] size;
+    delete[] color;
+}
+
+float ParticleSystem::RandomRange(float low, float high) {
+    // xorshift32: nhanh và tách biệt với chuỗi RNG riêng của từng boss (gieo từ seed của lượt chơi),
+    // nên hiệu ứng hạt không làm lệch mô phỏng
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    float unit = static_cast<float>(randomState >> 8) * (1.0f / 16777216.0f);
+    return low + (high - low) * unit;
+}
+
+void ParticleSystem::Emit(const ParticleEmitter& emitter, float x, float y) {
+    int spawn = emitter.count;
+    if (spawn > MAX_PARTICLES - count) spawn = MAX_PARTICLES - count;
+    for (int i = 0; i < spawn; ++i) {
+        int index = count++;
+        float angle = RandomRange(emitter.minAngle, emitter.maxAngle) * DEGREES_TO_RADIANS;
+        float speed = RandomRange(emitter.minSpeed, emitter.maxSpeed);
+        float duration = RandomRange(emitter.minLife, emitter.maxLife);
+        posX[index] = x;
+        posY[index] = y;
+        velX[index] = std::cos(angle) * speed;
+        velY[index] = std::sin(angle) * speed;
+        gravity[index] = emitter.gravity;
+        life[index] = duration;
+        lifeScale[index] = 1.0f / duration;
+        size[index] = RandomRange(emitter.minSize, emitter.maxSize);
+        color[index] = emitter.color;
+    }
+}
+
+void ParticleSystem::Integrate(float dt) {
+    int i = 0;
+#ifdef PARTICLES_SSE2
+    // 4 hạt mỗi vòng lặp: v += g*dt; p += v*dt; life -= dt
+    __m128 step = _mm_set1_ps(dt);
+    for (; i + 4 <= count; i += 4) {
+        __m128 vy = _mm_add_ps(_mm_loadu_ps(velY + i), _mm_mul_ps(_mm_loadu_ps(gravity + i), step));
+        __m128 vx = _mm_loadu_ps(velX + i);
+        _mm_storeu_ps(velY + i, vy);
+        _mm_storeu_ps(posX + i, _mm_add_ps(_mm_loadu_ps(posX + i), _mm_mul_ps(vx, step)));
+        _mm_storeu_ps(posY + i, _mm_add_ps(_mm_loadu_ps(posY + i), _mm_mul_ps(vy, step)));
+        _mm_storeu_ps(life + i, _mm_sub_ps(_mm_loadu_ps(life + i), step));
+    }
+#endif
+    // Phần dư (hoặc toàn bộ khi không có SSE2)
+    for (; i < count; ++i) {
+        velY[i] += gravity[i] * dt;
+        posX[i] += velX[i] * dt;
+        posY[i] += velY[i] * dt;
+        life[i] -= dt;
+    }
+}
+
+void ParticleSystem::RemoveDead() {
+    int i = 0;
+    while (i < count) {
+        if (life[i] > 0.0f) {
+            ++i;
+            continue;
+        }
+        // Đổi chỗ với hạt cuối rồi kiểm tra lại vị trí i
+        int last = --count;
+        posX[i] = posX[last];
+        posY[i] = posY[last];
+        velX[i] = velX[last];
+        velY[i] = velY[last];
+        gravity[i] = gravity[last];
+        life[i] = life[last];
+        lifeScale[i] = lifeScale[last];
+        size[i] = size[last];
+        color[i] = color[last];
+    }
+}
+
+void ParticleSystem::Update(Uint32 dt) {
+    Uint64 start = SDL_GetPerformanceCounter();
+    Integrate(static_cast<float>(dt) * 0.001f);
+    RemoveDead();
+    lastUpdateTicks = SDL_GetPerformanceCounter() - start;
+}
+
+double ParticleSystem::GetLastUpdateMicros() const {
+    return static_cast<double>(lastUpdateTicks) * 1000000.0 / static_cast<double>(SDL_GetPerformanceFrequency());
+}
+
+void ParticleSystem::Render(RenderList& list) const {
+    if (count == 0) return;
+
+    // Hạt ở tọa độ thế giới: đổi sang tọa độ màn hình và loại hạt ngoài view như các lệnh Add*
+    float offsetX = 0.0f;
+    float offsetY = 0.0f;
+    if (list.hasView) {
+        offsetX = static_cast<float>(list.view.x);
+        offsetY = static_cast<float>(list.view.y);
+    }
+    float right = static_cast<float>(list.view.w);
+    float bottom = static_cast<float>(list.view.h);
+
+    int first = static_cast<int>(list.particles.size());
+    for (int i = 0; i < count; ++i) {
+        float x = posX[i] - offsetX;
+        float y = posY[i] - offsetY;
+        if (list.hasView && (x < -size[i] || y < -size[i] || x > right + size[i] || y > bottom + size[i])) continue;
+
+        // Mờ dần theo thời gian sống còn lại
+        float fade = life[i] * lifeScale[i];
+        RenderParticle particle;
+        particle.x = x;
+        particle.y = y;
+        particle.size = size[i];
+        particle.color = color[i];
+        particle.color.a = static_cast<Uint8>(color[i].a * (fade > 1.0f ? 1.0f : fade));
+        list.particles.push_back(particle);
+    }
+    list.AddParticleBatch(first, LAYER_PROJECTILE);
+}
+
+void ParticleSystem::OnGameEvents(void* context, const GameEvent* events, int count) {
+    ParticleSystem* system = static_cast<ParticleSystem*>(context);
+    for (int i = 0; i < count; ++i) {
+        const GameEvent& event = events[i];
+        float x = static_cast<float>(event.x);
+        float y = static_cast<float>(event.y);
+        switch (event.type) {
+        case EVENT_DAMAGED:
+        case EVENT_PROJECTILE_HIT:
+            system->Emit(EMITTER_HIT_SPARKS, x, y);
+            break;
+        case EVENT_ATTACK_STARTED:
+            if (event.amount == ATTACK_DASH) system->Emit(EMITTER_DUST, x, y);
+            break;
+        case EVENT_LANDED:
+            system->Emit(EMITTER_DUST, x, y);
+            break;
+        case EVENT_DIED:
+            if (event.team == TEAM_ENEMY) system->Emit(EMITTER_DEATH_BURST, x, y);
+            break;
+        default:
+            break;
+        }
+    }
+}
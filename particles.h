@@ -0,0 +1,71 @@
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include <SDL.h>
+#include "event_bus.h"
+#include "render_list.h"
+
+// Số hạt sống tối đa; hạt mới bị bỏ khi đầy
+const int MAX_PARTICLES = 32768;
+
+// Mẫu phát hạt: mỗi lần phát tạo count hạt tại một điểm, hướng ngẫu nhiên trong khoảng góc cho trước
+struct ParticleEmitter {
+    int count;
+    float minSpeed;     // pixel/giây
+    float maxSpeed;
+    float minAngle;     // Độ, 0 là sang phải, 90 là đi xuống (trục y của màn hình)
+    float maxAngle;
+    float gravity;      // pixel/giây^2
+    float minLife;      // Giây
+    float maxLife;
+    float minSize;      // Pixel
+    float maxSize;
+    SDL_Color color;
+};
+
+// Tia lửa khi trúng đòn, bụi khi lướt/tiếp đất, vụ nổ khi boss chết
+extern const ParticleEmitter EMITTER_HIT_SPARKS;
+extern const ParticleEmitter EMITTER_DUST;
+extern const ParticleEmitter EMITTER_DEATH_BURST;
+
+// Hệ thống hạt lưu dạng cấu trúc của mảng (mỗi thuộc tính một mảng float liền nhau) để vòng
+// cập nhật chạy bằng SIMD; hạt chết được thay bằng hạt cuối mảng nên các hạt sống luôn liền nhau.
+// Hạt chỉ để trang trí: dùng bộ sinh số riêng, không ảnh hưởng tới mô phỏng hay replay.
+class ParticleSystem {
+private:
+    float* posX;
+    float* posY;
+    float* velX;
+    float* velY;
+    float* gravity;
+    float* life;       // Thời gian còn lại (giây)
+    float* lifeScale;  // 1 / tổng thời gian sống, để tính độ mờ dần
+    float* size;
+    SDL_Color* color;
+    int count;
+    Uint32 randomState;
+    Uint64 lastUpdateTicks; // Thời gian Update() gần nhất, đơn vị performance counter
+
+    float RandomRange(float low, float high);
+    void Integrate(float dt);
+    void RemoveDead();
+
+public:
+    ParticleSystem();
+    ~ParticleSystem();
+
+    void Emit(const ParticleEmitter& emitter, float x, float y);
+    void Clear() { count = 0; }
+    void Update(Uint32 dt);
+    // Thêm các hạt nằm trong view hiện tại của list thành một lệnh vẽ duy nhất
+    void Render(RenderList& list) const;
+
+    int GetCount() const { return count; }
+    // Thời gian của lần Update() gần nhất, tính bằng micro giây
+    double GetLastUpdateMicros() const;
+
+    // Subscriber của EventBus: gắn emitter vào sự kiện gameplay
+    static void OnGameEvents(void* context, const GameEvent* events, int count);
+};
+
+#endif
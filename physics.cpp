@@ -0,0 +1,141 @@
+#include "physics.h"
+#include "level.h"
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <SDL.h>
+
+// Báo một lần khi một thân thể có nhiều nền tảng lân cận hơn MAX_QUERY_SOLIDS; phần dư bị bỏ qua
+// nên thân thể có thể rơi xuyên qua chúng. StepRange chạy song song nên cờ là atomic.
+static void ReportQueryOverflow(int found) {
+    static std::atomic<bool> reported(false);
+    if (reported.exchange(true)) return;
+    std::cout << "Physics error: " << found << " platforms near one body, only " << MAX_QUERY_SOLIDS
+              << " are checked; raise MAX_QUERY_SOLIDS or split the level geometry\n";
+}
+
+// Tìm nền tảng cao nhất mà cạnh dưới của vật cắt qua khi đi từ (fromX, fromBottom) tới (toX, toBottom)
+static const SDL_Rect* SweepPlatforms(int width, int fromX, int toX, int fromBottom, int toBottom,
+                                      const SDL_Rect* platforms, int platformCount) {
+    const SDL_Rect* hit = nullptr;
+    if (toBottom <= fromBottom) return hit; // Chỉ va chạm khi đang rơi xuống
+
+    for (int i = 0; i < platformCount; ++i) {
+        const SDL_Rect& platform = platforms[i];
+        if (platform.w <= 0) continue;
+        if (fromBottom > platform.y || toBottom < platform.y) continue;
+
+        // Vị trí x tại thời điểm cạnh dưới chạm mặt nền tảng
+        int x = fromX + (toX - fromX) * (platform.y - fromBottom) / (toBottom - fromBottom);
+        if (x + width > platform.x && x < platform.x + platform.w &&
+            (!hit || platform.y < hit->y)) {
+            hit = &platform;
+        }
+    }
+    return hit;
+}
+
+BodyContact StepBody(SDL_Rect& rect, int startX, int& verticalVelocity, int gravity,
+                     const SDL_Rect* platforms, int platformCount, int groundY) {
+    BodyContact contact = {false, false};
+
+    // Trọng lực tác dụng một lần mỗi tick, rồi quét cả quãng đường của tick trong một lần
+    verticalVelocity += gravity;
+    int fromBottom = rect.y + rect.h;
+    int toBottom = fromBottom + verticalVelocity;
+
+    const SDL_Rect* platform = SweepPlatforms(rect.w, startX, rect.x, fromBottom, toBottom, platforms, platformCount);
+    if (platform && platform->y <= groundY) {
+        rect.y = platform->y - rect.h;
+        verticalVelocity = 0;
+        contact.landed = true;
+        contact.onPlatform = true;
+    } else if (toBottom >= groundY) {
+        rect.y = groundY - rect.h;
+        verticalVelocity = 0;
+        contact.landed = true;
+        contact.onPlatform = false;
+    } else {
+        rect.y = toBottom - rect.h;
+    }
+    return contact;
+}
+
+PhysicsWorld::PhysicsWorld() : bodies(MAX_BODIES), bodyCount(0), time(0), level(nullptr) {
+    freeList.reserve(MAX_BODIES);
+    for (KinematicBody& body : bodies) {
+        body = {{0, 0, 0, 0}, 0, 0, false, false, {false, false}};
+    }
+}
+
+int PhysicsWorld::CreateBody(const SDL_Rect& rect) {
+    int id;
+    if (!freeList.empty()) {
+        id = freeList.back();
+        freeList.pop_back();
+    } else if (bodyCount < MAX_BODIES) {
+        id = bodyCount++;
+    } else {
+        std::cout << "Physics error: all " << MAX_BODIES << " bodies are in use\n";
+        return -1;
+    }
+    bodies[id] = {rect, rect.x, 0, false, true, {false, false}};
+    return id;
+}
+
+void PhysicsWorld::DestroyBody(int id) {
+    if (id < 0 || id >= bodyCount || !bodies[id].active) return;
+    bodies[id].active = false;
+    freeList.push_back(id);
+}
+
+void PhysicsWorld::BeginStep() {
+    for (int i = 0; i < bodyCount; ++i) {
+        bodies[i].startX = bodies[i].rect.x;
+    }
+}
+
+int PhysicsWorld::GetLevelWidth() const {
+    return level ? level->width : SCREEN_WIDTH;
+}
+
+int PhysicsWorld::GetGroundY() const {
+    return level ? level->groundY : GROUND_Y;
+}
+
+void PhysicsWorld::Step() {
+    StepRange(0, bodyCount);
+}
+
+void PhysicsWorld::StepRange(int begin, int end) {
+    int groundY = GetGroundY();
+    int solidIndices[MAX_QUERY_SOLIDS];
+    SDL_Rect nearbySolids[MAX_QUERY_SOLIDS];
+
+    for (int i = begin; i < end; ++i) {
+        KinematicBody& body = bodies[i];
+        if (!body.active) continue;
+
+        // Chỉ lấy các nền tảng trong vùng quét của bước này
+        int nearbyCount = 0;
+        if (level) {
+            int reach = std::abs(body.verticalVelocity) + GRAVITY;
+            int minX = body.startX < body.rect.x ? body.startX : body.rect.x;
+            int maxX = body.startX > body.rect.x ? body.startX : body.rect.x;
+            SDL_Rect sweep = {minX, body.rect.y - reach, maxX - minX + body.rect.w, body.rect.h + reach * 2};
+            nearbyCount = level->solidGrid.Query(sweep, solidIndices, MAX_QUERY_SOLIDS);
+            if (nearbyCount > MAX_QUERY_SOLIDS) {
+                ReportQueryOverflow(nearbyCount);
+                nearbyCount = MAX_QUERY_SOLIDS;
+            }
+            for (int n = 0; n < nearbyCount; ++n) {
+                nearbySolids[n] = level->solids[solidIndices[n]];
+            }
+        }
+
+        body.contact = StepBody(body.rect, body.startX, body.verticalVelocity, GRAVITY,
+                                nearbySolids, nearbyCount, groundY);
+        if (body.contact.landed) body.isOnGround = true;
+        body.startX = body.rect.x;
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef PHYSICS_H
+#define PHYSICS_H
+
+#include <SDL.h>
+#include <cassert>
+#include <vector>
+
+struct Level;
+
+// Hằng số dùng chung cho mọi đối tượng
+const int SCREEN_WIDTH = 1200;
+const int SCREEN_HEIGHT = 600;
+const int GRAVITY = 1;
+const int JUMP_STRENGTH = -20;
+
+// Độ cao mặt đất mặc định khi màn chơi không chỉ định
+const int GROUND_Y = 500;
+
+// Số nền tảng tối đa xét cho một thân thể trong một bước
+const int MAX_QUERY_SOLIDS = 64;
+
+// Nhịp của vòng lặp game: mỗi tick mô phỏng một lần rồi chờ chừng này ms
+const Uint32 FIXED_TICK_MS = 16;
+
+// Số thân thể tối đa; bộ nhớ được cấp phát một lần nên tham chiếu tới thân thể luôn hợp lệ
+const int MAX_BODIES = 1024;
+
+// Kết quả va chạm sau một bước vật lý
+struct BodyContact {
+    bool landed;     // Chạm đất hoặc nền tảng trong bước này
+    bool onPlatform; // Đứng trên nền tảng (không phải mặt đất)
+};
+
+// Thân thể động học: chỉ dữ liệu, được PhysicsWorld tích hợp trong một vòng lặp
+struct KinematicBody {
+    SDL_Rect rect;
+    int startX;           // Vị trí x đầu tick, dùng để quét va chạm
+    int verticalVelocity;
+    bool isOnGround;
+    bool active;
+    BodyContact contact;  // Kết quả của bước gần nhất
+};
+
+// Tích hợp trọng lực rồi quét (swept) đoạn di chuyển từ (startX, rect.y) tới (rect.x, rect.y + verticalVelocity)
+// với các nền tảng một chiều và mặt đất. Vị trí x khi cắt qua mặt nền tảng được nội suy nên
+// vật rơi nhanh không xuyên qua nền tảng dù vận tốc lớn đến đâu.
+BodyContact StepBody(SDL_Rect& rect, int startX, int& verticalVelocity, int gravity,
+                     const SDL_Rect* platforms, int platformCount, int groundY);
+
+class PhysicsWorld {
+private:
+    std::vector<KinematicBody> bodies; // Mảng liên tục, kích thước cố định MAX_BODIES
+    std::vector<int> freeList;
+    int bodyCount; // Chỉ số lớn nhất đã dùng + 1
+    Uint32 time;   // Đồng hồ game (ms) của thế giới, thay cho SDL_GetTicks trong logic đối tượng
+    const Level* level; // Hình học tĩnh; nullptr nghĩa là chỉ có mặt đất mặc định
+
+public:
+    PhysicsWorld();
+    // Trả về -1 khi đã hết MAX_BODIES chỗ; người tạo đối tượng phải kiểm tra HasFreeBody trước
+    int CreateBody(const SDL_Rect& rect);
+    void DestroyBody(int id);
+    bool HasFreeBody() const { return !freeList.empty() || bodyCount < MAX_BODIES; }
+    KinematicBody& GetBody(int id) {
+        assert(id >= 0 && id < MAX_BODIES);
+        return bodies[id];
+    }
+    int GetBodyCount() const { return bodyCount; }
+
+    // Màn chơi cung cấp nền tảng, mặt đất và giới hạn ngang; level phải sống lâu hơn mọi lần Step
+    void SetLevel(const Level* value) { level = value; }
+    int GetLevelWidth() const;
+    int GetGroundY() const;
+
+    // Thời gian game: mỗi thế giới có đồng hồ riêng nên mô phỏng có thể chạy nhanh hơn thời gian thực
+    Uint32 GetTime() const { return time; }
+    void AdvanceTime(Uint32 dt) { time += dt; }
+
+    // Ghi lại vị trí đầu tick của mọi thân thể, gọi trước khi cập nhật logic
+    void BeginStep();
+    // Tích hợp toàn bộ thân thể và giải quyết va chạm với nền tảng gần đó (tra qua lưới không gian)
+    void Step();
+    // Tích hợp các thân thể trong [begin, end); các đoạn không giao nhau có thể chạy song song
+    void StepRange(int begin, int end);
+};
+
+#endif
@@ -1,14 +1,11 @@
 #include "player.h"
+#include "physics.h"
 #include <SDL.h>
 
 using namespace std;
 
 // Constants
-const int SCREEN_WIDTH = 1200;
-const int SCREEN_HEIGHT = 600;
 const int PLAYER_SPEED = 5;
-const int GRAVITY = 1;
-const int JUMP_STRENGTH = -20;
 
 // Player frame counts
 const int RUN_FRAME_COUNT = 8;
@@ -29,195 +26,218 @@ const int DAMAGE_FRAME_HEIGHT = 128;
 const int DEATH_FRAME_WIDTH = 128;
 const int DEATH_FRAME_HEIGHT = 128;
 
-const Uint32 FRAME_DELAY = 70;
+// Khung của đòn đánh gây sát thương
+const int ATTACK_HIT_FRAME = 3;
+const int ATTACK_DAMAGE = 30;
+// Hộp đánh của cú chém (khung ATTACK_HIT_FRAME - 1 .. ATTACK_HIT_FRAME + 1) và hộp nhận đòn
+// hẹp hơn body vì hình nhân vật không phủ kín khung 120x120
+const SDL_Rect ATTACK_HIT_BOX = {70, 20, 90, 80};
+const SDL_Rect PLAYER_HURT_BOX = {20, 10, 80, 110};
 
-Player::Player(int x, int y, SDL_Texture* idle, SDL_Texture* run, SDL_Texture* attack, SDL_Texture* jump,
-                SDL_Texture* damage, SDL_Texture* death)
-    : rect{x, y, 120, 120}, health(7), maxHealth(7), verticalVelocity(0),
-      isJumping(false), isDoubleJumping(false), isOnGround(false), facingRight(true),
+const Uint32 PLAYER_FRAME_DELAY = 70;
+
+Player::Player(PhysicsWorld& world, int x, int y, int idle, int run, int attack, int jump, int damage, int death)
+    : world(world), bodyId(world.CreateBody({x, y, 120, 120})), rect(world.GetBody(bodyId).rect),
+      health(7), maxHealth(7), verticalVelocity(world.GetBody(bodyId).verticalVelocity),
+      isOnGround(world.GetBody(bodyId).isOnGround), isJumping(false), isDoubleJumping(false), facingRight(true),
       isAttacking(false), isDashing(false), canDash(true),
-      isTakingDamage(false), isDead(false),
-      currentRunFrame(0), currentAttackFrame(0), currentJumpFrame(0),
-      currentDamageFrame(0), currentDeathFrame(0), lastFrameTime(0),
+      isTakingDamage(false), isDead(false), isInvulnerable(false), isMoving(false), moveLeft(false), moveRight(false), invulnerabilityStartTime(0),
       dashSpeed(15), dashDuration(200), dashStartTime(0),
-      idleTexture(idle), runSheet(run), attackSheet(attack), jumpSheet(jump),
-      damageSheet(damage), deathSheet(death) {}
+      idleClip(MakeStretchedClip(idle)),
+      runClip(MakeClip(run, RUN_FRAME_COUNT, RUN_FRAME_WIDTH, RUN_FRAME_HEIGHT, PLAYER_FRAME_DELAY, true)),
+      attackClip(MakeClip(attack, ATTACK_FRAME_COUNT, ATTACK_FRAME_WIDTH, ATTACK_FRAME_HEIGHT, PLAYER_FRAME_DELAY, false, ATTACK_HIT_FRAME)),
+      jumpClip(MakeClip(jump, JUMP_FRAME_COUNT, JUMP_FRAME_WIDTH, JUMP_FRAME_HEIGHT, PLAYER_FRAME_DELAY, true)),
+      damageClip(MakeClip(damage, DAMAGE_FRAME_COUNT, DAMAGE_FRAME_WIDTH, DAMAGE_FRAME_HEIGHT, PLAYER_FRAME_DELAY, false)),
+      deathClip(MakeClip(death, DEATH_FRAME_COUNT, DEATH_FRAME_WIDTH, DEATH_FRAME_HEIGHT, PLAYER_FRAME_DELAY, false)),
+      animationEvents(ANIM_EVENT_NONE), attackSerial(0), events(nullptr) {
+    AddFrameBox(attackClip, BOX_HIT, ATTACK_HIT_FRAME - 1, ATTACK_HIT_FRAME + 1, ATTACK_HIT_BOX, ATTACK_DAMAGE);
+    AnimationClip* clips[] = {&idleClip, &runClip, &attackClip, &jumpClip, &damageClip};
+    for (AnimationClip* clip : clips) {
+        AddFrameBox(*clip, BOX_HURT, 0, -1, PLAYER_HURT_BOX);
+    }
+    animator.Play(&idleClip);
+}
+
+Player::~Player() {
+    world.DestroyBody(bodyId);
+}
+
+Uint32 Player::ApplyInput(const InputFrame& input) {
+    SetMoveInput(input.IsHeld(ACTION_MOVE_LEFT), input.IsHeld(ACTION_MOVE_RIGHT));
+    if (isDead) return 0;
+
+    if (input.WasPressed(ACTION_MOVE_LEFT)) Face(false);
+    if (input.WasPressed(ACTION_MOVE_RIGHT)) Face(true);
+
+    // Hành động bấm hơi sớm (đang đánh, đang lướt) được giữ trong cửa sổ đệm cho đến khi thực hiện được
+    Uint32 consumed = 0;
+    if (input.IsBuffered(ACTION_JUMP) && Jump()) consumed |= ActionBit(ACTION_JUMP);
+    if (input.IsBuffered(ACTION_ATTACK) && Attack()) consumed |= ActionBit(ACTION_ATTACK);
+    if (input.IsBuffered(ACTION_DASH) && Dash()) consumed |= ActionBit(ACTION_DASH);
+    return consumed;
+}
+
+void Player::SetMoveInput(bool left, bool right) {
+    moveLeft = left;
+    moveRight = right;
+}
 
-void Player::HandleInput(SDL_Event& e) {
+void Player::Face(bool right) {
     if (isDead) return;
+    facingRight = right;
+}
 
-    if (e.type == SDL_KEYDOWN) {
-        switch (e.key.keysym.sym) {
-            case SDLK_a:
-                facingRight = false;
-                break;
-            case SDLK_d:
-                facingRight = true;
-                break;
-            case SDLK_SPACE:
-                if (isOnGround) {
-                    isJumping = true;
-                    verticalVelocity = JUMP_STRENGTH;
-                    isOnGround = false;
-                } else if (!isDoubleJumping) {
-                    isDoubleJumping = true;
-                    verticalVelocity = JUMP_STRENGTH;
-                }
-                break;
-            case SDLK_j:
-                if (!isAttacking && !isTakingDamage) {
-                    isAttacking = true;
-                    currentAttackFrame = 0;
-                    lastFrameTime = SDL_GetTicks();
-                }
-                break;
-            case SDLK_LSHIFT:
-            case SDLK_RSHIFT:
-                if (!isDashing && canDash) {
-                    isDashing = true;
-                    dashStartTime = SDL_GetTicks();
-                    canDash = false;
-                }
-                break;
-        }
+bool Player::Jump() {
+    if (isDead) return false;
+    if (isOnGround) {
+        isJumping = true;
+        verticalVelocity = JUMP_STRENGTH;
+        isOnGround = false;
+        return true;
+    } else if (!isDoubleJumping) {
+        isDoubleJumping = true;
+        verticalVelocity = JUMP_STRENGTH;
+        return true;
+    }
+    return false;
+}
+
+bool Player::Attack() {
+    if (isDead) return false;
+    if (!isAttacking && !isTakingDamage) {
+        isAttacking = true;
+        attackSerial++;
+        animator.Play(&attackClip, true);
+        Emit(EVENT_ATTACK_STARTED, ATTACK_SLASH);
+        return true;
     }
-} // <-- Thiếu dấu đóng này lúc nãy!!!
+    return false;
+}
 
-void Player::Update(SDL_Rect* platforms, int platformCount) {
+bool Player::Dash() {
+    if (isDead) return false;
+    if (!isDashing && canDash) {
+        isDashing = true;
+        dashStartTime = world.GetTime();
+        canDash = false;
+        return true;
+    }
+    return false;
+}
+
+void Player::Update() {
     if (isDead) return;
 
-    // Di chuyển ngang
-    bool moveLeft = SDL_GetKeyboardState(nullptr)[SDL_SCANCODE_A];
-    bool moveRight = SDL_GetKeyboardState(nullptr)[SDL_SCANCODE_D];
+    // Di chuyển ngang theo input đã đặt bằng SetMoveInput
+    isMoving = moveLeft || moveRight;
 
     if (!isTakingDamage) {
         if (isDashing) {
             int speed = dashSpeed;
-            if (facingRight && rect.x + rect.w + speed < SCREEN_WIDTH) rect.x += speed;
+            if (facingRight && rect.x + rect.w + speed < world.GetLevelWidth()) rect.x += speed;
             else if (!facingRight && rect.x - speed > 0) rect.x -= speed;
-            if (SDL_GetTicks() - dashStartTime > dashDuration) isDashing = false;
+            if (world.GetTime() - dashStartTime > dashDuration) isDashing = false;
         } else {
             if (moveLeft && rect.x > 0) rect.x -= PLAYER_SPEED;
-            if (moveRight && rect.x + rect.w < SCREEN_WIDTH) rect.x += PLAYER_SPEED;
+            if (moveRight && rect.x + rect.w < world.GetLevelWidth()) rect.x += PLAYER_SPEED;
         }
     }
 
     // Cập nhật trạng thái miễn nhiễm
-    if (isInvulnerable && SDL_GetTicks() - invulnerabilityStartTime >= INVULNERABILITY_DURATION) {
+    if (isInvulnerable && world.GetTime() - invulnerabilityStartTime >= INVULNERABILITY_DURATION) {
         isInvulnerable = false;
     }
+}
 
-    // Vật lý
-    verticalVelocity += GRAVITY;
-    rect.y += verticalVelocity;
-
-    // Kiểm tra va chạm với nền tảng
-    bool onPlatform = false;
-    for (int i = 0; i < platformCount; ++i) {
-        if (rect.y + rect.h <= platforms[i].y + 20 &&
-            rect.y + rect.h + verticalVelocity >= platforms[i].y &&
-            rect.x + rect.w > platforms[i].x && rect.x < platforms[i].x + platforms[i].w &&
-            verticalVelocity > 0) {
-            rect.y = platforms[i].y - rect.h;
-            verticalVelocity = 0;
-            isOnGround = true;
-            isJumping = false;
-            isDoubleJumping = false;
-            canDash = true;
-            onPlatform = true;
-            break;
-        }
-    }
+void Player::ResolveContacts() {
+    if (isDead) return;
 
-    // Kiểm tra chạm mặt đất
-    if (rect.y + rect.h >= 500 && !onPlatform) {
-        rect.y = 500 - rect.h;
-        verticalVelocity = 0;
+    if (world.GetBody(bodyId).contact.landed) {
         isJumping = false;
         isDoubleJumping = false;
-        isOnGround = true;
         canDash = true;
     }
 }
 
-void Player::Render(SDL_Renderer* renderer) {
-    Uint32 currentTime = SDL_GetTicks();
-    SDL_Rect srcRect, destRect;
-    SDL_RendererFlip flip = facingRight ? SDL_FLIP_NONE : SDL_FLIP_HORIZONTAL;
-    SDL_Texture* currentTexture = nullptr;
+const AnimationClip* Player::SelectClip() const {
+    if (isDead) return &deathClip;
+    if (isTakingDamage) return &damageClip;
+    if (isAttacking) return &attackClip;
+    if (isJumping || isDoubleJumping) return &jumpClip;
+    if (isMoving) return &runClip;
+    return &idleClip;
+}
 
-    if (isDead) {
-        if (currentTime > lastFrameTime + FRAME_DELAY) {
-            lastFrameTime = currentTime;
-            currentDeathFrame++;
+void Player::Animate(Uint32 dt) {
+    animator.Play(SelectClip());
+    animationEvents = animator.Update(dt);
+    if (animationEvents & ANIM_EVENT_FINISHED) {
+        if (animator.GetClip() == &damageClip) {
+            isTakingDamage = false;
+        } else if (animator.GetClip() == &attackClip) {
+            isAttacking = false;
         }
-        srcRect = {currentDeathFrame * DEATH_FRAME_WIDTH, 0, DEATH_FRAME_WIDTH, DEATH_FRAME_HEIGHT};
-        destRect = {rect.x + (rect.w - DEATH_FRAME_WIDTH) / 2, rect.y + (rect.h - DEATH_FRAME_HEIGHT), DEATH_FRAME_WIDTH, DEATH_FRAME_HEIGHT};
-        SDL_RenderCopyEx(renderer, deathSheet, &srcRect, &destRect, 0, nullptr, flip);
-    } else if (isTakingDamage) {
-        if (currentTime > lastFrameTime + FRAME_DELAY) {
-            lastFrameTime = currentTime;
-            currentDamageFrame++;
-            if (currentDamageFrame >= DAMAGE_FRAME_COUNT) {
-                isTakingDamage = false;
-                currentDamageFrame = 0;
-            }
-        }
-        srcRect = {currentDamageFrame * DAMAGE_FRAME_WIDTH, 0, DAMAGE_FRAME_WIDTH, DAMAGE_FRAME_HEIGHT};
-        destRect = {rect.x + (rect.w - DAMAGE_FRAME_WIDTH) / 2, rect.y + (rect.h - DAMAGE_FRAME_HEIGHT), DAMAGE_FRAME_WIDTH, DAMAGE_FRAME_HEIGHT};
-        SDL_RenderCopyEx(renderer, damageSheet, &srcRect, &destRect, 0, nullptr, flip);
-    } else if (isAttacking) {
-        if (currentTime > lastFrameTime + FRAME_DELAY) {
-            lastFrameTime = currentTime;
-            currentAttackFrame++;
-            if (currentAttackFrame >= ATTACK_FRAME_COUNT) {
-                isAttacking = false;
-                currentAttackFrame = 0;
-            }
-        }
-        srcRect = {currentAttackFrame * ATTACK_FRAME_WIDTH, 0, ATTACK_FRAME_WIDTH, ATTACK_FRAME_HEIGHT};
-        destRect = {rect.x + (rect.w - ATTACK_FRAME_WIDTH) / 2, rect.y + (rect.h - ATTACK_FRAME_HEIGHT), ATTACK_FRAME_WIDTH, ATTACK_FRAME_HEIGHT};
-        SDL_RenderCopyEx(renderer, attackSheet, &srcRect, &destRect, 0, nullptr, flip);
-    } else if (isJumping || isDoubleJumping) {
-        if (currentTime > lastFrameTime + FRAME_DELAY) {
-            lastFrameTime = currentTime;
-            currentJumpFrame = (currentJumpFrame + 1) % JUMP_FRAME_COUNT;
-        }
-        srcRect = {currentJumpFrame * JUMP_FRAME_WIDTH, 0, JUMP_FRAME_WIDTH, JUMP_FRAME_HEIGHT};
-        destRect = {rect.x + (rect.w - JUMP_FRAME_WIDTH) / 2, rect.y + (rect.h - JUMP_FRAME_HEIGHT), JUMP_FRAME_WIDTH, JUMP_FRAME_HEIGHT};
-        SDL_RenderCopyEx(renderer, jumpSheet, &srcRect, &destRect, 0, nullptr, flip);
-    } else if (SDL_GetKeyboardState(nullptr)[SDL_SCANCODE_A] || SDL_GetKeyboardState(nullptr)[SDL_SCANCODE_D]) {
-        if (currentTime > lastFrameTime + FRAME_DELAY) {
-            lastFrameTime = currentTime;
-            currentRunFrame = (currentRunFrame + 1) % RUN_FRAME_COUNT;
-        }
-        srcRect = {currentRunFrame * RUN_FRAME_WIDTH, 0, RUN_FRAME_WIDTH, RUN_FRAME_HEIGHT};
-        destRect = {rect.x + (rect.w - RUN_FRAME_WIDTH) / 2, rect.y + (rect.h - RUN_FRAME_HEIGHT), RUN_FRAME_WIDTH, RUN_FRAME_HEIGHT};
-        SDL_RenderCopyEx(renderer, runSheet, &srcRect, &destRect, 0, nullptr, flip);
-    } else {
-        SDL_RenderCopyEx(renderer, idleTexture, nullptr, &rect, 0, nullptr, flip);
     }
 }
 
+void Player::Render(RenderList& list) const {
+    SDL_RendererFlip flip = facingRight ? SDL_FLIP_NONE : SDL_FLIP_HORIZONTAL;
+    animator.Draw(list, rect, flip, LAYER_ACTOR);
+}
+
+void Player::CollectBoxes(HitWorld& hits) {
+    if (isDead) return;
+    animator.Play(SelectClip());
+    hits.AddClipBoxes(animator, rect, facingRight, bodyId, TEAM_PLAYER, attackSerial);
+}
+
+void Player::Emit(int type, int amount) {
+    if (events) events->Publish(type, bodyId, TEAM_PLAYER, amount, rect);
+}
+
 void Player::TakeDamage(int amount) {
     if (isDead || isInvulnerable) return;
     health -= amount;
     if (health <= 0) {
         health = 0;
         isDead = true;
-        currentDeathFrame = 0;
-        lastFrameTime = SDL_GetTicks();
+        animator.Play(&deathClip, true);
+        Emit(EVENT_DIED);
     } else {
         isTakingDamage = true;
         isInvulnerable = true;
-        invulnerabilityStartTime = SDL_GetTicks();
-        currentDamageFrame = 0;
-        lastFrameTime = SDL_GetTicks();
+        invulnerabilityStartTime = world.GetTime();
+        animator.Play(&damageClip, true);
+        Emit(EVENT_DAMAGED, health);
     }
 }
 
-void Player::Reset() {
-    rect = {120, 400, 120, 120};
+void Player::HashState(StateHash& hash) const {
+    hash.Add(rect);
+    hash.Add(verticalVelocity);
+    hash.Add(isOnGround);
+    hash.Add(health);
+    hash.Add(isJumping);
+    hash.Add(isDoubleJumping);
+    hash.Add(facingRight);
+    hash.Add(isAttacking);
+    hash.Add(isDashing);
+    hash.Add(canDash);
+    hash.Add(isTakingDamage);
+    hash.Add(isDead);
+    hash.Add(isInvulnerable);
+    hash.Add(isMoving);
+    hash.Add(moveLeft);
+    hash.Add(moveRight);
+    hash.Add(invulnerabilityStartTime);
+    hash.Add(dashStartTime);
+    hash.Add(attackSerial);
+    hash.Add(animationEvents);
+    animator.HashState(hash);
+}
+
+void Player::Reset(int x, int y) {
+    rect = {x, y, 120, 120};
     health = maxHealth;
     verticalVelocity = 0;
     isJumping = false;
@@ -230,10 +250,9 @@ void Player::Reset() {
     isTakingDamage = false;
     isDead = false;
     isInvulnerable = false;
-    currentRunFrame = 0;
-    currentAttackFrame = 0;
-    currentJumpFrame = 0;
-    currentDamageFrame = 0;
-    currentDeathFrame = 0;
-    lastFrameTime = 0;
+    isMoving = false;
+    moveLeft = false;
+    moveRight = false;
+    animator.Play(&idleClip, true);
+    animationEvents = ANIM_EVENT_NONE;
 }
@@ -2,21 +2,30 @@
     #define PLAYER_H
 
     #include <SDL.h>
+    #include "physics.h"
+    #include "animation.h"
+    #include "input.h"
+    #include "hitbox.h"
+    #include "event_bus.h"
 
     class Player {
     private:
-        // Vị trí và kích thước nhân vật
-        SDL_Rect rect;
+        // Thân thể vật lý trong PhysicsWorld
+        PhysicsWorld& world;
+        int bodyId;
+
+        // Vị trí và kích thước nhân vật (tham chiếu tới thân thể)
+        SDL_Rect& rect;
 
         // Sức khỏe
         int health;
         const int maxHealth;
 
         // Trạng thái vật lý
-        int verticalVelocity;
+        int& verticalVelocity;
+        bool& isOnGround;
         bool isJumping;
         bool isDoubleJumping;
-        bool isOnGround;
         bool facingRight;
 
         // Trạng thái hành động
@@ -26,15 +35,10 @@
         bool isTakingDamage;
         bool isDead;
         bool isInvulnerable; // Thêm: trạng thái miễn nhiễm
+        bool isMoving;
+        bool moveLeft;  // Input di chuyển giữ phím của tick hiện tại
+        bool moveRight;
 
-
-        // Trạng thái hoạt ảnh
-        int currentRunFrame;
-        int currentAttackFrame;
-        int currentJumpFrame;
-        int currentDamageFrame;
-        int currentDeathFrame;
-        Uint32 lastFrameTime;
         Uint32 invulnerabilityStartTime; // Thêm: thời điểm bắt đầu miễn nhiễm
         static const Uint32 INVULNERABILITY_DURATION = 1500; // 500ms miễn nhiễm
 
@@ -43,28 +47,54 @@
         int dashDuration;
         Uint32 dashStartTime;
 
-        // Texture hoạt ảnh
-        SDL_Texture* idleTexture;
-        SDL_Texture* runSheet;
-        SDL_Texture* attackSheet;
-        SDL_Texture* jumpSheet;
-        SDL_Texture* damageSheet;
-        SDL_Texture* deathSheet;
+        // Clip hoạt ảnh
+        AnimationClip idleClip;
+        AnimationClip runClip;
+        AnimationClip attackClip;
+        AnimationClip jumpClip;
+        AnimationClip damageClip;
+        AnimationClip deathClip;
+        Animator animator;
+        int animationEvents; // Sự kiện hoạt ảnh của tick gần nhất
+        Uint32 attackSerial; // Cú chém hiện tại, mỗi cú chém trúng một mục tiêu một lần
+        EventBus* events;    // nullptr: không phát sự kiện (bộ mô phỏng cân bằng)
+
+        void Emit(int type, int amount = 0);
+
+        const AnimationClip* SelectClip() const; // Clip ứng với trạng thái hiện tại
 
     public:
-        Player(int x, int y, SDL_Texture* idle, SDL_Texture* run, SDL_Texture* attack, SDL_Texture* jump,
-               SDL_Texture* damage, SDL_Texture* death);
-        void HandleInput(SDL_Event& e);
-        void Update(SDL_Rect* platforms, int platformCount);
-        void Render(SDL_Renderer* renderer);
+        // Tạo trước mọi kẻ địch của màn để luôn còn thân vật lý trong world
+        Player(PhysicsWorld& world, int x, int y, int idle, int run, int attack, int jump, int damage, int death);
+        ~Player();
+        // Áp dụng input của tick; trả về bitmask các hành động đã đệm được dùng (để InputSystem::Consume)
+        Uint32 ApplyInput(const InputFrame& input);
+        // Lệnh điều khiển, dùng chung cho input và người chơi giả lập; trả về true nếu thực hiện được
+        void SetMoveInput(bool left, bool right);
+        void Face(bool right);
+        bool Jump();
+        bool Attack();
+        bool Dash();
+        void Update();
+        void ResolveContacts(); // Xử lý kết quả va chạm sau PhysicsWorld::Step
+        void Animate(Uint32 dt); // Chọn clip theo trạng thái và tiến hoạt ảnh theo thời gian game
+        void Render(RenderList& list) const;
+        // Thêm hộp đánh/hộp nhận đòn của khung hiện tại vào lượt kiểm tra va chạm của tick
+        void CollectBoxes(HitWorld& hits);
         void TakeDamage(int amount);
-        void Reset();
+        void Reset(int x, int y); // Hồi sinh tại điểm xuất phát của màn
+        void HashState(StateHash& hash) const; // Đưa trạng thái mô phỏng vào mã băm của tick
+        void SetEventBus(EventBus* bus) { events = bus; }
         SDL_Rect& GetRect() { return rect; }
+        const SDL_Rect& GetRect() const { return rect; }
         int GetHealth() const { return health; }
         bool IsAttacking() const { return isAttacking; }
         bool IsDead() const { return isDead; }
         bool IsInvulnerable() const { return isInvulnerable; } // Thêm: kiểm tra miễn nhiễm
-        SDL_Rect GetAttackHitbox() { return rect; }
+        bool IsOnGround() const { return isOnGround; }
+        bool IsFacingRight() const { return facingRight; }
+        int GetAnimationEvents() const { return animationEvents; }
+        int GetBodyId() const { return bodyId; }
 
     };
 
@@ -0,0 +1,123 @@
+#include "render_list.h"
+#include <cstring>
+
+RenderList::RenderList() : clearColor{0, 0, 0, 255}, hasView(false), view{0, 0, 0, 0}, snapshotTag(-1) {
+    items.reserve(RENDER_ITEM_CAPACITY);
+    sortScratch.reserve(RENDER_ITEM_CAPACITY);
+    texts.reserve(RENDER_TEXT_CAPACITY);
+    particles.reserve(RENDER_PARTICLE_CAPACITY);
+}
+
+void RenderList::Clear(SDL_Color color) {
+    items.clear();
+    texts.clear();
+    particles.clear();
+    clearColor = color;
+    hasView = false;
+}
+
+void RenderList::SetView(const SDL_Rect& worldView) {
+    hasView = true;
+    view = worldView;
+}
+
+void RenderList::ResetView() {
+    hasView = false;
+}
+
+void RenderList::AddSprite(int sprite, const SDL_Rect* src, const SDL_Rect& dst, int layer, SDL_RendererFlip flip) {
+    if (hasView && !SDL_HasIntersection(&dst, &view)) return;
+
+    RenderItem item;
+    item.sprite = static_cast<Uint16>(sprite);
+    item.kind = RENDER_SPRITE;
+    item.layer = static_cast<Uint8>(layer);
+    item.flip = static_cast<Uint8>(flip);
+    item.color = {255, 255, 255, 255};
+    item.src = src ? *src : SDL_Rect{0, 0, 0, 0};
+    item.dst = dst;
+    if (hasView) {
+        item.dst.x -= view.x;
+        item.dst.y -= view.y;
+    }
+    items.push_back(item);
+}
+
+void RenderList::AddFillRect(const SDL_Rect& dst, SDL_Color color, int layer) {
+    if (hasView && !SDL_HasIntersection(&dst, &view)) return;
+
+    RenderItem item;
+    item.sprite = 0;
+    item.kind = RENDER_FILL_RECT;
+    item.layer = static_cast<Uint8>(layer);
+    item.flip = SDL_FLIP_NONE;
+    item.color = color;
+    item.src = {0, 0, 0, 0};
+    item.dst = dst;
+    if (hasView) {
+        item.dst.x -= view.x;
+        item.dst.y -= view.y;
+    }
+    items.push_back(item);
+}
+
+void RenderList::AddText(const char* text, int x, int y, SDL_Color color) {
+    RenderText entry;
+    std::strncpy(entry.text, text, sizeof(entry.text) - 1);
+    entry.text[sizeof(entry.text) - 1] = '\0';
+    entry.x = x;
+    entry.y = y;
+    entry.color = color;
+    texts.push_back(entry);
+}
+
+void RenderList::AddStaticLayers(const StaticScene& scene, const SDL_Rect& worldView) {
+    for (int i = 0; i < static_cast<int>(scene.layers.size()); ++i) {
+        const StaticLayer& layer = scene.layers[i];
+        RenderItem item;
+        item.sprite = static_cast<Uint16>(i);
+        item.kind = RENDER_STATIC_LAYER;
+        item.layer = static_cast<Uint8>(layer.renderLayer);
+        item.flip = SDL_FLIP_NONE;
+        item.color = {255, 255, 255, 255};
+        item.src = {worldView.x * layer.parallaxPercent / 100, worldView.y * layer.parallaxPercent / 100,
+                    worldView.w, worldView.h};
+        item.dst = {0, 0, worldView.w, worldView.h};
+        items.push_back(item);
+    }
+}
+
+void RenderList::AddParticleBatch(int first, int layer) {
+    int count = static_cast<int>(particles.size()) - first;
+    if (count <= 0) return;
+
+    RenderItem item;
+    item.sprite = 0;
+    item.kind = RENDER_PARTICLES;
+    item.layer = static_cast<Uint8>(layer);
+    item.flip = SDL_FLIP_NONE;
+    item.color = {255, 255, 255, 255};
+    item.src = {first, 0, count, 0};
+    item.dst = {0, 0, 0, 0};
+    items.push_back(item);
+}
+
+void RenderList::SortByLayer() {
+    // std::stable_sort cấp phát bộ đệm tạm mỗi lần gọi; lớp chỉ là Uint8 nên đếm theo lớp
+    // rồi rải vào sortScratch (tái sử dụng) là đủ và vẫn ổn định
+    int offsets[256] = {0};
+    for (const RenderItem& item : items) {
+        offsets[item.layer]++;
+    }
+    int start = 0;
+    for (int layer = 0; layer < 256; ++layer) {
+        int count = offsets[layer];
+        offsets[layer] = start;
+        start += count;
+    }
+    sortScratch.resize(items.size());
+    for (const RenderItem& item : items) {
+        sortScratch[offsets[item.layer]++] = item;
+    }
+    items.swap(sortScratch);
+}
@@ -0,0 +1,129 @@
+#ifndef RENDER_LIST_H
+#define RENDER_LIST_H
+
+#include <SDL.h>
+#include <atomic>
+#include <vector>
+
+// Dung lượng đặt trước của mỗi RenderList để khung hình bình thường không cấp phát heap
+const int RENDER_ITEM_CAPACITY = 1024;
+const int RENDER_TEXT_CAPACITY = 32;
+const int RENDER_PARTICLE_CAPACITY = 4096;
+
+// Thứ tự vẽ, lớp nhỏ vẽ trước
+enum RenderLayer {
+    LAYER_BACKGROUND = 0,
+    LAYER_PLATFORM,
+    LAYER_ACTOR,
+    LAYER_PROJECTILE,
+    LAYER_UI,
+    LAYER_OVERLAY
+};
+
+enum RenderItemKind {
+    RENDER_SPRITE = 0,
+    RENDER_FILL_RECT,
+    RENDER_STATIC_LAYER, // Blit một lớp tĩnh đã dựng sẵn; sprite là chỉ số lớp, src là vùng trong lớp
+    RENDER_PARTICLES     // Một lô hạt vẽ bằng một lần gọi; src.x là hạt đầu tiên, src.w là số hạt
+};
+
+// Một lệnh vẽ gọn nhẹ; không chứa con trỏ nên có thể sao chép tự do giữa các luồng
+struct RenderItem {
+    Uint16 sprite;   // SpriteId
+    Uint8 kind;      // RenderItemKind
+    Uint8 layer;     // RenderLayer
+    Uint8 flip;      // SDL_RendererFlip
+    SDL_Color color; // Màu cho RENDER_FILL_RECT
+    SDL_Rect src;    // Khung trên spritesheet, w == 0 nghĩa là toàn bộ texture
+    SDL_Rect dst;
+};
+
+// Chữ được vẽ căn giữa tại (x, y)
+struct RenderText {
+    char text[32];
+    int x;
+    int y;
+    SDL_Color color;
+};
+
+// Hạt vuông tô màu, tọa độ màn hình (tâm hạt)
+struct RenderParticle {
+    float x;
+    float y;
+    float size;
+    SDL_Color color;
+};
+
+// Một lớp tĩnh (nền, parallax, nền tảng, trang trí) được luồng render dựng một lần thành
+// texture render-target. Lớp cuộn theo camera với hệ số parallaxPercent (0: đứng yên, 100: theo thế giới).
+struct StaticLayer {
+    int parallaxPercent;
+    int renderLayer;               // RenderLayer khi blit
+    int width;                     // Kích thước của texture cache
+    int height;
+    std::vector<RenderItem> items; // Lệnh vẽ trong tọa độ của lớp
+};
+
+// Toàn bộ phần tĩnh của một màn chơi, gửi cho luồng render khi vào màn
+struct StaticScene {
+    std::vector<StaticLayer> layers;
+};
+
+// Ảnh chụp bất biến của một khung hình do luồng mô phỏng tạo ra
+struct RenderList {
+    std::vector<RenderItem> items;
+    std::vector<RenderText> texts;
+    std::vector<RenderParticle> particles; // Dữ liệu của các lệnh RENDER_PARTICLES
+    SDL_Color clearColor;
+    bool hasView;  // true: lệnh Add* nhận tọa độ thế giới, bị loại nếu ngoài view và được đổi sang tọa độ màn hình
+    SDL_Rect view;
+    int snapshotTag; // >= 0: luồng render đọc lại khung hình này và giao cho SnapshotHandler
+    std::vector<RenderItem> sortScratch; // Bộ đệm của SortByLayer, giữ dung lượng giữa các khung hình
+
+    RenderList();
+    void Clear(SDL_Color color);
+    // Chuyển sang tọa độ thế giới nhìn qua view (thường là Camera::GetView())
+    void SetView(const SDL_Rect& worldView);
+    // Trở về tọa độ màn hình cho UI và lớp phủ
+    void ResetView();
+    void AddSprite(int sprite, const SDL_Rect* src, const SDL_Rect& dst, int layer, SDL_RendererFlip flip = SDL_FLIP_NONE);
+    void AddFillRect(const SDL_Rect& dst, SDL_Color color, int layer);
+    void AddText(const char* text, int x, int y, SDL_Color color);
+    // Một lệnh blit cho mỗi lớp tĩnh, cuộn theo worldView; không phụ thuộc view hiện tại của list
+    void AddStaticLayers(const StaticScene& scene, const SDL_Rect& worldView);
+    // Gom các hạt đã thêm vào particles từ vị trí first tới cuối thành một lệnh vẽ
+    void AddParticleBatch(int first, int layer);
+    // Sắp xếp ổn định theo lớp (đếm theo lớp), giữ thứ tự thêm vào trong cùng một lớp; không cấp phát
+    // khi số lệnh vẽ không vượt quá khung hình lớn nhất trước đó
+    void SortByLayer();
+};
+
+// Bộ đệm ba: bên ghi luôn có một ô riêng, bên đọc luôn lấy được ô mới nhất mà không phải chờ
+template <typename T>
+class TripleBuffer {
+private:
+    static const int INDEX_MASK = 3;
+    static const int FRESH_BIT = 4;
+
+    T slots[3];
+    std::atomic<int> middle; // Chỉ số ô trung gian kèm cờ "có dữ liệu mới"
+    int back;
+    int front;
+
+public:
+    TripleBuffer() : middle(1), back(0), front(2) {}
+
+    // Phía ghi
+    T& Back() { return slots[back]; }
+    void Publish() { back = middle.exchange(back | FRESH_BIT) & INDEX_MASK; }
+
+    // Phía đọc: trả về true nếu lấy được ô mới
+    bool Acquire() {
+        if (!(middle.load() & FRESH_BIT)) return false;
+        front = middle.exchange(front) & INDEX_MASK;
+        return true;
+    }
+    const T& Front() const { return slots[front]; }
+};
+
+#endif
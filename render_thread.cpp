@@ -0,0 +1,589 @@
+#include "render_thread.h"
+#include "asset_pack.h"
+#include "metrics.h"
+#include "physics.h"
+#include <SDL.h>
+#include <SDL_image.h>
+#include <SDL_ttf.h>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+RenderThread::RenderThread()
+    : window(nullptr), renderer(nullptr), font(nullptr), softwareRenderer(false), software(nullptr), softwareTexture(nullptr),
+      dynamicScale(false), capture(nullptr),
+      snapshotHandler(nullptr), snapshotContext(nullptr), lastSnapshotTag(-1), sceneTarget(nullptr), sceneWidth(0),
+      sceneHeight(0), scaleStep(0), governorFrames(0), governorTotalMs(0.0), governorCalmWindows(0), sceneDirty(false), frameCounter(0),
+      hasNewFrame(false), startupDone(false), startupOk(false), running(false) {
+    for (int i = 0; i < SPRITE_COUNT; ++i) {
+        textures[i] = nullptr;
+    }
+    for (int i = 0; i < TEXT_CACHE_SIZE; ++i) {
+        textCache[i].text[0] = '\0';
+        textCache[i].texture = nullptr;
+        textCache[i].lastUsedFrame = 0;
+    }
+}
+
+RenderThread::~RenderThread() {
+    Stop();
+}
+
+bool RenderThread::Start(SDL_Window* targetWindow, TTF_Font* textFont) {
+    window = targetWindow;
+    font = textFont;
+    running = true;
+    thread = std::thread(&RenderThread::Run, this);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    wake.wait(lock, [this] { return startupDone; });
+    if (!startupOk) {
+        lock.unlock();
+        Stop();
+    }
+    return startupOk;
+}
+
+void RenderThread::Stop() {
+    if (!thread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    wake.notify_all();
+    snapshotTaken.notify_all();
+    thread.join();
+}
+
+void RenderThread::EndFrame() {
+    frames.Publish();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        hasNewFrame = true;
+    }
+    wake.notify_all();
+}
+
+void RenderThread::SetStaticScene(const StaticScene& scene) {
+    std::lock_guard<std::mutex> lock(mutex);
+    pendingScene = scene;
+    sceneDirty = true;
+}
+
+void RenderThread::InvalidateStaticLayers() {
+    std::lock_guard<std::mutex> lock(mutex);
+    sceneDirty = true;
+}
+
+void RenderThread::ReloadSprite(int sprite) {
+    if (sprite <= SPRITE_NONE || sprite >= SPRITE_COUNT) return;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (std::find(pendingReloads.begin(), pendingReloads.end(), sprite) == pendingReloads.end()) {
+        pendingReloads.push_back(sprite);
+    }
+}
+
+bool RenderThread::CreateRenderer() {
+    if (!softwareRenderer) {
+        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+        if (!renderer) {
+            std::cout << "Accelerated renderer unavailable (" << SDL_GetError() << "), falling back to software rendering\n";
+        }
+    }
+    if (!renderer) {
+        // Renderer phần mềm của SDL chỉ dùng để trình chiếu khung hình do SoftwareRenderer vẽ
+        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
+        if (!renderer) {
+            std::cout << "SDL_CreateRenderer Error: " << SDL_GetError() << "\n";
+            return false;
+        }
+        softwareTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ABGR8888, SDL_TEXTUREACCESS_STREAMING,
+                                            SCREEN_WIDTH, SCREEN_HEIGHT);
+        if (!softwareTexture) {
+            std::cout << "SDL_CreateTexture Error: " << SDL_GetError() << "\n";
+            return false;
+        }
+        software = new SoftwareRenderer(SCREEN_WIDTH, SCREEN_HEIGHT, font);
+        std::cout << "Using software rendering\n";
+    }
+    // Hình chữ nhật có alpha < 255 (lớp phủ tạm dừng) được hòa trộn với nội dung bên dưới
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    // Cửa sổ đổi kích thước hoặc toàn màn hình: SDL co giãn và thêm viền đen, chuột được đổi về tọa độ logic
+    SDL_RenderSetLogicalSize(renderer, SCREEN_WIDTH, SCREEN_HEIGHT);
+    return true;
+}
+
+static SDL_Texture* LoadTexture(SDL_Renderer* renderer, const std::string& path) {
+    SDL_Surface* surface = IMG_Load(path.c_str());
+    if (!surface) {
+        std::cout << "IMG_Load Error: " << IMG_GetError() << " (file: " << path << ")\n";
+        return nullptr;
+    }
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_FreeSurface(surface);
+    if (!texture) {
+        std::cout << "SDL_CreateTextureFromSurface Error: " << SDL_GetError() << " (file: " << path << ")\n";
+    } else {
+        std::cout << "Successfully loaded texture: " << path << "\n";
+    }
+    return texture;
+}
+
+// Tạo texture từ điểm ảnh đã giải mã sẵn trong gói, không qua bộ giải mã PNG
+static SDL_Texture* LoadPackedTexture(SDL_Renderer* renderer, const AssetPack& pack, const AssetPackEntry& entry,
+                                      std::vector<Uint8>& pixels) {
+    if (!pack.ReadPixels(entry, pixels)) return nullptr;
+    SDL_Texture* texture = SDL_CreateTexture(renderer, entry.format, SDL_TEXTUREACCESS_STATIC, entry.width, entry.height);
+    if (!texture) {
+        std::cout << "SDL_CreateTexture Error: " << SDL_GetError() << " (file: " << entry.path << ")\n";
+        return nullptr;
+    }
+    SDL_UpdateTexture(texture, nullptr, pixels.data(), entry.width * 4);
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    return texture;
+}
+
+bool RenderThread::LoadTextures() {
+    if (software) return software->LoadImages();
+
+    // Ưu tiên gói asset; ảnh không có trong gói (hoặc không có gói) nạp từ file PNG rời
+    AssetPack pack;
+    pack.Open(ASSET_PACK_PATH);
+    std::vector<Uint8> pixels; // Bộ đệm giải nén dùng chung cho mọi ảnh
+
+    bool ok = true;
+    for (int i = SPRITE_NONE + 1; i < SPRITE_COUNT; ++i) {
+        const AssetPackEntry* entry = pack.Find(GetSpritePath(i));
+        textures[i] = entry ? LoadPackedTexture(renderer, pack, *entry, pixels) : nullptr;
+        if (!textures[i]) textures[i] = LoadTexture(renderer, GetSpritePath(i));
+        if (!textures[i]) ok = false;
+    }
+    return ok;
+}
+
+void RenderThread::ReloadTexture(int sprite) {
+    if (software) {
+        software->ReloadImage(sprite);
+        return;
+    }
+    const char* path = GetSpritePath(sprite);
+    SDL_Surface* surface = IMG_Load(path);
+    if (!surface) {
+        std::cout << "IMG_Load Error: " << IMG_GetError() << " (file: " << path << ")\n";
+        return;
+    }
+
+    // Cùng kích thước: ghi đè điểm ảnh vào texture cũ, handle giữ nguyên
+    Uint32 format;
+    int width, height;
+    SDL_Texture* texture = textures[sprite];
+    if (texture && SDL_QueryTexture(texture, &format, nullptr, &width, &height) == 0 &&
+        width == surface->w && height == surface->h) {
+        SDL_Surface* converted = SDL_ConvertSurfaceFormat(surface, format, 0);
+        if (converted && SDL_UpdateTexture(texture, nullptr, converted->pixels, converted->pitch) == 0) {
+            std::cout << "Reloaded texture in place: " << path << "\n";
+            SDL_FreeSurface(converted);
+            SDL_FreeSurface(surface);
+            return;
+        }
+        if (converted) SDL_FreeSurface(converted);
+    }
+
+    // Kích thước đổi (hoặc không cập nhật được): thay texture của sprite
+    SDL_Texture* replacement = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_FreeSurface(surface);
+    if (!replacement) {
+        std::cout << "SDL_CreateTextureFromSurface Error: " << SDL_GetError() << " (file: " << path << ")\n";
+        return;
+    }
+    if (texture) SDL_DestroyTexture(texture);
+    textures[sprite] = replacement;
+    std::cout << "Reloaded texture: " << path << "\n";
+}
+
+void RenderThread::DestroyResources() {
+    DestroyStaticLayers();
+    if (sceneTarget) SDL_DestroyTexture(sceneTarget);
+    sceneTarget = nullptr;
+    if (softwareTexture) SDL_DestroyTexture(softwareTexture);
+    softwareTexture = nullptr;
+    delete software;
+    software = nullptr;
+    for (int i = 0; i < TEXT_CACHE_SIZE; ++i) {
+        if (textCache[i].texture) SDL_DestroyTexture(textCache[i].texture);
+        textCache[i].texture = nullptr;
+    }
+    for (int i = 0; i < SPRITE_COUNT; ++i) {
+        if (textures[i]) SDL_DestroyTexture(textures[i]);
+        textures[i] = nullptr;
+    }
+    if (renderer) SDL_DestroyRenderer(renderer);
+    renderer = nullptr;
+}
+
+void RenderThread::Run() {
+    bool ok = CreateRenderer() && LoadTextures();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        startupDone = true;
+        startupOk = ok;
+    }
+    wake.notify_all();
+
+    while (ok) {
+        bool rebuild = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return hasNewFrame || !running; });
+            if (!running) break;
+            hasNewFrame = false;
+            if (sceneDirty) {
+                staticScene = pendingScene;
+                sceneDirty = false;
+                rebuild = true;
+            }
+            reloads.swap(pendingReloads);
+        }
+        if (!reloads.empty()) {
+            for (int sprite : reloads) {
+                ReloadTexture(sprite);
+            }
+            reloads.clear();
+            rebuild = true; // Lớp tĩnh có thể chứa ảnh vừa đổi
+        }
+        if (rebuild) {
+            RebuildStaticLayers();
+        }
+        if (frames.Acquire()) {
+            if (software) {
+                DrawSoftware(frames.Front());
+            } else {
+                Draw(frames.Front());
+            }
+        }
+    }
+
+    DestroyResources();
+}
+
+void RenderThread::DestroyStaticLayers() {
+    for (SDL_Texture* texture : staticTextures) {
+        if (texture) SDL_DestroyTexture(texture);
+    }
+    staticTextures.clear();
+}
+
+void RenderThread::RebuildStaticLayers() {
+    if (software) {
+        software->SetStaticScene(staticScene);
+        return;
+    }
+    DestroyStaticLayers();
+
+    SDL_RendererInfo info;
+    bool targetsSupported = SDL_RenderTargetSupported(renderer) && SDL_GetRendererInfo(renderer, &info) == 0;
+
+    for (const StaticLayer& layer : staticScene.layers) {
+        SDL_Texture* texture = nullptr;
+        bool fits = targetsSupported && layer.width > 0 && layer.height > 0 &&
+                    (info.max_texture_width == 0 || layer.width <= info.max_texture_width) &&
+                    (info.max_texture_height == 0 || layer.height <= info.max_texture_height);
+        if (fits) {
+            texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, layer.width, layer.height);
+        }
+        if (texture) {
+            // Vẽ mọi lệnh của lớp vào texture một lần, nền trong suốt để các lớp chồng lên nhau
+            SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+            SDL_SetRenderTarget(renderer, texture);
+            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+            SDL_RenderClear(renderer);
+            for (const RenderItem& item : layer.items) {
+                DrawItem(item);
+            }
+            SDL_SetRenderTarget(renderer, nullptr);
+        } else {
+            std::cout << "Static layer " << layer.width << "x" << layer.height << " not cached, drawing directly\n";
+        }
+        staticTextures.push_back(texture);
+    }
+}
+
+void RenderThread::DrawStaticLayer(const RenderItem& item) {
+    if (item.sprite < 0 || item.sprite >= static_cast<int>(staticTextures.size())) return;
+
+    SDL_Texture* texture = staticTextures[item.sprite];
+    if (texture) {
+        SDL_RenderCopy(renderer, texture, &item.src, &item.dst);
+        return;
+    }
+
+    // Không có cache: vẽ các lệnh của lớp nằm trong vùng nhìn thấy
+    const StaticLayer& layer = staticScene.layers[item.sprite];
+    for (const RenderItem& layerItem : layer.items) {
+        if (!SDL_HasIntersection(&layerItem.dst, &item.src)) continue;
+        RenderItem shifted = layerItem;
+        shifted.dst.x += item.dst.x - item.src.x;
+        shifted.dst.y += item.dst.y - item.src.y;
+        DrawItem(shifted);
+    }
+}
+
+RenderThread::CachedText* RenderThread::FindCachedText(const RenderText& text) {
+    CachedText* oldest = &textCache[0];
+    for (int i = 0; i < TEXT_CACHE_SIZE; ++i) {
+        CachedText& entry = textCache[i];
+        if (entry.texture && std::strcmp(entry.text, text.text) == 0 &&
+            entry.color.r == text.color.r && entry.color.g == text.color.g &&
+            entry.color.b == text.color.b && entry.color.a == text.color.a) {
+            return &entry;
+        }
+        if (!entry.texture || (oldest->texture && entry.lastUsedFrame < oldest->lastUsedFrame)) {
+            oldest = &entry;
+        }
+    }
+
+    // Chưa có: tạo texture mới vào ô trống hoặc ô lâu nhất không dùng
+    SDL_Surface* surface = TTF_RenderText_Solid(font, text.text, text.color);
+    if (!surface) {
+        std::cerr << "TTF_RenderText_Solid Error: " << TTF_GetError() << "\n";
+        return nullptr;
+    }
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_FreeSurface(surface);
+    if (!texture) {
+        std::cerr << "SDL_CreateTextureFromSurface Error: " << SDL_GetError() << "\n";
+        return nullptr;
+    }
+    if (oldest->texture) SDL_DestroyTexture(oldest->texture);
+    std::strcpy(oldest->text, text.text);
+    oldest->color = text.color;
+    oldest->texture = texture;
+    SDL_QueryTexture(texture, nullptr, nullptr, &oldest->width, &oldest->height);
+    return oldest;
+}
+
+void RenderThread::DrawText(const RenderText& text) {
+    if (!font) return;
+    CachedText* entry = FindCachedText(text);
+    if (!entry) return;
+    entry->lastUsedFrame = frameCounter;
+    SDL_Rect dstRect = {text.x - entry->width / 2, text.y - entry->height / 2, entry->width, entry->height};
+    SDL_RenderCopy(renderer, entry->texture, nullptr, &dstRect);
+}
+
+void RenderThread::DrawParticles(const RenderList& list, const RenderItem& item) {
+    int first = item.src.x;
+    int count = item.src.w;
+    if (first < 0 || count <= 0 || first + count > static_cast<int>(list.particles.size())) return;
+
+    // Mỗi hạt là một hình vuông 4 đỉnh, 6 chỉ số; cả lô vẽ bằng một lần SDL_RenderGeometry
+    particleVertices.resize(count * 4);
+    particleIndices.resize(count * 6);
+    for (int i = 0; i < count; ++i) {
+        const RenderParticle& particle = list.particles[first + i];
+        float half = particle.size * 0.5f;
+        SDL_Vertex* vertex = &particleVertices[i * 4];
+        vertex[0].position = {particle.x - half, particle.y - half};
+        vertex[1].position = {particle.x + half, particle.y - half};
+        vertex[2].position = {particle.x + half, particle.y + half};
+        vertex[3].position = {particle.x - half, particle.y + half};
+        for (int corner = 0; corner < 4; ++corner) {
+            vertex[corner].color = particle.color;
+            vertex[corner].tex_coord = {0.0f, 0.0f};
+        }
+
+        int base = i * 4;
+        int* index = &particleIndices[i * 6];
+        index[0] = base;
+        index[1] = base + 1;
+        index[2] = base + 2;
+        index[3] = base;
+        index[4] = base + 2;
+        index[5] = base + 3;
+    }
+
+    if (SDL_RenderGeometry(renderer, nullptr, particleVertices.data(), count * 4,
+                           particleIndices.data(), count * 6) != 0) {
+        std::cerr << "SDL_RenderGeometry Error: " << SDL_GetError() << "\n";
+    }
+}
+
+void RenderThread::DrawItem(const RenderItem& item) {
+    if (item.kind == RENDER_FILL_RECT) {
+        SDL_SetRenderDrawColor(renderer, item.color.r, item.color.g, item.color.b, item.color.a);
+        SDL_RenderFillRect(renderer, &item.dst);
+    } else if (item.kind == RENDER_STATIC_LAYER) {
+        DrawStaticLayer(item);
+    } else if (item.sprite > SPRITE_NONE && item.sprite < SPRITE_COUNT && textures[item.sprite]) {
+        const SDL_Rect* src = item.src.w > 0 ? &item.src : nullptr;
+        SDL_RenderCopyEx(renderer, textures[item.sprite], src, &item.dst, 0, nullptr,
+                         static_cast<SDL_RendererFlip>(item.flip));
+    }
+}
+
+bool RenderThread::PrepareSceneTarget() {
+    if (!SDL_RenderTargetSupported(renderer)) return false;
+    float scale = 1.0f - scaleStep * RENDER_SCALE_STEP;
+    int width = static_cast<int>(SCREEN_WIDTH * scale);
+    int height = static_cast<int>(SCREEN_HEIGHT * scale);
+    if (sceneTarget && width == sceneWidth && height == sceneHeight) return true;
+
+    // Chỉ tạo lại khi đổi bậc tỉ lệ
+    if (sceneTarget) SDL_DestroyTexture(sceneTarget);
+    sceneTarget = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+    if (!sceneTarget) {
+        std::cout << "Scene target " << width << "x" << height << " not available, drawing directly: " << SDL_GetError() << "\n";
+        return false;
+    }
+    SDL_SetTextureScaleMode(sceneTarget, SDL_ScaleModeLinear);
+    sceneWidth = width;
+    sceneHeight = height;
+    std::cout << "Render scale " << static_cast<int>(scale * 100) << "% (" << width << "x" << height << ")\n";
+    return true;
+}
+
+void RenderThread::UpdateGovernor(double frameMs) {
+    // Chỉ khi đang quay hình (không phải chỉ có FrameCapture) và khi chụp ảnh chuẩn mới cần kích thước cố định
+    if (!dynamicScale || (capture && capture->IsRecording()) || snapshotHandler) {
+        scaleStep = 0;
+        governorFrames = 0;
+        governorTotalMs = 0.0;
+        governorCalmWindows = 0;
+        return;
+    }
+    governorTotalMs += frameMs;
+    if (++governorFrames < GOVERNOR_WINDOW) return;
+
+    double average = governorTotalMs / governorFrames;
+    governorFrames = 0;
+    governorTotalMs = 0.0;
+    if (average > GOVERNOR_LOWER_MS) {
+        governorCalmWindows = 0;
+        if (scaleStep + 1 < RENDER_SCALE_STEPS) scaleStep++;
+    } else if (average < GOVERNOR_RAISE_MS) {
+        if (++governorCalmWindows >= GOVERNOR_RAISE_WINDOWS && scaleStep > 0) {
+            scaleStep--;
+            governorCalmWindows = 0;
+        }
+    } else {
+        governorCalmWindows = 0;
+    }
+}
+
+void RenderThread::Draw(const RenderList& list) {
+    Uint64 drawStart = SDL_GetPerformanceCounter();
+    bool offscreen = PrepareSceneTarget();
+    if (offscreen) {
+        SDL_SetRenderTarget(renderer, sceneTarget);
+        SDL_RenderSetScale(renderer, static_cast<float>(sceneWidth) / SCREEN_WIDTH,
+                           static_cast<float>(sceneHeight) / SCREEN_HEIGHT);
+    }
+    SDL_SetRenderDrawColor(renderer, list.clearColor.r, list.clearColor.g, list.clearColor.b, list.clearColor.a);
+    SDL_RenderClear(renderer);
+    frameCounter++;
+
+    for (const RenderItem& item : list.items) {
+        if (item.kind == RENDER_PARTICLES) {
+            DrawParticles(list, item);
+        } else {
+            DrawItem(item);
+        }
+    }
+
+    for (const RenderText& text : list.texts) {
+        DrawText(text);
+    }
+
+    // Thời gian chuẩn bị lệnh vẽ, không tính thời gian chờ vsync trong Present
+    MetricRecordSince(METRIC_DRAW_TIME, drawStart);
+    MetricSet(METRIC_DRAW_CALLS, static_cast<Sint64>(list.items.size() + list.texts.size()));
+    MetricAdd(METRIC_FRAMES_DRAWN);
+    MetricSet(METRIC_RENDER_SCALE, offscreen ? sceneWidth * 100 / SCREEN_WIDTH : 100);
+
+    // Đọc điểm ảnh của cảnh ở độ phân giải logic, không phụ thuộc kích thước cửa sổ.
+    // Không có texture trung gian thì đọc back buffer trước Present (sau Present nội dung không còn xác định)
+    int width = sceneWidth;
+    int height = sceneHeight;
+    if (offscreen) {
+        SDL_RenderSetScale(renderer, 1.0f, 1.0f);
+    } else if (SDL_GetRendererOutputSize(renderer, &width, &height) != 0) {
+        width = 0;
+        height = 0;
+    }
+    if (capture && width > 0) CaptureOutput(width, height);
+    if (list.snapshotTag >= 0) TakeSnapshot(list.snapshotTag, width, height);
+
+    if (offscreen) {
+        SDL_SetRenderTarget(renderer, nullptr);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+        SDL_RenderCopy(renderer, sceneTarget, nullptr, nullptr);
+    }
+    SDL_RenderPresent(renderer);
+    UpdateGovernor(static_cast<double>(SDL_GetPerformanceCounter() - drawStart) * 1000.0 / SDL_GetPerformanceFrequency());
+}
+
+void RenderThread::DrawSoftware(const RenderList& list) {
+    Uint64 drawStart = SDL_GetPerformanceCounter();
+    frameCounter++;
+    const std::vector<SDL_Rect>& dirty = software->Draw(list);
+
+    // Chỉ các vùng vẽ lại được tải lên texture
+    const Uint32* pixels = software->GetPixels();
+    int width = software->GetWidth();
+    for (const SDL_Rect& rect : dirty) {
+        SDL_UpdateTexture(softwareTexture, &rect, pixels + static_cast<size_t>(rect.y) * width + rect.x, width * 4);
+    }
+
+    MetricRecordSince(METRIC_DRAW_TIME, drawStart);
+    MetricSet(METRIC_DRAW_CALLS, static_cast<Sint64>(dirty.size()));
+    MetricAdd(METRIC_FRAMES_DRAWN);
+    MetricSet(METRIC_RENDER_SCALE, 100);
+    if (capture) CaptureOutput(width, software->GetHeight());
+    if (list.snapshotTag >= 0) TakeSnapshot(list.snapshotTag, width, software->GetHeight());
+
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+    SDL_RenderCopy(renderer, softwareTexture, nullptr, nullptr);
+    SDL_RenderPresent(renderer);
+}
+
+void RenderThread::TakeSnapshot(int tag, int width, int height) {
+    if (snapshotHandler && software) {
+        // Khung hình của SoftwareRenderer đã ở dạng RGBA liền nhau, giao thẳng không cần sao chép
+        snapshotHandler(snapshotContext, tag, reinterpret_cast<const Uint8*>(software->GetPixels()), width, height);
+    } else if (snapshotHandler && width > 0) {
+        snapshotPixels.resize(static_cast<size_t>(width) * height * 4);
+        if (SDL_RenderReadPixels(renderer, nullptr, SDL_PIXELFORMAT_ABGR8888, snapshotPixels.data(), width * 4) == 0) {
+            snapshotHandler(snapshotContext, tag, snapshotPixels.data(), width, height);
+        } else {
+            std::cout << "SDL_RenderReadPixels Error: " << SDL_GetError() << "\n";
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        lastSnapshotTag = tag;
+    }
+    snapshotTaken.notify_all();
+}
+
+void RenderThread::WaitForSnapshot(int tag) {
+    std::unique_lock<std::mutex> lock(mutex);
+    snapshotTaken.wait(lock, [this, tag] { return lastSnapshotTag >= tag || !running; });
+}
+
+void RenderThread::CaptureOutput(int width, int height) {
+    CapturedFrame* frame = capture->AcquireFrame(width, height);
+    if (!frame) return;
+
+    // Bản sao duy nhất: từ renderer thẳng vào bộ đệm của pool, luồng mã hóa làm phần còn lại
+    if (software) {
+        std::memcpy(frame->pixels.data(), software->GetPixels(), frame->pixels.size());
+    } else if (SDL_RenderReadPixels(renderer, nullptr, SDL_PIXELFORMAT_ABGR8888, frame->pixels.data(), width * 4) != 0) {
+        std::cout << "SDL_RenderReadPixels Error: " << SDL_GetError() << "\n";
+        capture->ReleaseFrame(frame);
+        return;
+    }
+    capture->SubmitFrame(frame);
+}
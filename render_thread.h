@@ -0,0 +1,151 @@
+#ifndef RENDER_THREAD_H
+#define RENDER_THREAD_H
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "frame_capture.h"
+#include "render_list.h"
+#include "software_renderer.h"
+#include "sprites.h"
+
+// Nhận điểm ảnh RGBA của khung hình có snapshotTag, gọi trên luồng render
+typedef void (*SnapshotHandler)(void* context, int tag, const Uint8* pixels, int width, int height);
+
+// Số chuỗi chữ giữ sẵn texture; chữ trên màn hình gần như không đổi giữa các khung hình
+const int TEXT_CACHE_SIZE = 32;
+
+// Mọi tọa độ của game là tọa độ logic SCREEN_WIDTH x SCREEN_HEIGHT; cảnh được vẽ vào một texture
+// trung gian cỡ (kích thước logic x tỉ lệ render) rồi phóng lên cửa sổ, giữ nguyên tỉ lệ khung hình.
+// Tỉ lệ render đi theo bậc: 100%, 87.5%, 75%, 62.5%, 50%
+const int RENDER_SCALE_STEPS = 5;
+const float RENDER_SCALE_STEP = 0.125f;
+// Bộ điều tốc đánh giá thời gian vẽ (Draw tới hết Present) trung bình sau mỗi GOVERNOR_WINDOW khung hình:
+// trên GOVERNOR_LOWER_MS thì hạ một bậc ngay, dưới GOVERNOR_RAISE_MS đủ GOVERNOR_RAISE_WINDOWS lần liền
+// thì nâng một bậc. Khoảng cách hai ngưỡng lớn hơn chênh lệch chi phí giữa hai bậc nên không dao động.
+const int GOVERNOR_WINDOW = 30;
+const double GOVERNOR_LOWER_MS = 14.0;
+const double GOVERNOR_RAISE_MS = 8.0;
+const int GOVERNOR_RAISE_WINDOWS = 4;
+
+// Luồng render riêng: sở hữu SDL_Renderer và toàn bộ texture, vẽ RenderList mới nhất
+// do luồng mô phỏng công bố qua bộ đệm ba. Renderer được tạo ngay trên luồng này
+// vì SDL yêu cầu mọi lệnh vẽ chạy trên luồng đã tạo renderer.
+// Không tạo được renderer tăng tốc (hoặc chạy không cửa sổ) thì khung hình được vẽ bằng
+// SoftwareRenderer, SDL chỉ còn tải các vùng đã vẽ lại lên một texture streaming và trình chiếu.
+class RenderThread {
+private:
+    SDL_Window* window;
+    SDL_Renderer* renderer;
+    TTF_Font* font;
+    SDL_Texture* textures[SPRITE_COUNT];
+    bool softwareRenderer;   // Vẽ bằng CPU ngay từ đầu (chạy không cửa sổ, máy không có GPU)
+    SoftwareRenderer* software;     // nullptr: vẽ bằng SDL_Renderer tăng tốc
+    SDL_Texture* softwareTexture;   // Khung hình của SoftwareRenderer, cập nhật theo vùng bẩn
+    bool dynamicScale;       // Bật bộ điều tốc tỉ lệ render
+    FrameCapture* capture;   // nullptr: không quay khung hình
+    SnapshotHandler snapshotHandler;
+    void* snapshotContext;
+    std::vector<Uint8> snapshotPixels;
+    int lastSnapshotTag;     // Bảo vệ bởi mutex
+    std::condition_variable snapshotTaken;
+
+    // Texture trung gian của cảnh; nullptr khi renderer không hỗ trợ render target (vẽ thẳng lên cửa sổ)
+    SDL_Texture* sceneTarget;
+    int sceneWidth;
+    int sceneHeight;
+    int scaleStep;           // 0: 100%, tăng dần khi hạ chất lượng
+    int governorFrames;
+    double governorTotalMs;
+    int governorCalmWindows;
+
+    // Lớp tĩnh: pendingScene và sceneDirty được bảo vệ bởi mutex, phần còn lại chỉ luồng render dùng
+    StaticScene pendingScene;
+    bool sceneDirty;
+    StaticScene staticScene;
+    std::vector<SDL_Texture*> staticTextures; // nullptr: không dựng được cache, vẽ trực tiếp từng lệnh
+
+    std::vector<int> pendingReloads; // Sprite cần nạp lại từ đĩa, bảo vệ bởi mutex
+    std::vector<int> reloads;        // Bản sao của luồng render, tái sử dụng bộ nhớ
+
+    // Texture của chữ đã vẽ, dùng lại khi cùng nội dung và màu; thay thế chuỗi lâu nhất không dùng
+    struct CachedText {
+        char text[sizeof(RenderText::text)];
+        SDL_Color color;
+        SDL_Texture* texture;
+        int width;
+        int height;
+        Uint32 lastUsedFrame;
+    };
+    CachedText textCache[TEXT_CACHE_SIZE];
+    Uint32 frameCounter;
+
+    // Bộ đệm đỉnh/chỉ số của lô hạt, tái sử dụng giữa các khung hình
+    std::vector<SDL_Vertex> particleVertices;
+    std::vector<int> particleIndices;
+
+    TripleBuffer<RenderList> frames;
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool hasNewFrame;
+    bool startupDone;
+    bool startupOk;
+    std::atomic<bool> running;
+
+    void Run();
+    bool CreateRenderer();
+    bool LoadTextures();
+    void ReloadTexture(int sprite);
+    void DestroyResources();
+    void RebuildStaticLayers();
+    void DestroyStaticLayers();
+    void Draw(const RenderList& list);
+    void DrawSoftware(const RenderList& list);
+    void DrawItem(const RenderItem& item);
+    void DrawStaticLayer(const RenderItem& item);
+    void DrawParticles(const RenderList& list, const RenderItem& item);
+    bool PrepareSceneTarget();
+    void UpdateGovernor(double frameMs);
+    void CaptureOutput(int width, int height);
+    void TakeSnapshot(int tag, int width, int height);
+    void DrawText(const RenderText& text);
+    CachedText* FindCachedText(const RenderText& text);
+
+public:
+    RenderThread();
+    ~RenderThread();
+
+    // Cấu hình trước Start()
+    void SetSoftwareRendering(bool value) { softwareRenderer = value; }
+    // Quay hình và so ảnh chuẩn luôn dùng tỉ lệ 100% để mọi khung hình cùng kích thước
+    void SetDynamicScale(bool value) { dynamicScale = value; }
+    void SetFrameCapture(FrameCapture* value) { capture = value; }
+    void SetSnapshotHandler(SnapshotHandler handler, void* context) {
+        snapshotHandler = handler;
+        snapshotContext = context;
+    }
+
+    // Khởi động luồng và chờ đến khi renderer và texture sẵn sàng
+    bool Start(SDL_Window* window, TTF_Font* font);
+    void Stop();
+
+    // Luồng mô phỏng ghi khung hình vào BeginFrame() rồi công bố bằng EndFrame()
+    RenderList& BeginFrame() { return frames.Back(); }
+    void EndFrame();
+
+    // Gửi phần tĩnh của màn mới; luồng render dựng lại cache trước khung hình kế tiếp
+    void SetStaticScene(const StaticScene& scene);
+    // Dựng lại cache từ scene hiện tại (cửa sổ đổi kích thước, render target bị mất)
+    void InvalidateStaticLayers();
+    // Nạp lại ảnh của sprite từ đĩa trước khung hình kế tiếp (hot reload)
+    void ReloadSprite(int sprite);
+    // Chờ tới khi khung hình có snapshotTag = tag đã được vẽ và giao cho SnapshotHandler.
+    // Luồng mô phỏng phải chờ trước khi công bố khung hình tiếp theo, nếu không khung có tag có thể bị bỏ qua.
+    void WaitForSnapshot(int tag);
+};
+
+#endif
@@ -0,0 +1,78 @@
+#include "replay.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+const Uint32 REPLAY_VERSION = 2; // 2: thêm mã băm trạng thái cho mỗi tick
+
+// Header file replay; sau đó là tickCount bản ghi ReplayTick liền nhau
+struct ReplayHeader {
+    char magic[4]; // "MGRP"
+    Uint32 version;
+    Uint32 seed;
+    Sint32 startLevel;
+    Uint32 tickCount;
+};
+
+bool SaveReplay(const std::string& path, const Replay& replay) {
+    std::ofstream file(path.c_str(), std::ios::binary);
+    if (!file) {
+        std::cout << "Replay error: cannot write " << path << "\n";
+        return false;
+    }
+
+    ReplayHeader header;
+    std::memcpy(header.magic, "MGRP", 4);
+    header.version = REPLAY_VERSION;
+    header.seed = replay.seed;
+    header.startLevel = replay.startLevel;
+    header.tickCount = static_cast<Uint32>(replay.ticks.size());
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(replay.ticks.data()), replay.ticks.size() * sizeof(ReplayTick));
+    if (!file) {
+        std::cout << "Replay error: failed writing " << path << "\n";
+        return false;
+    }
+    std::cout << "Saved replay " << path << ": " << replay.ticks.size() << " ticks\n";
+    return true;
+}
+
+bool LoadReplay(const std::string& path, Replay& replay) {
+    std::ifstream file(path.c_str(), std::ios::binary);
+    if (!file) {
+        std::cout << "Replay error: cannot open " << path << "\n";
+        return false;
+    }
+
+    ReplayHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, "MGRP", 4) != 0 || header.version != REPLAY_VERSION) {
+        std::cout << "Replay error: " << path << " is not a version " << REPLAY_VERSION << " replay\n";
+        return false;
+    }
+
+    Replay loaded;
+    loaded.seed = header.seed;
+    loaded.startLevel = header.startLevel;
+    loaded.ticks.resize(header.tickCount);
+    if (!file.read(reinterpret_cast<char*>(loaded.ticks.data()), loaded.ticks.size() * sizeof(ReplayTick))) {
+        std::cout << "Replay error: " << path << " is truncated\n";
+        return false;
+    }
+
+    replay = loaded;
+    return true;
+}
+
+int FindFirstDivergence(const Replay& a, const Replay& b) {
+    size_t count = a.ticks.size() < b.ticks.size() ? a.ticks.size() : b.ticks.size();
+    for (size_t i = 0; i < count; ++i) {
+        const ReplayTick& left = a.ticks[i];
+        const ReplayTick& right = b.ticks[i];
+        if (left.stateHash != right.stateHash || left.dt != right.dt ||
+            std::memcmp(&left.input, &right.input, sizeof(InputFrame)) != 0) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
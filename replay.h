@@ -0,0 +1,31 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <SDL.h>
+#include <string>
+#include <vector>
+#include "input.h"
+
+// Một tick của trận đấu: thời gian trôi qua, input đã đưa vào mô phỏng và mã băm
+// trạng thái mô phỏng ngay sau tick (StateHash) để phát hiện tick đầu tiên hai lần chạy lệch nhau
+struct ReplayTick {
+    Uint32 dt;
+    InputFrame input;
+    Uint32 stateHash;
+};
+
+// Bản ghi trận đấu: với cùng seed, màn bắt đầu và chuỗi tick, mô phỏng chạy lại y hệt
+struct Replay {
+    Uint32 seed;
+    int startLevel;
+    std::vector<ReplayTick> ticks;
+};
+
+// Ghi/đọc file replay nhị phân; LoadReplay giữ nguyên replay nếu file lỗi
+bool SaveReplay(const std::string& path, const Replay& replay);
+bool LoadReplay(const std::string& path, Replay& replay);
+// Tick đầu tiên (tính từ 0) mà input, dt hoặc mã băm trạng thái của hai replay khác nhau;
+// -1 nếu phần chung giống hệt nhau
+int FindFirstDivergence(const Replay& a, const Replay& b);
+
+#endif
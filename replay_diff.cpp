@@ -0,0 +1,54 @@
+// Công cụ so sánh hai replay: báo tick đầu tiên mà mô phỏng của hai lần chạy (hoặc hai bản build) lệch nhau.
+// Ghi lần chạy thứ hai bằng cách phát lại lần đầu: MyGame --replay a.mgrp --record b.mgrp
+// rồi chạy: replay_diff a.mgrp b.mgrp
+// Trả về 0 nếu hai replay giống hệt nhau, 1 nếu lệch, 2 nếu lỗi tham số hoặc file.
+#include <SDL.h>
+#include <iostream>
+#include <string>
+#include "replay.h"
+
+static void PrintTick(const char* label, const ReplayTick& tick) {
+    std::cout << "  " << label << ": dt " << tick.dt << ", held " << std::hex << tick.input.held
+              << ", pressed " << tick.input.pressed << ", state hash " << tick.stateHash << std::dec << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cout << "Usage: replay_diff <a.mgrp> <b.mgrp>\n";
+        return 2;
+    }
+
+    Replay a;
+    Replay b;
+    if (!LoadReplay(argv[1], a) || !LoadReplay(argv[2], b)) return 2;
+
+    if (a.seed != b.seed || a.startLevel != b.startLevel) {
+        std::cout << "Replays start differently: seed " << a.seed << " / " << b.seed << ", level " << a.startLevel
+                  << " / " << b.startLevel << "\n";
+        return 1;
+    }
+
+    int tick = FindFirstDivergence(a, b);
+    if (tick < 0) {
+        if (a.ticks.size() != b.ticks.size()) {
+            std::cout << "Identical for " << (a.ticks.size() < b.ticks.size() ? a.ticks.size() : b.ticks.size())
+                      << " ticks, then one replay ends (" << a.ticks.size() << " / " << b.ticks.size() << " ticks)\n";
+            return 1;
+        }
+        std::cout << "Identical: " << a.ticks.size() << " ticks\n";
+        return 0;
+    }
+
+    // Input khác nhau: lần chạy sau không được phát lại từ lần đầu, lệch trạng thái là hệ quả.
+    // Input giống mà mã băm khác: mô phỏng không tất định ở tick này
+    const ReplayTick& left = a.ticks[tick];
+    const ReplayTick& right = b.ticks[tick];
+    bool sameInput = left.dt == right.dt && left.input.held == right.input.held &&
+                     left.input.pressed == right.input.pressed && left.input.released == right.input.released &&
+                     left.input.buffered == right.input.buffered;
+    std::cout << "First divergence at tick " << tick << " ("
+              << (sameInput ? "same input, simulation state differs" : "input differs") << ")\n";
+    PrintTick(argv[1], left);
+    PrintTick(argv[2], right);
+    return 1;
+}
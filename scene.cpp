@@ -0,0 +1,76 @@
+#include "scene.h"
+
+SceneStack::SceneStack() {}
+
+SceneStack::~SceneStack() {
+    for (Change& change : pending) {
+        delete change.scene;
+    }
+    while (!scenes.empty()) {
+        PopTop();
+    }
+}
+
+void SceneStack::Push(Scene* scene) {
+    Change change = {CHANGE_PUSH, scene};
+    pending.push_back(change);
+}
+
+void SceneStack::Pop() {
+    Change change = {CHANGE_POP, nullptr};
+    pending.push_back(change);
+}
+
+void SceneStack::Replace(Scene* scene) {
+    Change change = {CHANGE_REPLACE, scene};
+    pending.push_back(change);
+}
+
+void SceneStack::Clear() {
+    Change change = {CHANGE_CLEAR, nullptr};
+    pending.push_back(change);
+}
+
+void SceneStack::PopTop() {
+    Scene* top = scenes.back();
+    scenes.pop_back();
+    top->Exit();
+    delete top;
+}
+
+void SceneStack::ApplyChanges() {
+    // Enter() có thể yêu cầu thay đổi tiếp (scene nạp xong chuyển ngay), xử lý tới khi hết
+    while (!pending.empty()) {
+        Change change = pending.front();
+        pending.erase(pending.begin());
+
+        if (change.kind == CHANGE_POP || change.kind == CHANGE_REPLACE) {
+            if (!scenes.empty()) PopTop();
+        } else if (change.kind == CHANGE_CLEAR) {
+            while (!scenes.empty()) PopTop();
+        }
+        if (change.scene) {
+            scenes.push_back(change.scene);
+            change.scene->Enter();
+        }
+    }
+}
+
+void SceneStack::HandleEvent(const SDL_Event& e) {
+    if (!scenes.empty()) scenes.back()->HandleEvent(e);
+}
+
+void SceneStack::Update(Uint32 dt, const InputFrame& input) {
+    if (!scenes.empty()) scenes.back()->Update(dt, input);
+}
+
+void SceneStack::Render(RenderList& list) const {
+    if (scenes.empty()) return;
+    size_t first = scenes.size() - 1;
+    while (first > 0 && scenes[first]->IsOverlay()) {
+        first--;
+    }
+    for (size_t i = first; i < scenes.size(); ++i) {
+        scenes[i]->Render(list);
+    }
+}
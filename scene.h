@@ -0,0 +1,71 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <SDL.h>
+#include <vector>
+#include "input.h"
+#include "render_list.h"
+
+// Một màn hình của game (menu, màn chơi, tạm dừng...). Enter/Exit nạp và giải phóng
+// tài nguyên của scene; chỉ scene trên cùng của SceneStack nhận sự kiện và được cập nhật.
+class Scene {
+public:
+    virtual ~Scene() {}
+    virtual void Enter() {}
+    virtual void Exit() {}
+    virtual void HandleEvent(const SDL_Event& e) { (void)e; }
+    // dt: thời gian game (ms); input: input đã lấy mẫu (hoặc phát lại) của tick
+    virtual void Update(Uint32 dt, const InputFrame& input) = 0;
+    virtual void Render(RenderList& list) const = 0;
+    // Scene phủ (tạm dừng, game over) để scene bên dưới tiếp tục được vẽ
+    virtual bool IsOverlay() const { return false; }
+    // Scene chạy mô phỏng: input của nó được ghi/phát lại trong replay
+    virtual bool IsGameplay() const { return false; }
+    // Mã băm trạng thái mô phỏng sau tick vừa cập nhật; chỉ scene gameplay có trạng thái cần băm
+    virtual Uint32 HashState() const { return 0; }
+};
+
+// Ngăn xếp scene, sở hữu các scene trong đó. Push/Pop/Replace gọi trong lúc cập nhật
+// chỉ được ghi nhận và áp dụng ở ApplyChanges(), nên scene không tự xóa mình giữa chừng.
+class SceneStack {
+private:
+    enum ChangeKind {
+        CHANGE_PUSH,
+        CHANGE_POP,
+        CHANGE_REPLACE,
+        CHANGE_CLEAR
+    };
+    struct Change {
+        ChangeKind kind;
+        Scene* scene;
+    };
+
+    std::vector<Scene*> scenes;
+    std::vector<Change> pending;
+
+    void PopTop();
+
+public:
+    SceneStack();
+    ~SceneStack();
+    SceneStack(const SceneStack&) = delete;
+    SceneStack& operator=(const SceneStack&) = delete;
+
+    void Push(Scene* scene);
+    void Pop();
+    void Replace(Scene* scene); // Thay scene trên cùng
+    void Clear();               // Gỡ mọi scene, vòng lặp game kết thúc khi stack rỗng
+    void ApplyChanges();
+
+    void HandleEvent(const SDL_Event& e);
+    void Update(Uint32 dt, const InputFrame& input);
+    // Vẽ scene trên cùng cùng các scene bên dưới nó còn nhìn thấy qua lớp phủ
+    void Render(RenderList& list) const;
+
+    bool IsEmpty() const { return scenes.empty(); }
+    bool IsGameplay() const { return !scenes.empty() && scenes.back()->IsGameplay(); }
+    // Gọi sau Update và trước ApplyChanges để băm đúng scene vừa chạy tick
+    Uint32 HashState() const { return scenes.empty() ? 0 : scenes.back()->HashState(); }
+};
+
+#endif
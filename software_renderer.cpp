@@ -0,0 +1,577 @@
+#include "software_renderer.h"
+#include "asset_pack.h"
+#include <SDL_image.h>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SOFTWARE_SSE2 1
+#endif
+
+const Uint32 ALPHA_MASK = 0xFF000000u;
+const Uint32 HASH_SEED = 2166136261u;
+const Uint32 HASH_PRIME = 16777619u;
+
+static inline Uint32 HashMix(Uint32 hash, Uint32 value) {
+    return (hash ^ value) * HASH_PRIME;
+}
+
+static inline Uint32 PackColor(SDL_Color color) {
+    return static_cast<Uint32>(color.r) | (static_cast<Uint32>(color.g) << 8) |
+           (static_cast<Uint32>(color.b) << 16) | (static_cast<Uint32>(color.a) << 24);
+}
+
+static Uint32 HashRectValue(Uint32 hash, const SDL_Rect& rect) {
+    hash = HashMix(hash, static_cast<Uint32>(rect.x));
+    hash = HashMix(hash, static_cast<Uint32>(rect.y));
+    hash = HashMix(hash, static_cast<Uint32>(rect.w));
+    return HashMix(hash, static_cast<Uint32>(rect.h));
+}
+
+// src over dst lên khung hình đục: c = (s*a + d*(255-a)) / 255, làm tròn như nhánh SSE2
+static inline Uint32 BlendOpaque(Uint32 dst, Uint32 src) {
+    Uint32 a = src >> 24;
+    if (a == 255) return src;
+    if (a == 0) return dst;
+    Uint32 inv = 255 - a;
+    Uint32 rb = (src & 0x00FF00FF) * a + (dst & 0x00FF00FF) * inv + 0x00800080;
+    rb = ((rb + ((rb >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+    Uint32 g = ((src >> 8) & 0xFF) * a + ((dst >> 8) & 0xFF) * inv + 0x80;
+    g = ((g + (g >> 8)) >> 8) & 0xFF;
+    return ALPHA_MASK | rb | (g << 8);
+}
+
+// src over dst khi dst có thể trong suốt (dựng lớp tĩnh), chỉ chạy khi đổi màn
+static inline Uint32 BlendCompose(Uint32 dst, Uint32 src) {
+    Uint32 a = src >> 24;
+    if (a == 255) return src;
+    if (a == 0) return dst;
+    Uint32 da = (dst >> 24) * (255 - a) / 255;
+    Uint32 outA = a + da;
+    Uint32 result = outA << 24;
+    for (int shift = 0; shift < 24; shift += 8) {
+        Uint32 s = (src >> shift) & 0xFF;
+        Uint32 d = (dst >> shift) & 0xFF;
+        result |= ((s * a + d * da + outA / 2) / outA) << shift;
+    }
+    return result;
+}
+
+SoftwareRenderer::SoftwareRenderer(int width, int height, TTF_Font* font)
+    : width(width), height(height), frame(static_cast<size_t>(width) * height, ALPHA_MASK), font(font),
+      target(nullptr), targetWidth(width), targetHeight(height), composeAlpha(false), sceneVersion(0),
+      frameCounter(0), fullRedraw(true) {
+    target = frame.data();
+    tileCols = (width + DIRTY_TILE_SIZE - 1) / DIRTY_TILE_SIZE;
+    tileRows = (height + DIRTY_TILE_SIZE - 1) / DIRTY_TILE_SIZE;
+    tileHashes.assign(tileCols * tileRows, 0);
+    previousHashes.assign(tileCols * tileRows, 0);
+    dirtyRects.reserve(tileCols * tileRows);
+    openRects.reserve(tileCols);
+    nextOpenRects.reserve(tileCols);
+    rowBuffer.resize(width);
+    sampleX.resize(width);
+    for (int i = 0; i < SOFTWARE_TEXT_CACHE_SIZE; ++i) {
+        textCache[i].text[0] = '\0';
+        textCache[i].lastUsedFrame = 0;
+        textCache[i].used = false;
+    }
+}
+
+static void UpdateOpaque(SoftwareImage& image) {
+    image.opaque = true;
+    for (Uint32 pixel : image.pixels) {
+        if ((pixel & ALPHA_MASK) != ALPHA_MASK) {
+            image.opaque = false;
+            break;
+        }
+    }
+}
+
+bool SoftwareRenderer::ConvertSurface(SDL_Surface* surface, SoftwareImage& image) {
+    SDL_Surface* converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ABGR8888, 0);
+    if (!converted) {
+        std::cout << "SDL_ConvertSurfaceFormat Error: " << SDL_GetError() << "\n";
+        return false;
+    }
+    image.width = converted->w;
+    image.height = converted->h;
+    image.pixels.resize(static_cast<size_t>(image.width) * image.height);
+    image.flipped.clear();
+    SDL_LockSurface(converted);
+    for (int y = 0; y < image.height; ++y) {
+        std::memcpy(&image.pixels[static_cast<size_t>(y) * image.width],
+                    static_cast<const Uint8*>(converted->pixels) + y * converted->pitch, image.width * 4);
+    }
+    SDL_UnlockSurface(converted);
+    SDL_FreeSurface(converted);
+    UpdateOpaque(image);
+    image.version++;
+    return true;
+}
+
+bool SoftwareRenderer::LoadImage(int sprite) {
+    const char* path = GetSpritePath(sprite);
+    SDL_Surface* surface = IMG_Load(path);
+    if (!surface) {
+        std::cout << "IMG_Load Error: " << IMG_GetError() << " (file: " << path << ")\n";
+        return false;
+    }
+    bool ok = ConvertSurface(surface, images[sprite]);
+    SDL_FreeSurface(surface);
+    return ok;
+}
+
+bool SoftwareRenderer::LoadImages() {
+    // Điểm ảnh trong gói đã ở định dạng RGBA32 (= ABGR8888), chỉ cần giải nén
+    AssetPack pack;
+    pack.Open(ASSET_PACK_PATH);
+    std::vector<Uint8> pixels;
+
+    bool ok = true;
+    for (int i = SPRITE_NONE + 1; i < SPRITE_COUNT; ++i) {
+        const AssetPackEntry* entry = pack.Find(GetSpritePath(i));
+        SoftwareImage& image = images[i];
+        if (entry && entry->format == SDL_PIXELFORMAT_ABGR8888 && pack.ReadPixels(*entry, pixels)) {
+            image.width = entry->width;
+            image.height = entry->height;
+            image.pixels.resize(static_cast<size_t>(image.width) * image.height);
+            std::memcpy(image.pixels.data(), pixels.data(), image.pixels.size() * 4);
+            UpdateOpaque(image);
+            image.version++;
+        } else if (!LoadImage(i)) {
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+void SoftwareRenderer::ReloadImage(int sprite) {
+    if (sprite <= SPRITE_NONE || sprite >= SPRITE_COUNT) return;
+    if (LoadImage(sprite)) std::cout << "Reloaded software image: " << GetSpritePath(sprite) << "\n";
+}
+
+const Uint32* SoftwareRenderer::GetFlippedPixels(SoftwareImage& image) {
+    if (image.flipped.empty()) {
+        image.flipped.resize(image.pixels.size());
+        for (int y = 0; y < image.height; ++y) {
+            const Uint32* in = &image.pixels[static_cast<size_t>(y) * image.width];
+            Uint32* out = &image.flipped[static_cast<size_t>(y) * image.width];
+            std::reverse_copy(in, in + image.width, out);
+        }
+    }
+    return image.flipped.data();
+}
+
+void SoftwareRenderer::SetStaticScene(const StaticScene& scene) {
+    staticScene = scene;
+    RasterizeStaticLayers();
+}
+
+void SoftwareRenderer::RasterizeStaticLayers() {
+    staticLayers.assign(staticScene.layers.size(), SoftwareImage());
+    sceneVersion++;
+    for (size_t i = 0; i < staticScene.layers.size(); ++i) {
+        const StaticLayer& layer = staticScene.layers[i];
+        if (layer.width <= 0 || layer.height <= 0 ||
+            layer.width > SOFTWARE_MAX_LAYER_SIZE || layer.height > SOFTWARE_MAX_LAYER_SIZE) {
+            std::cout << "Static layer " << layer.width << "x" << layer.height << " not cached, drawing directly\n";
+            continue;
+        }
+        SoftwareImage& image = staticLayers[i];
+        image.width = layer.width;
+        image.height = layer.height;
+        image.pixels.assign(static_cast<size_t>(layer.width) * layer.height, 0);
+
+        // Vẽ các lệnh của lớp vào ảnh trong suốt, giống cache render target của renderer GPU
+        target = image.pixels.data();
+        targetWidth = image.width;
+        targetHeight = image.height;
+        composeAlpha = true;
+        SDL_Rect clip = {0, 0, image.width, image.height};
+        for (const RenderItem& item : layer.items) {
+            DrawItem(item, clip);
+        }
+        UpdateOpaque(image);
+    }
+    target = frame.data();
+    targetWidth = width;
+    targetHeight = height;
+    composeAlpha = false;
+    fullRedraw = true;
+}
+
+SoftwareRenderer::CachedText* SoftwareRenderer::FindText(const RenderText& text) {
+    CachedText* oldest = &textCache[0];
+    for (int i = 0; i < SOFTWARE_TEXT_CACHE_SIZE; ++i) {
+        CachedText& entry = textCache[i];
+        if (entry.used && std::strcmp(entry.text, text.text) == 0 && PackColor(entry.color) == PackColor(text.color)) {
+            entry.lastUsedFrame = frameCounter;
+            return &entry;
+        }
+        if (!entry.used || (oldest->used && entry.lastUsedFrame < oldest->lastUsedFrame)) {
+            oldest = &entry;
+        }
+    }
+
+    if (!font) return nullptr;
+    SDL_Surface* surface = TTF_RenderText_Solid(font, text.text, text.color);
+    if (!surface) {
+        std::cerr << "TTF_RenderText_Solid Error: " << TTF_GetError() << "\n";
+        return nullptr;
+    }
+    bool ok = ConvertSurface(surface, oldest->image);
+    SDL_FreeSurface(surface);
+    if (!ok) return nullptr;
+    std::strcpy(oldest->text, text.text);
+    oldest->color = text.color;
+    oldest->lastUsedFrame = frameCounter;
+    oldest->used = true;
+    return oldest;
+}
+
+void SoftwareRenderer::HashRect(const SDL_Rect& rect, Uint32 hash) {
+    int x0 = std::max(rect.x, 0);
+    int y0 = std::max(rect.y, 0);
+    int x1 = std::min(rect.x + rect.w, width);
+    int y1 = std::min(rect.y + rect.h, height);
+    if (x0 >= x1 || y0 >= y1) return;
+    for (int ty = y0 / DIRTY_TILE_SIZE; ty <= (y1 - 1) / DIRTY_TILE_SIZE; ++ty) {
+        Uint32* row = &tileHashes[ty * tileCols];
+        for (int tx = x0 / DIRTY_TILE_SIZE; tx <= (x1 - 1) / DIRTY_TILE_SIZE; ++tx) {
+            row[tx] = HashMix(row[tx], hash);
+        }
+    }
+}
+
+void SoftwareRenderer::HashFrame(const RenderList& list) {
+    // Mã của ô phụ thuộc vào mọi lệnh phủ lên nó theo đúng thứ tự vẽ
+    std::fill(tileHashes.begin(), tileHashes.end(), HashMix(HASH_SEED, PackColor(list.clearColor)));
+    for (const RenderItem& item : list.items) {
+        if (item.kind == RENDER_PARTICLES) {
+            int first = item.src.x;
+            int count = item.src.w;
+            if (first < 0 || count <= 0 || first + count > static_cast<int>(list.particles.size())) continue;
+            for (int i = first; i < first + count; ++i) {
+                const RenderParticle& particle = list.particles[i];
+                float half = particle.size * 0.5f;
+                SDL_Rect rect = {static_cast<int>(particle.x - half), static_cast<int>(particle.y - half),
+                                 static_cast<int>(particle.size + 0.5f), static_cast<int>(particle.size + 0.5f)};
+                HashRect(rect, HashRectValue(HashMix(HASH_SEED, PackColor(particle.color)), rect));
+            }
+            continue;
+        }
+
+        Uint32 hash = HashMix(HASH_SEED, item.kind);
+        hash = HashMix(hash, item.sprite);
+        hash = HashMix(hash, item.flip);
+        hash = HashMix(hash, PackColor(item.color));
+        hash = HashRectValue(hash, item.src);
+        hash = HashRectValue(hash, item.dst);
+        if (item.kind == RENDER_STATIC_LAYER) {
+            hash = HashMix(hash, sceneVersion);
+        } else if (item.kind == RENDER_SPRITE && item.sprite < SPRITE_COUNT) {
+            hash = HashMix(hash, images[item.sprite].version);
+        }
+        HashRect(item.dst, hash);
+    }
+    for (const RenderText& text : list.texts) {
+        CachedText* entry = FindText(text);
+        if (!entry) continue;
+        const SoftwareImage& image = entry->image;
+        SDL_Rect rect = {text.x - image.width / 2, text.y - image.height / 2, image.width, image.height};
+        Uint32 hash = HashMix(HashRectValue(HashMix(HASH_SEED, PackColor(text.color)), rect), image.version);
+        for (const char* c = text.text; *c; ++c) {
+            hash = HashMix(hash, static_cast<Uint8>(*c));
+        }
+        HashRect(rect, hash);
+    }
+}
+
+void SoftwareRenderer::CollectDirtyRects() {
+    dirtyRects.clear();
+    int dirtyTiles = 0;
+    for (size_t i = 0; i < tileHashes.size(); ++i) {
+        if (tileHashes[i] != previousHashes[i]) dirtyTiles++;
+    }
+
+    if (fullRedraw || dirtyTiles * 100 >= static_cast<int>(tileHashes.size()) * FULL_REDRAW_PERCENT) {
+        SDL_Rect all = {0, 0, width, height};
+        dirtyRects.push_back(all);
+    } else if (dirtyTiles > 0) {
+        // Gộp các ô bẩn liền nhau trên một hàng thành một đoạn; đoạn trùng đúng cột với
+        // một vùng của hàng trên thì kéo dài vùng đó xuống thay vì thêm vùng mới
+        openRects.clear();
+        for (int ty = 0; ty < tileRows; ++ty) {
+            nextOpenRects.clear();
+            int y = ty * DIRTY_TILE_SIZE;
+            int rowHeight = std::min(DIRTY_TILE_SIZE, height - y);
+            for (int tx = 0; tx < tileCols;) {
+                int index = ty * tileCols + tx;
+                if (tileHashes[index] == previousHashes[index]) {
+                    ++tx;
+                    continue;
+                }
+                int start = tx;
+                while (tx < tileCols && tileHashes[ty * tileCols + tx] != previousHashes[ty * tileCols + tx]) ++tx;
+                int x = start * DIRTY_TILE_SIZE;
+                int spanWidth = std::min(tx * DIRTY_TILE_SIZE, width) - x;
+
+                int extended = -1;
+                for (int open : openRects) {
+                    SDL_Rect& rect = dirtyRects[open];
+                    if (rect.x == x && rect.w == spanWidth && rect.y + rect.h == y) {
+                        rect.h += rowHeight;
+                        extended = open;
+                        break;
+                    }
+                }
+                if (extended < 0) {
+                    SDL_Rect rect = {x, y, spanWidth, rowHeight};
+                    extended = static_cast<int>(dirtyRects.size());
+                    dirtyRects.push_back(rect);
+                }
+                nextOpenRects.push_back(extended);
+            }
+            openRects.swap(nextOpenRects);
+        }
+    }
+
+    tileHashes.swap(previousHashes);
+    fullRedraw = false;
+}
+
+const std::vector<SDL_Rect>& SoftwareRenderer::Draw(const RenderList& list) {
+    frameCounter++;
+    HashFrame(list);
+    CollectDirtyRects();
+
+    SDL_Color clearColor = list.clearColor;
+    clearColor.a = 255;
+    for (const SDL_Rect& clip : dirtyRects) {
+        FillRect(clip, clearColor, clip);
+        for (const RenderItem& item : list.items) {
+            if (item.kind == RENDER_PARTICLES) {
+                DrawParticles(list, item, clip);
+            } else if (SDL_HasIntersection(&item.dst, &clip)) {
+                DrawItem(item, clip);
+            }
+        }
+        for (const RenderText& text : list.texts) {
+            DrawText(text, clip);
+        }
+    }
+    return dirtyRects;
+}
+
+void SoftwareRenderer::DrawItem(const RenderItem& item, const SDL_Rect& clip) {
+    if (item.kind == RENDER_FILL_RECT) {
+        FillRect(item.dst, item.color, clip);
+    } else if (item.kind == RENDER_STATIC_LAYER) {
+        DrawStaticLayer(item, clip);
+    } else if (item.sprite > SPRITE_NONE && item.sprite < SPRITE_COUNT && images[item.sprite].width > 0) {
+        DrawImage(images[item.sprite], item.src.w > 0 ? &item.src : nullptr, item.dst, item.flip, clip);
+    }
+}
+
+void SoftwareRenderer::DrawStaticLayer(const RenderItem& item, const SDL_Rect& clip) {
+    if (item.sprite >= staticLayers.size()) return;
+    SoftwareImage& image = staticLayers[item.sprite];
+    if (!image.pixels.empty()) {
+        DrawImage(image, &item.src, item.dst, SDL_FLIP_NONE, clip);
+        return;
+    }
+
+    // Không dựng sẵn được: vẽ các lệnh của lớp nằm trong vùng nhìn thấy
+    const StaticLayer& layer = staticScene.layers[item.sprite];
+    for (const RenderItem& layerItem : layer.items) {
+        if (!SDL_HasIntersection(&layerItem.dst, &item.src)) continue;
+        RenderItem shifted = layerItem;
+        shifted.dst.x += item.dst.x - item.src.x;
+        shifted.dst.y += item.dst.y - item.src.y;
+        DrawItem(shifted, clip);
+    }
+}
+
+void SoftwareRenderer::BlendRow(Uint32* dst, const Uint32* src, int count) const {
+    int i = 0;
+    if (composeAlpha) {
+        for (; i < count; ++i) dst[i] = BlendCompose(dst[i], src[i]);
+        return;
+    }
+#ifdef SOFTWARE_SSE2
+    // 4 điểm ảnh mỗi vòng: bỏ qua nhóm trong suốt hoàn toàn, chép thẳng nhóm đục hoàn toàn,
+    // còn lại tính c = (s*a + d*(255-a) + 128) * 257 >> 16 trên các làn 16 bit
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(ALPHA_MASK));
+    const __m128i full = _mm_set1_epi16(255);
+    const __m128i round = _mm_set1_epi16(128);
+    for (; i + 4 <= count; i += 4) {
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i alpha = _mm_and_si128(s, alphaMask);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, zero)) == 0xFFFF) continue;
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, alphaMask)) == 0xFFFF) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), s);
+            continue;
+        }
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+
+        __m128i sLo = _mm_unpacklo_epi8(s, zero);
+        __m128i sHi = _mm_unpackhi_epi8(s, zero);
+        __m128i dLo = _mm_unpacklo_epi8(d, zero);
+        __m128i dHi = _mm_unpackhi_epi8(d, zero);
+        __m128i aLo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(sLo, 0xFF), 0xFF);
+        __m128i aHi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(sHi, 0xFF), 0xFF);
+
+        __m128i lo = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(sLo, aLo),
+                                                 _mm_mullo_epi16(dLo, _mm_sub_epi16(full, aLo))), round);
+        __m128i hi = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(sHi, aHi),
+                                                 _mm_mullo_epi16(dHi, _mm_sub_epi16(full, aHi))), round);
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+        __m128i result = _mm_or_si128(_mm_packus_epi16(lo, hi), alphaMask);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), result);
+    }
+#endif
+    // Phần dư (hoặc toàn bộ khi không có SSE2)
+    for (; i < count; ++i) dst[i] = BlendOpaque(dst[i], src[i]);
+}
+
+void SoftwareRenderer::BlendColorRow(Uint32* dst, Uint32 color, int count) const {
+    Uint32 a = color >> 24;
+    if (a == 0) return;
+    if (a == 255) {
+        std::fill(dst, dst + count, color);
+        return;
+    }
+    int i = 0;
+    if (composeAlpha) {
+        for (; i < count; ++i) dst[i] = BlendCompose(dst[i], color);
+        return;
+    }
+#ifdef SOFTWARE_SSE2
+    // Phần s*a + 128 của màu là hằng số cho cả hàng
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(ALPHA_MASK));
+    __m128i source = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(color)), zero),
+                                                   _mm_set1_epi16(static_cast<short>(a))),
+                                   _mm_set1_epi16(128));
+    __m128i inv = _mm_set1_epi16(static_cast<short>(255 - a));
+    for (; i + 4 <= count; i += 4) {
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        __m128i lo = _mm_add_epi16(source, _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), inv));
+        __m128i hi = _mm_add_epi16(source, _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), inv));
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_or_si128(_mm_packus_epi16(lo, hi), alphaMask));
+    }
+#endif
+    for (; i < count; ++i) dst[i] = BlendOpaque(dst[i], color);
+}
+
+void SoftwareRenderer::FillRect(const SDL_Rect& rect, SDL_Color color, const SDL_Rect& clip) {
+    SDL_Rect bounds = {0, 0, targetWidth, targetHeight};
+    SDL_Rect visible;
+    if (!SDL_IntersectRect(&rect, &clip, &visible) || !SDL_IntersectRect(&visible, &bounds, &visible)) return;
+    Uint32 packed = PackColor(color);
+    for (int y = visible.y; y < visible.y + visible.h; ++y) {
+        BlendColorRow(target + static_cast<size_t>(y) * targetWidth + visible.x, packed, visible.w);
+    }
+}
+
+void SoftwareRenderer::DrawImage(SoftwareImage& image, const SDL_Rect* srcRect, const SDL_Rect& dstRect, int flip,
+                                 const SDL_Rect& clip) {
+    SDL_Rect src = srcRect ? *srcRect : SDL_Rect{0, 0, image.width, image.height};
+    SDL_Rect dst = dstRect;
+    if (src.w <= 0 || src.h <= 0 || dst.w <= 0 || dst.h <= 0) return;
+
+    // Vùng nguồn ra ngoài ảnh: cắt nguồn và co vùng đích theo cùng tỉ lệ như SDL_RenderCopy
+    SDL_Rect imageBounds = {0, 0, image.width, image.height};
+    SDL_Rect inside;
+    if (!SDL_IntersectRect(&src, &imageBounds, &inside)) return;
+    if (inside.x != src.x || inside.y != src.y || inside.w != src.w || inside.h != src.h) {
+        dst.x += (inside.x - src.x) * dst.w / src.w;
+        dst.y += (inside.y - src.y) * dst.h / src.h;
+        dst.w = inside.w * dst.w / src.w;
+        dst.h = inside.h * dst.h / src.h;
+        src = inside;
+        if (dst.w <= 0 || dst.h <= 0) return;
+    }
+
+    SDL_Rect bounds = {0, 0, targetWidth, targetHeight};
+    SDL_Rect visible;
+    if (!SDL_IntersectRect(&dst, &clip, &visible) || !SDL_IntersectRect(&visible, &bounds, &visible)) return;
+
+    // Lật ngang đọc xuôi từ bản lật: cột src.x..src.x+w-1 của ảnh gốc là cột W-src.x-w.. của bản lật
+    const Uint32* pixels = image.pixels.data();
+    int srcX = src.x;
+    if (flip & SDL_FLIP_HORIZONTAL) {
+        pixels = GetFlippedPixels(image);
+        srcX = image.width - src.x - src.w;
+    }
+    bool flipVertical = (flip & SDL_FLIP_VERTICAL) != 0;
+    bool copy = image.opaque && !composeAlpha;
+
+    if (src.w == dst.w && src.h == dst.h) {
+        // Không co giãn: mỗi hàng là một đoạn liền nhau của ảnh nguồn
+        int offsetX = srcX + (visible.x - dst.x);
+        for (int y = visible.y; y < visible.y + visible.h; ++y) {
+            int row = y - dst.y;
+            int srcY = src.y + (flipVertical ? src.h - 1 - row : row);
+            const Uint32* in = pixels + static_cast<size_t>(srcY) * image.width + offsetX;
+            Uint32* out = target + static_cast<size_t>(y) * targetWidth + visible.x;
+            if (copy) {
+                std::memcpy(out, in, visible.w * 4);
+            } else {
+                BlendRow(out, in, visible.w);
+            }
+        }
+        return;
+    }
+
+    // Co giãn theo điểm gần nhất: bảng cột nguồn tính một lần, mỗi hàng lấy mẫu vào rowBuffer
+    if (static_cast<int>(sampleX.size()) < visible.w) {
+        sampleX.resize(visible.w);
+        rowBuffer.resize(visible.w);
+    }
+    for (int i = 0; i < visible.w; ++i) {
+        sampleX[i] = srcX + static_cast<int>(static_cast<long long>(visible.x - dst.x + i) * src.w / dst.w);
+    }
+    for (int y = visible.y; y < visible.y + visible.h; ++y) {
+        int row = static_cast<int>(static_cast<long long>(y - dst.y) * src.h / dst.h);
+        int srcY = src.y + (flipVertical ? src.h - 1 - row : row);
+        const Uint32* in = pixels + static_cast<size_t>(srcY) * image.width;
+        for (int i = 0; i < visible.w; ++i) {
+            rowBuffer[i] = in[sampleX[i]];
+        }
+        Uint32* out = target + static_cast<size_t>(y) * targetWidth + visible.x;
+        if (copy) {
+            std::memcpy(out, rowBuffer.data(), visible.w * 4);
+        } else {
+            BlendRow(out, rowBuffer.data(), visible.w);
+        }
+    }
+}
+
+void SoftwareRenderer::DrawParticles(const RenderList& list, const RenderItem& item, const SDL_Rect& clip) {
+    int first = item.src.x;
+    int count = item.src.w;
+    if (first < 0 || count <= 0 || first + count > static_cast<int>(list.particles.size())) return;
+    for (int i = first; i < first + count; ++i) {
+        const RenderParticle& particle = list.particles[i];
+        float half = particle.size * 0.5f;
+        SDL_Rect rect = {static_cast<int>(particle.x - half), static_cast<int>(particle.y - half),
+                         static_cast<int>(particle.size + 0.5f), static_cast<int>(particle.size + 0.5f)};
+        FillRect(rect, particle.color, clip);
+    }
+}
+
+void SoftwareRenderer::DrawText(const RenderText& text, const SDL_Rect& clip) {
+    CachedText* entry = FindText(text);
+    if (!entry) return;
+    SoftwareImage& image = entry->image;
+    SDL_Rect dst = {text.x - image.width / 2, text.y - image.height / 2, image.width, image.height};
+    DrawImage(image, nullptr, dst, SDL_FLIP_NONE, clip);
+}
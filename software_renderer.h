@@ -0,0 +1,114 @@
+#ifndef SOFTWARE_RENDERER_H
+#define SOFTWARE_RENDERER_H
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <vector>
+#include "render_list.h"
+#include "sprites.h"
+
+// Màn hình được chia thành ô DIRTY_TILE_SIZE x DIRTY_TILE_SIZE; chỉ ô có nội dung đổi mới được vẽ lại
+const int DIRTY_TILE_SIZE = 32;
+// Vùng bẩn vượt quá tỉ lệ này (phần trăm) thì vẽ lại cả khung hình bằng một vùng duy nhất
+const int FULL_REDRAW_PERCENT = 60;
+// Lớp tĩnh lớn hơn kích thước này không được dựng sẵn, các lệnh của lớp được vẽ trực tiếp
+const int SOFTWARE_MAX_LAYER_SIZE = 8192;
+// Số chuỗi chữ giữ sẵn ảnh
+const int SOFTWARE_TEXT_CACHE_SIZE = 32;
+
+// Ảnh trong bộ nhớ, điểm ảnh ABGR8888 (byte R, G, B, A) liền nhau
+struct SoftwareImage {
+    std::vector<Uint32> pixels;
+    std::vector<Uint32> flipped; // Bản lật ngang, dựng lần đầu cần vẽ lật
+    int width;
+    int height;
+    bool opaque;                 // Mọi điểm ảnh có alpha 255: chép thẳng, không hòa trộn
+    Uint32 version;              // Tăng khi ảnh được nạp lại để các ô đang hiển thị ảnh được vẽ lại
+
+    SoftwareImage() : width(0), height(0), opaque(false), version(0) {}
+};
+
+// Bộ vẽ bằng CPU cho máy không có GPU dùng được và cho chế độ chạy không cửa sổ.
+// Vẽ RenderList vào một khung hình ABGR8888 ở độ phân giải logic: mỗi ô màn hình mang
+// một mã băm của các lệnh vẽ phủ lên nó, chỉ ô có mã đổi so với khung trước mới được vẽ lại.
+// Sprite lật ngang đọc từ bản lật dựng sẵn; hòa trộn alpha dùng SSE2 khi có.
+class SoftwareRenderer {
+private:
+    int width;
+    int height;
+    std::vector<Uint32> frame;
+    SoftwareImage images[SPRITE_COUNT];
+    TTF_Font* font;
+
+    // Ảnh đích của các hàm vẽ: khung hình, hoặc ảnh của lớp tĩnh khi đang dựng sẵn.
+    // Khung hình luôn đục; lớp tĩnh có vùng trong suốt nên phải hòa trộn cả kênh alpha
+    Uint32* target;
+    int targetWidth;
+    int targetHeight;
+    bool composeAlpha;
+
+    StaticScene staticScene;
+    std::vector<SoftwareImage> staticLayers; // pixels rỗng: vẽ trực tiếp từng lệnh của lớp
+    Uint32 sceneVersion;
+
+    struct CachedText {
+        char text[sizeof(RenderText::text)];
+        SDL_Color color;
+        SoftwareImage image;
+        Uint32 lastUsedFrame;
+        bool used;
+    };
+    CachedText textCache[SOFTWARE_TEXT_CACHE_SIZE];
+    Uint32 frameCounter;
+
+    // Ô bẩn
+    int tileCols;
+    int tileRows;
+    std::vector<Uint32> tileHashes;
+    std::vector<Uint32> previousHashes;
+    std::vector<SDL_Rect> dirtyRects;
+    std::vector<int> openRects;     // Vùng bẩn chạm hàng ô trước, có thể kéo dài xuống
+    std::vector<int> nextOpenRects;
+    bool fullRedraw;
+    std::vector<Uint32> rowBuffer; // Hàng đã lấy mẫu của sprite co giãn
+    std::vector<int> sampleX;      // Cột nguồn cho từng cột đích
+
+    bool LoadImage(int sprite);
+    bool ConvertSurface(SDL_Surface* surface, SoftwareImage& image);
+    const Uint32* GetFlippedPixels(SoftwareImage& image);
+    CachedText* FindText(const RenderText& text);
+    void RasterizeStaticLayers();
+
+    void HashRect(const SDL_Rect& rect, Uint32 hash);
+    void HashFrame(const RenderList& list);
+    void CollectDirtyRects();
+
+    void DrawItem(const RenderItem& item, const SDL_Rect& clip);
+    void DrawStaticLayer(const RenderItem& item, const SDL_Rect& clip);
+    void DrawImage(SoftwareImage& image, const SDL_Rect* src, const SDL_Rect& dst, int flip, const SDL_Rect& clip);
+    void FillRect(const SDL_Rect& rect, SDL_Color color, const SDL_Rect& clip);
+    void BlendRow(Uint32* dst, const Uint32* src, int count) const;
+    void BlendColorRow(Uint32* dst, Uint32 color, int count) const;
+    void DrawParticles(const RenderList& list, const RenderItem& item, const SDL_Rect& clip);
+    void DrawText(const RenderText& text, const SDL_Rect& clip);
+
+public:
+    SoftwareRenderer(int width, int height, TTF_Font* font);
+
+    // Nạp mọi sprite, ưu tiên gói asset như renderer GPU
+    bool LoadImages();
+    void ReloadImage(int sprite);
+    // Dựng sẵn các lớp tĩnh thành ảnh
+    void SetStaticScene(const StaticScene& scene);
+    // Khung hình kế tiếp vẽ lại toàn bộ
+    void Invalidate() { fullRedraw = true; }
+
+    // Vẽ các vùng thay đổi của list; trả về các vùng đã vẽ lại (rỗng nếu khung hình không đổi)
+    const std::vector<SDL_Rect>& Draw(const RenderList& list);
+
+    const Uint32* GetPixels() const { return frame.data(); }
+    int GetWidth() const { return width; }
+    int GetHeight() const { return height; }
+};
+
+#endif
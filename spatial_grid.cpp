@@ -0,0 +1,75 @@
+#include "spatial_grid.h"
+#include <algorithm>
+
+StaticGrid::StaticGrid() : cellSize(1), originX(0), originY(0), cols(0), rows(0) {}
+
+void StaticGrid::CellRange(const SDL_Rect& rect, int& minX, int& minY, int& maxX, int& maxY) const {
+    minX = std::min(std::max((rect.x - originX) / cellSize, 0), cols - 1);
+    minY = std::min(std::max((rect.y - originY) / cellSize, 0), rows - 1);
+    maxX = std::min(std::max((rect.x + rect.w - 1 - originX) / cellSize, 0), cols - 1);
+    maxY = std::min(std::max((rect.y + rect.h - 1 - originY) / cellSize, 0), rows - 1);
+}
+
+void StaticGrid::Build(const std::vector<SDL_Rect>& rects, const SDL_Rect& area, int size) {
+    cellSize = size > 0 ? size : 1;
+    originX = area.x;
+    originY = area.y;
+    cols = std::max((area.w + cellSize - 1) / cellSize, 1);
+    rows = std::max((area.h + cellSize - 1) / cellSize, 1);
+    bounds = rects;
+
+    // Lượt 1: đếm số phần tử mỗi ô; lượt 2: ghi chỉ số vào đúng đoạn của ô
+    cellStart.assign(cols * rows + 1, 0);
+    for (const SDL_Rect& rect : bounds) {
+        int minX, minY, maxX, maxY;
+        CellRange(rect, minX, minY, maxX, maxY);
+        for (int y = minY; y <= maxY; ++y) {
+            for (int x = minX; x <= maxX; ++x) {
+                cellStart[y * cols + x + 1]++;
+            }
+        }
+    }
+    for (int i = 0; i < cols * rows; ++i) {
+        cellStart[i + 1] += cellStart[i];
+    }
+
+    items.assign(cellStart.back(), 0);
+    std::vector<int> fill(cellStart.begin(), cellStart.end() - 1);
+    for (int i = 0; i < static_cast<int>(bounds.size()); ++i) {
+        int minX, minY, maxX, maxY;
+        CellRange(bounds[i], minX, minY, maxX, maxY);
+        for (int y = minY; y <= maxY; ++y) {
+            for (int x = minX; x <= maxX; ++x) {
+                items[fill[y * cols + x]++] = i;
+            }
+        }
+    }
+}
+
+int StaticGrid::Query(const SDL_Rect& area, int* out, int maxOut) const {
+    if (bounds.empty() || area.w <= 0 || area.h <= 0) return 0;
+
+    int minX, minY, maxX, maxY;
+    CellRange(area, minX, minY, maxX, maxY);
+    int count = 0;
+    for (int y = minY; y <= maxY; ++y) {
+        for (int x = minX; x <= maxX; ++x) {
+            int cell = y * cols + x;
+            for (int i = cellStart[cell]; i < cellStart[cell + 1]; ++i) {
+                int index = items[i];
+                const SDL_Rect& rect = bounds[index];
+                if (!SDL_HasIntersection(&rect, &area)) continue;
+
+                // Hình trải qua nhiều ô chỉ được báo ở ô đầu tiên thuộc cả hình lẫn vùng truy vấn
+                int itemMinX, itemMinY, itemMaxX, itemMaxY;
+                CellRange(rect, itemMinX, itemMinY, itemMaxX, itemMaxY);
+                if (x != std::max(itemMinX, minX) || y != std::max(itemMinY, minY)) continue;
+
+                // Vẫn đếm phần vượt maxOut để người gọi biết kết quả đã bị cắt
+                if (count < maxOut) out[count] = index;
+                count++;
+            }
+        }
+    }
+    return count;
+}
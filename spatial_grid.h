@@ -0,0 +1,33 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include <SDL.h>
+#include <vector>
+
+// Lưới đều cho hình học tĩnh của màn chơi. Mỗi ô lưu chỉ số các hình chữ nhật chạm vào ô đó
+// trong một mảng phẳng (kiểu CSR), nên truy vấn chỉ duyệt các ô quanh vùng cần tìm và
+// chi phí không phụ thuộc kích thước màn. Dữ liệu chỉ đọc sau Build nên truy vấn an toàn đa luồng.
+class StaticGrid {
+private:
+    int cellSize;
+    int originX;
+    int originY;
+    int cols;
+    int rows;
+    std::vector<int> cellStart;   // cellStart[c]..cellStart[c + 1] là đoạn của ô c trong items
+    std::vector<int> items;
+    std::vector<SDL_Rect> bounds; // Bản sao hình chữ nhật để kiểm tra giao chính xác
+
+    void CellRange(const SDL_Rect& rect, int& minX, int& minY, int& maxX, int& maxY) const;
+
+public:
+    StaticGrid();
+    // Xây lưới phủ area; hình nằm ngoài area được gom vào các ô biên
+    void Build(const std::vector<SDL_Rect>& rects, const SDL_Rect& area, int cellSize);
+    // Ghi chỉ số các hình giao với area vào out (mỗi hình một lần, tối đa maxOut), trả về tổng số hình
+    // tìm thấy; kết quả lớn hơn maxOut nghĩa là out đã bị cắt
+    int Query(const SDL_Rect& area, int* out, int maxOut) const;
+    int GetCount() const { return static_cast<int>(bounds.size()); }
+};
+
+#endif
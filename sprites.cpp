@@ -0,0 +1,59 @@
+#include "sprites.h"
+#include <cstring>
+
+// Đường dẫn phải đúng hoa thường như trên đĩa để chạy được trên hệ thống file phân biệt hoa thường
+static const char* const SPRITE_PATHS[SPRITE_COUNT] = {
+    nullptr,
+
+    "assets/map_and_objects/level1_background.png",
+    "assets/map_and_objects/level2_background.png",
+    "assets/map_and_objects/platform.png",
+    "assets/map_and_objects/heart.png",
+    "assets/map_and_objects/game_over.png",
+    "assets/map_and_objects/level_complete.png",
+    "assets/map_and_objects/game_complete.png",
+
+    "assets/player_assets/idle.png",
+    "assets/player_assets/run.png",
+    "assets/player_assets/attack.png",
+    "assets/player_assets/jump.png",
+    "assets/player_assets/damage.png",
+    "assets/player_assets/death.png",
+
+    "assets/boss_assets/boss1/Idle.png",
+    "assets/boss_assets/boss1/Run.png",
+    "assets/boss_assets/boss1/attack.png",
+    "assets/boss_assets/boss1/Jump.png",
+    "assets/boss_assets/boss1/damage.png",
+    "assets/boss_assets/boss1/death.png",
+    "assets/boss_assets/boss1/dive.png",
+
+    "assets/boss_assets/boss2/Idle.png",
+    "assets/boss_assets/boss2/Run.png",
+    "assets/boss_assets/boss2/Attack.png",
+    "assets/boss_assets/boss2/Jump.png",
+    "assets/boss_assets/boss2/damage.png",
+    "assets/boss_assets/boss2/death.png",
+
+    "assets/miniboss/Idle.png",
+    "assets/miniboss/Run.png",
+    "assets/miniboss/attack.png",
+    "assets/miniboss/Jump.png",
+    "assets/miniboss/damage.png",
+    "assets/miniboss/death.png",
+    "assets/miniboss/dive.png",
+    "assets/miniboss/shoot.png",
+    "assets/miniboss/Arrow.png"
+};
+
+const char* GetSpritePath(int sprite) {
+    if (sprite <= SPRITE_NONE || sprite >= SPRITE_COUNT) return nullptr;
+    return SPRITE_PATHS[sprite];
+}
+
+int FindSpriteByPath(const char* path) {
+    for (int i = SPRITE_NONE + 1; i < SPRITE_COUNT; ++i) {
+        if (std::strcmp(SPRITE_PATHS[i], path) == 0) return i;
+    }
+    return SPRITE_NONE;
+}
@@ -0,0 +1,61 @@
+#ifndef SPRITES_H
+#define SPRITES_H
+
+// Định danh cho mọi texture của game; texture thật chỉ tồn tại trên luồng render
+enum SpriteId {
+    SPRITE_NONE = 0,
+
+    // Bản đồ và vật thể
+    SPRITE_LEVEL1_BACKGROUND,
+    SPRITE_LEVEL2_BACKGROUND,
+    SPRITE_PLATFORM,
+    SPRITE_HEART,
+    SPRITE_GAME_OVER,
+    SPRITE_LEVEL_COMPLETE,
+    SPRITE_GAME_COMPLETE,
+
+    // Nhân vật
+    SPRITE_PLAYER_IDLE,
+    SPRITE_PLAYER_RUN,
+    SPRITE_PLAYER_ATTACK,
+    SPRITE_PLAYER_JUMP,
+    SPRITE_PLAYER_DAMAGE,
+    SPRITE_PLAYER_DEATH,
+
+    // Boss màn 1
+    SPRITE_BOSS1_IDLE,
+    SPRITE_BOSS1_RUN,
+    SPRITE_BOSS1_ATTACK,
+    SPRITE_BOSS1_JUMP,
+    SPRITE_BOSS1_DAMAGE,
+    SPRITE_BOSS1_DEATH,
+    SPRITE_BOSS1_DIVE,
+
+    // Boss màn 2
+    SPRITE_BOSS2_IDLE,
+    SPRITE_BOSS2_RUN,
+    SPRITE_BOSS2_ATTACK,
+    SPRITE_BOSS2_JUMP,
+    SPRITE_BOSS2_DAMAGE,
+    SPRITE_BOSS2_DEATH,
+
+    // MiniBoss
+    SPRITE_MINIBOSS_IDLE,
+    SPRITE_MINIBOSS_RUN,
+    SPRITE_MINIBOSS_ATTACK,
+    SPRITE_MINIBOSS_JUMP,
+    SPRITE_MINIBOSS_DAMAGE,
+    SPRITE_MINIBOSS_DEATH,
+    SPRITE_MINIBOSS_DIVE,
+    SPRITE_MINIBOSS_SHOOT,
+    SPRITE_MINIBOSS_ARROW,
+
+    SPRITE_COUNT
+};
+
+// Đường dẫn file ảnh của sprite, nullptr với SPRITE_NONE
+const char* GetSpritePath(int sprite);
+// Tìm sprite theo đường dẫn file, SPRITE_NONE nếu không có
+int FindSpriteByPath(const char* path);
+
+#endif
@@ -0,0 +1,36 @@
+#include "state_hash.h"
+
+// Các hằng số nguyên tố của xxHash32
+const Uint32 PRIME32_2 = 2246822519u;
+const Uint32 PRIME32_3 = 3266489917u;
+const Uint32 PRIME32_4 = 668265263u;
+const Uint32 PRIME32_5 = 374761393u;
+
+static Uint32 RotateLeft(Uint32 value, int bits) {
+    return (value << bits) | (value >> (32 - bits));
+}
+
+StateHash::StateHash(Uint32 seed) : acc(seed + PRIME32_5), length(0) {}
+
+void StateHash::Add(Uint32 value) {
+    acc += value * PRIME32_3;
+    acc = RotateLeft(acc, 17) * PRIME32_4;
+    length += 4;
+}
+
+void StateHash::Add(const SDL_Rect& rect) {
+    Add(rect.x);
+    Add(rect.y);
+    Add(rect.w);
+    Add(rect.h);
+}
+
+Uint32 StateHash::Finish() const {
+    Uint32 hash = acc + length;
+    hash ^= hash >> 15;
+    hash *= PRIME32_2;
+    hash ^= hash >> 13;
+    hash *= PRIME32_3;
+    hash ^= hash >> 16;
+    return hash;
+}
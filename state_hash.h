@@ -0,0 +1,25 @@
+#ifndef STATE_HASH_H
+#define STATE_HASH_H
+
+#include <SDL.h>
+
+// Mã băm tăng dần của trạng thái mô phỏng theo vòng trộn 4 byte của xxHash32.
+// Mỗi đối tượng đưa các trường số nguyên của mình vào qua HashState; thứ tự đưa vào
+// là một phần của mã băm nên mọi lần chạy phải duyệt đối tượng theo cùng một thứ tự.
+// Con trỏ và số thực không được đưa vào: chúng khác nhau giữa các lần chạy và các bản build.
+class StateHash {
+private:
+    Uint32 acc;
+    Uint32 length; // Số byte đã đưa vào
+
+public:
+    explicit StateHash(Uint32 seed = 0);
+    void Add(Uint32 value);
+    void Add(int value) { Add(static_cast<Uint32>(value)); }
+    void Add(bool value) { Add(value ? 1u : 0u); }
+    void Add(const SDL_Rect& rect);
+    // Trộn lần cuối; có thể gọi nhiều lần, không đổi trạng thái
+    Uint32 Finish() const;
+};
+
+#endif
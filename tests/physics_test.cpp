@@ -0,0 +1,90 @@
+// Kiểm tra vật lý: một tick của PhysicsWorld phải rơi đúng như vòng lặp gốc của game
+// (vận tốc += GRAVITY rồi y += vận tốc, một lần mỗi tick).
+// Trả về 0 nếu mọi kiểm tra đạt; in từng kiểm tra sai.
+#include <SDL.h>
+#include <iostream>
+#include <vector>
+#include "level.h"
+#include "physics.h"
+#include "spatial_grid.h"
+
+static int failures = 0;
+
+static void Expect(bool condition, const char* name, int actual, int expected) {
+    if (condition) return;
+    failures++;
+    std::cout << "FAIL " << name << ": got " << actual << ", expected " << expected << "\n";
+}
+
+// Rơi tự do từ đứng yên: sau n tick đã rơi n(n+1)/2 * GRAVITY
+static void TestFreeFall() {
+    PhysicsWorld world;
+    int id = world.CreateBody({100, 100, 120, 120});
+    KinematicBody& body = world.GetBody(id);
+    for (int tick = 1; tick <= 10; ++tick) {
+        world.BeginStep();
+        world.Step();
+        Expect(body.rect.y == 100 + GRAVITY * tick * (tick + 1) / 2, "free fall y", body.rect.y,
+               100 + GRAVITY * tick * (tick + 1) / 2);
+        Expect(body.verticalVelocity == GRAVITY * tick, "free fall velocity", body.verticalVelocity, GRAVITY * tick);
+    }
+}
+
+// Tick đầu của cú nhảy: lên JUMP_STRENGTH + GRAVITY
+static void TestJump() {
+    PhysicsWorld world;
+    int id = world.CreateBody({100, 200, 120, 120});
+    KinematicBody& body = world.GetBody(id);
+    body.verticalVelocity = JUMP_STRENGTH;
+    world.BeginStep();
+    world.Step();
+    Expect(body.rect.y == 200 + JUMP_STRENGTH + GRAVITY, "jump y", body.rect.y, 200 + JUMP_STRENGTH + GRAVITY);
+}
+
+// Rơi nhanh qua mặt nền tảng trong một tick vẫn đứng lại trên nền tảng
+static void TestPlatformLanding() {
+    Level level;
+    level.width = SCREEN_WIDTH;
+    level.groundY = GROUND_Y;
+    SDL_Rect platform = {0, 300, 400, 20};
+    level.solids.push_back(platform);
+    SDL_Rect area = {0, 0, level.width, SCREEN_HEIGHT};
+    level.solidGrid.Build(level.solids, area, LEVEL_CELL_SIZE);
+
+    PhysicsWorld world;
+    world.SetLevel(&level);
+    int id = world.CreateBody({100, 150, 120, 120});
+    KinematicBody& body = world.GetBody(id);
+    body.verticalVelocity = 40;
+    world.BeginStep();
+    world.Step();
+    Expect(body.rect.y == platform.y - body.rect.h, "platform landing y", body.rect.y, platform.y - body.rect.h);
+    Expect(body.contact.onPlatform, "platform landing contact", body.contact.onPlatform, 1);
+}
+
+// Ô đông hơn MAX_QUERY_SOLIDS: Query vẫn trả về tổng số để người gọi phát hiện việc bị cắt
+static void TestQueryOverflow() {
+    std::vector<SDL_Rect> rects;
+    for (int i = 0; i < MAX_QUERY_SOLIDS + 6; ++i) {
+        SDL_Rect rect = {10, 10 + i, 40, 1};
+        rects.push_back(rect);
+    }
+    StaticGrid grid;
+    SDL_Rect area = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+    grid.Build(rects, area, LEVEL_CELL_SIZE);
+    int indices[MAX_QUERY_SOLIDS];
+    SDL_Rect query = {0, 0, 100, 100};
+    int found = grid.Query(query, indices, MAX_QUERY_SOLIDS);
+    Expect(found == MAX_QUERY_SOLIDS + 6, "query overflow count", found, MAX_QUERY_SOLIDS + 6);
+}
+
+int main(int argc, char* argv[]) {
+    (void)argc;
+    (void)argv;
+    TestFreeFall();
+    TestJump();
+    TestPlatformLanding();
+    TestQueryOverflow();
+    std::cout << (failures == 0 ? "physics_test: ok\n" : "physics_test: FAILED\n");
+    return failures == 0 ? 0 : 1;
+}